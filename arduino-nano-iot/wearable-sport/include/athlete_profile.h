@@ -0,0 +1,64 @@
+/**
+ * @file athlete_profile.h
+ * @brief Perfil del atleta (FC máxima, zonas y pesos de TRIMP) leído de la SD
+ * @authors Juan Perez, Ana Gomez
+ * @date 2025
+ *
+ * @details Un mismo firmware sirve a todo el equipo: cada tarjeta lleva un
+ * PROFILE_FILENAME de texto con el perfil de su atleta, que se lee una vez
+ * al arrancar. Sin archivo (o con claves ausentes o inválidas) se usan los
+ * valores por omisión de config.h (FCMAX, Z_EDGES, V_BINS, TRIMP_W).
+ *
+ * Formato: una clave por línea, valores separados por comas; '#' inicia
+ * un comentario.
+ *
+ *   # Perfil de la tarjeta
+ *   nombre=J. Perez
+ *   fcmax=195
+ *   zonas_fc=50,60,70,80,90        # % de fcmax, 5 bordes ascendentes
+ *   zonas_vel=7,15,20              # km/h, 3 bordes ascendentes
+ *   trimp=1,2,3,4,5,6              # peso por zona de FC
+ *
+ * profileApply() convierte los bordes en umbrales enteros de las tablas de
+ * zonas (velZonesConfigure() y hrZonesConfigure()), así que clasificar por
+ * segundo ya no divide entre la FC máxima.
+ */
+
+#ifndef ATHLETE_PROFILE_H
+#define ATHLETE_PROFILE_H
+
+#include <stdint.h>
+
+/**
+ * @struct AthleteProfile
+ * @brief Parámetros por atleta
+ */
+struct AthleteProfile {
+  char name[24];                         ///< Nombre (vacío si el archivo no lo indica)
+  int fcMax;                             ///< Frecuencia cardíaca máxima (bpm)
+  float zEdges[5];                       ///< Bordes de zonas de FC (fracción de fcMax)
+  float vBins[3];                        ///< Bordes de zonas de velocidad (km/h)
+  float trimpW[6];                       ///< Peso de TRIMP por zona de FC
+};
+
+extern AthleteProfile athlete;           ///< Perfil en uso
+
+/**
+ * @brief Lee el perfil de la tarjeta SD (ya inicializada)
+ *
+ * Las claves válidas reemplazan a los valores por omisión; las inválidas se
+ * reportan por Serial y se ignoran.
+ *
+ * @param path Nombre del archivo
+ * @return true Si el archivo existía
+ */
+bool profileLoad(const char *path);
+
+/**
+ * @brief Convierte el perfil a los umbrales enteros de las tablas de zonas
+ *
+ * Se llama al arrancar aunque no haya SD (perfil por omisión).
+ */
+void profileApply();
+
+#endif // ATHLETE_PROFILE_H
@@ -0,0 +1,279 @@
+/**
+ * @file biquad_fixed.h
+ * @brief Motor de filtros biquad en cascada en punto fijo (Q15/Q31)
+ * @authors Juan Perez, Ana Gomez
+ * @date 2025
+ *
+ * @details El Cortex-M0+ del Nano 33 IoT no tiene FPU, por lo que cada
+ * operación float se emula por software. Este motor evalúa la misma cascada
+ * que filterSample() usando solo multiplicaciones enteras, para uno
+ * (BiquadCascade) o varios canales (BiquadBank).
+ *
+ * Estructura: forma directa I con acumulador ancho. La historia de salida
+ * de la etapa i es la historia de entrada de la etapa i+1, así que se
+ * guardan NSTAGES+1 pares de estados por canal en lugar de 4*NSTAGES. El
+ * residuo del redondeo de cada etapa se realimenta a la siguiente muestra
+ * (error feedback), lo que mantiene el ruido de cuantización bajo aun con polos
+ * cercanos al círculo unitario (pasa-altas de 0.5 Hz).
+ *
+ * Restricciones:
+ * - Coeficientes en el rango [-4, 4).
+ * - Q15: la suma de |b0|+|b1|+|b2|+|a1|+|a2| de cada etapa debe ser < 8
+ *   para que el acumulador de 32 bits no desborde (se cumple para etapas
+ *   de segundo orden normalizadas con ganancia <= 1).
+ * - Las salidas de cada etapa se saturan al rango de sample_t.
+ */
+
+#ifndef BIQUAD_FIXED_H
+#define BIQUAD_FIXED_H
+
+#include <stdint.h>
+#include "filter.h"
+
+// ==================== FORMATOS NUMÉRICOS ====================
+
+/**
+ * @struct Q15
+ * @brief Muestras int16, coeficientes Q2.13 y acumulador de 32 bits
+ */
+struct Q15 {
+  typedef int16_t sample_t;              ///< Tipo de muestra y de estado
+  typedef int16_t coef_t;                ///< Tipo de coeficiente
+  typedef int32_t acc_t;                 ///< Tipo del acumulador
+  static const int COEF_FRAC = 13;       ///< Bits fraccionarios de coeficientes
+  static const int32_t SAMPLE_MAX = INT16_MAX;
+  static const int32_t SAMPLE_MIN = INT16_MIN;
+};
+
+/**
+ * @struct Q31
+ * @brief Muestras int32, coeficientes Q2.29 y acumulador de 64 bits
+ */
+struct Q31 {
+  typedef int32_t sample_t;              ///< Tipo de muestra y de estado
+  typedef int32_t coef_t;                ///< Tipo de coeficiente
+  typedef int64_t acc_t;                 ///< Tipo del acumulador
+  static const int COEF_FRAC = 29;       ///< Bits fraccionarios de coeficientes
+  static const int32_t SAMPLE_MAX = INT32_MAX;
+  static const int32_t SAMPLE_MIN = INT32_MIN;
+};
+
+// ==================== ETAPA DE PUNTO FIJO ====================
+
+/**
+ * @struct BiquadStageQ
+ * @brief Coeficientes de una etapa en el formato Q y su conversión desde float
+ */
+template <class Q>
+struct BiquadStageQ {
+  typedef typename Q::coef_t coef_t;
+  typedef typename Q::acc_t acc_t;
+
+  coef_t b0, b1, b2;                     ///< Coeficientes del numerador
+  coef_t a1, a2;                         ///< Coeficientes del denominador
+
+  /**
+   * @brief Convierte un coeficiente real al formato Q con redondeo y saturación
+   *
+   * Es constexpr para poder convertir cascadas diseñadas en compilación.
+   *
+   * @param c Coeficiente real
+   * @return coef_t Coeficiente en punto fijo
+   */
+  static constexpr coef_t toCoef(double c) {
+    return roundCoef(c * (double)((acc_t)1 << Q::COEF_FRAC) + (c >= 0 ? 0.5 : -0.5));
+  }
+
+  /**
+   * @brief Convierte una etapa float a coeficientes en punto fijo
+   *
+   * @param b Etapa de referencia
+   * @return BiquadStageQ Etapa en formato Q
+   */
+  static constexpr BiquadStageQ from(const Biquad &b) {
+    return BiquadStageQ{toCoef(b.b0), toCoef(b.b1), toCoef(b.b2), toCoef(b.a1), toCoef(b.a2)};
+  }
+
+  /** @brief Saturación al rango de coef_t de un valor ya escalado y redondeado */
+  static constexpr coef_t roundCoef(double v) {
+    return v >= (double)COEF_MAX ? (coef_t)COEF_MAX
+         : (v <= (double)(-COEF_MAX - 1) ? (coef_t)(-COEF_MAX - 1) : (coef_t)v);
+  }
+
+  static constexpr acc_t COEF_MAX = ((acc_t)1 << (8 * sizeof(coef_t) - 1)) - 1;
+};
+
+// ==================== BANCO MULTICANAL ====================
+
+/** @brief Etiqueta para desenrollar en compilación el lazo de canales */
+template <int N>
+struct ChannelTag {};
+
+/**
+ * @class BiquadBank
+ * @brief NCH canales filtrados por la misma cascada de NSTAGES biquads
+ *
+ * Disposición de estructura de arreglos (SoA): los coeficientes de una
+ * etapa se copian a locales una sola vez y se aplican a todos los canales,
+ * cuyos estados están contiguos por etapa (h_[etapa][retardo][canal]). El
+ * lazo de canales se desenrolla con plantillas y always_inline: con -Os (el
+ * firmware) GCC no integraba step() y cada canal volvía a cargar los
+ * coeficientes.
+ *
+ * @tparam Q Formato numérico (Q15 o Q31)
+ * @tparam NSTAGES Número de etapas, fijo en compilación
+ * @tparam NCH Número de canales, fijo en compilación
+ */
+template <class Q, int NSTAGES, int NCH>
+class BiquadBank {
+public:
+  typedef typename Q::sample_t sample_t;
+  typedef typename Q::coef_t coef_t;
+  typedef typename Q::acc_t acc_t;
+  typedef BiquadStageQ<Q> Stage;
+
+  BiquadBank() : st_(own_) { reset(); }
+
+  /**
+   * @brief Construye el banco sobre coeficientes ya convertidos
+   *
+   * Los coeficientes no se copian: pueden ser un arreglo constexpr en flash
+   * generado con Stage::from().
+   *
+   * @param coeffs Arreglo de NSTAGES etapas en formato Q
+   */
+  explicit BiquadBank(const Stage *coeffs) : st_(coeffs) { reset(); }
+
+  /**
+   * @brief Construye el banco a partir de una cascada float de referencia
+   *
+   * @param ref Arreglo de NSTAGES etapas Biquad
+   */
+  explicit BiquadBank(const Biquad *ref) : st_(own_) {
+    setCoeffs(ref);
+    reset();
+  }
+
+  /**
+   * @brief Carga los coeficientes a partir de una cascada float de referencia
+   *
+   * @param ref Arreglo de NSTAGES etapas Biquad (se ignoran sus estados)
+   */
+  void setCoeffs(const Biquad *ref) {
+    for (int i = 0; i < NSTAGES; ++i) {
+      own_[i] = Stage::from(ref[i]);
+    }
+    st_ = own_;
+  }
+
+  /** @brief Pone en cero los estados y residuos de redondeo */
+  void reset() {
+    for (int i = 0; i <= NSTAGES; ++i) {
+      for (int c = 0; c < NCH; ++c) {
+        h_[i][0][c] = 0;
+        h_[i][1][c] = 0;
+      }
+    }
+    for (int i = 0; i < NSTAGES; ++i) {
+      for (int c = 0; c < NCH; ++c) {
+        err_[i][c] = 0;
+      }
+    }
+  }
+
+  /**
+   * @brief Filtra una muestra de cada canal en una sola pasada
+   *
+   * @param x Muestras de entrada en formato Q; se reemplazan por las filtradas
+   */
+  void process(sample_t x[NCH]) {
+    for (int i = 0; i < NSTAGES; ++i) {
+      // Copia local: las escrituras de estado por sample_t& podrían apuntar a
+      // st_[i], y el compilador recargaría los coeficientes en cada canal
+      const Coefs k = { st_[i].b0, st_[i].b1, st_[i].b2, st_[i].a1, st_[i].a2 };
+      channels(k, x, h_[i], h_[i + 1], err_[i], ChannelTag<NCH>());
+    }
+    for (int c = 0; c < NCH; ++c) {
+      h_[NSTAGES][1][c] = h_[NSTAGES][0][c];
+      h_[NSTAGES][0][c] = x[c];
+    }
+  }
+
+protected:
+  /** @brief Coeficientes de una etapa cargados una vez para todos los canales */
+  struct Coefs {
+    coef_t b0, b1, b2, a1, a2;
+  };
+
+  /**
+   * @brief Una etapa sobre un canal (forma directa I con error feedback)
+   */
+  static inline __attribute__((always_inline)) sample_t step(const Coefs s, sample_t x, sample_t &x1, sample_t &x2,
+                              sample_t y1, sample_t y2, acc_t &err) {
+    const acc_t mask = ((acc_t)1 << Q::COEF_FRAC) - 1;
+    acc_t acc = err;
+    acc += (acc_t)s.b0 * x + (acc_t)s.b1 * x1 + (acc_t)s.b2 * x2;
+    acc -= (acc_t)s.a1 * y1 + (acc_t)s.a2 * y2;
+    err = acc & mask;
+    acc_t y = acc >> Q::COEF_FRAC;
+    if (y > Q::SAMPLE_MAX) y = Q::SAMPLE_MAX;
+    if (y < Q::SAMPLE_MIN) y = Q::SAMPLE_MIN;
+    x2 = x1;
+    x1 = x;
+    return (sample_t)y;
+  }
+
+  /** @brief Aplica una etapa a los canales 0..C-1 (desenrollado) */
+  template <int C>
+  static inline __attribute__((always_inline)) void channels(const Coefs s, sample_t *x, sample_t (*hin)[NCH],
+                              sample_t (*hout)[NCH], acc_t *err, ChannelTag<C>) {
+    channels(s, x, hin, hout, err, ChannelTag<C - 1>());
+    x[C - 1] = step(s, x[C - 1], hin[0][C - 1], hin[1][C - 1],
+                    hout[0][C - 1], hout[1][C - 1], err[C - 1]);
+  }
+
+  static inline __attribute__((always_inline)) void channels(const Coefs, sample_t *, sample_t (*)[NCH],
+                              sample_t (*)[NCH], acc_t *, ChannelTag<0>) {}
+
+  Stage own_[NSTAGES];                   ///< Coeficientes convertidos en tiempo de ejecución
+  const Stage *st_;                      ///< Coeficientes en uso (own_ o arreglo externo)
+  sample_t h_[NSTAGES + 1][2][NCH];      ///< Historias por etapa, retardo y canal
+  acc_t err_[NSTAGES][NCH];              ///< Residuo de redondeo por etapa y canal
+};
+
+// ==================== CASCADA DE UN CANAL ====================
+
+/**
+ * @class BiquadCascade
+ * @brief Cascada de NSTAGES biquads para un solo canal
+ *
+ * Caso particular de BiquadBank con interfaz escalar.
+ *
+ * @tparam Q Formato numérico (Q15 o Q31)
+ * @tparam NSTAGES Número de etapas, fijo en compilación
+ */
+template <class Q, int NSTAGES>
+class BiquadCascade : public BiquadBank<Q, NSTAGES, 1> {
+  typedef BiquadBank<Q, NSTAGES, 1> Base;
+
+public:
+  typedef typename Base::sample_t sample_t;
+  typedef typename Base::Stage Stage;
+
+  BiquadCascade() : Base() {}
+  explicit BiquadCascade(const Stage *coeffs) : Base(coeffs) {}
+  explicit BiquadCascade(const Biquad *ref) : Base(ref) {}
+
+  /**
+   * @brief Filtra una muestra a través de todas las etapas
+   *
+   * @param x Muestra de entrada en formato Q
+   * @return sample_t Muestra filtrada (saturada)
+   */
+  sample_t process(sample_t x) {
+    Base::process(&x);
+    return x;
+  }
+};
+
+#endif // BIQUAD_FIXED_H
@@ -8,32 +8,217 @@
 #ifndef CONFIG_H
 #define CONFIG_H
 
+#include <stdint.h>
+
 // ==================== CONFIGURACIONES DE HARDWARE ====================
 
 /** @brief Velocidad de comunicación serial con PC */
 #define BAUD_PC           115200
 
+/** @brief Espera máxima por el monitor serie al arrancar (ms; 0 = arranca sin esperar al USB) */
+#define SERIAL_WAIT_MS    0
+
 /** @brief Pin CS (Chip Select) de la tarjeta SD */
 #define SD_CS_PIN         10
 
 /** @brief Pin analógico para lectura de señal EMG/ECG */
 #define EMG_INPUT_PIN     PIN_A0
 
+/** @brief Resolución del ADC en bits (la define también el core SAMD) */
+#ifndef ADC_RESOLUTION
+#define ADC_RESOLUTION    12
+#endif
+
 /** @brief Frecuencia de muestreo para señal ECG (Hz) */
-#define SAMPLE_RATE       30
+#define SAMPLE_RATE       250
+
+/** @brief Corte inferior del filtro ECG (Hz): elimina la deriva de línea base */
+#define ECG_HP_HZ         0.5
+
+/** @brief Corte superior del filtro ECG (Hz): ancho de banda de monitoreo */
+#define ECG_LP_HZ         40.0
+
+/** @brief Frecuencia de la red eléctrica a rechazar (Hz, 0 = sin notch) */
+#define ECG_NOTCH_HZ      60
+
+/** @brief Factor de calidad del notch (ancho de banda = ECG_NOTCH_HZ / Q) */
+#define ECG_NOTCH_Q       10.0
+
+/** @brief Modos de adquisición de la señal ECG */
+#define ECG_ACQ_POLL      0   ///< analogRead() desde la tarea ECG, una muestra por periodo
+#define ECG_ACQ_DMA       1   ///< TC3 dispara el ADC y el DMA llena bloques ping-pong
+
+/** @brief Modo de adquisición de la señal ECG */
+#define ECG_ACQ_MODE      ECG_ACQ_DMA
+
+/** @brief Muestras por bloque DMA (~100 ms de señal por bloque) */
+#define ECG_BLOCK_LEN     (SAMPLE_RATE >= 10 ? SAMPLE_RATE / 10 : 1)
+
+/** @brief Sobremuestreo y diezmado en la adquisición por DMA (1 = activo, ver ecg_decim.h) */
+#define ECG_OVERSAMPLE    1
+
+/** @brief Conversiones que el ADC acumula por disparo (AVGCTRL; potencia de 2, máximo 16) */
+#define ECG_ADC_AVG       4
+
+/** @brief Disparos del ADC por muestra entregada (TC3 a SAMPLE_RATE * ECG_DECIM) */
+#define ECG_DECIM         12
+
+/** @brief Ventana del diezmado de un ciclo de red: anula ECG_NOTCH_HZ y armónicos y reemplaza al notch */
+#define ECG_DECIM_MAINS   1
+
+/** @brief Sobremuestreo activo: solo con ECG_ACQ_DMA */
+#define ECG_OVS_ON        (ECG_OVERSAMPLE && ECG_ACQ_MODE == ECG_ACQ_DMA)
+
+/** @brief Bits de las muestras que llegan al filtro (16 con sobremuestreo) */
+#define ECG_SAMPLE_BITS   (ECG_OVS_ON ? 16 : ADC_RESOLUTION)
+
+/** @brief Periodo del tick del planificador de tareas (us) */
+#define SCHED_TICK_US     1000
+
+/** @brief Máximo de tareas registradas en el planificador */
+#define SCHED_MAX_TASKS   10
+
+/** @brief Motores disponibles para el filtro ECG */
+#define FILTER_FLOAT      0
+#define FILTER_Q15        1
+#define FILTER_Q31        2
+
+/** @brief Motor del filtro ECG (el M0+ no tiene FPU: usar punto fijo; Q15 exige ECG_HP_HZ / SAMPLE_RATE >= 0.008) */
+#define FILTER_ENGINE     FILTER_Q31
 
 /** @brief Velocidad de comunicación serial con módulo GPS */
 #define BAUD_GPS          9600
 
+/** @brief Protocolos del receptor GPS */
+#define GPS_NMEA          0               ///< Texto NMEA a BAUD_GPS (cualquier receptor, 1 Hz)
+#define GPS_UBX           1               ///< UBX NAV-PVT a GPS_UBX_BAUD (u-blox 7 o posterior)
+
+/** @brief Protocolo del receptor GPS */
+#define GPS_PROTOCOL      GPS_NMEA
+
+/** @brief Velocidad del puerto en modo UBX (el buffer RX de 64 B dura ~17 ms) */
+#define GPS_UBX_BAUD      38400
+
+/** @brief Soluciones por segundo en modo UBX */
+#define GPS_RATE_HZ       10
+
+/** @brief Recepción del puerto del GPS */
+#define GPS_RX_CORE       0               ///< Buffer RX del core (64 B), vaciado byte a byte en tareaGps
+#define GPS_RX_DMA        1               ///< DMA desde el SERCOM a un anillo de GPS_RX_RING B (ver gps_uart.h)
+
+/** @brief Modo de recepción del GPS */
+#define GPS_RX_MODE       GPS_RX_DMA
+
+/** @brief Anillo de recepción del GPS (potencia de 2; 2048 B = 530 ms a 38400 baud) */
+#define GPS_RX_RING       2048
+
+/** @brief Intervalo máximo entre soluciones que se integra (ms); uno mayor es un hueco */
+#define GPS_MAX_GAP_MS    2000
+
+/** @brief Arranque en caliente del GPS con la última posición y la base de navegación (ver gps_aid.h; u-blox M8 o posterior) */
+#define GPS_AID           1
+#define GPS_AID_FILENAME  "gpsaid.bin"
+#define GPS_AID_POS_ACC_M 5000            ///< Incertidumbre mínima declarada de la última posición (m)
+#define GPS_AID_SAVE_MIN  5               ///< Minutos entre guardados
+#define GPS_AID_DBD_BYTES 2048            ///< RAM para la base de navegación (MGA-DBD; solo en modo UBX)
+
+/** @brief Fusión de distancia por posición (ver gps_distance.h) */
+#define GPS_HDOP_MAX        500           ///< HDOP máximo para usar una posición (0.01; 5.0)
+#define GPS_UERE_M          2.5f          ///< σ de la posición por unidad de HDOP (m)
+#define GPS_SPEED_SIGMA_KMH 1.0f          ///< σ de la velocidad filtrada, incluido el retardo del promedio (km/h)
+#define GPS_MAX_KMH         45            ///< Velocidad implícita entre posiciones que delata un salto (km/h)
+#define GPS_SEG_MIN_M       10            ///< Longitud mínima de un tramo de corrección (m)
+#define GPS_SEG_MAX_MS      30000         ///< Duración máxima de un tramo (ms)
+
+/** @brief Fuentes de la velocidad que consumen zonas, sprints y velocidad pico */
+#define SPEED_GPS         0               ///< Velocidad del GPS con promedio móvil, por época
+#define SPEED_KALMAN      1               ///< Kalman acelerómetro + GPS a IMU_RATE_HZ (ver speed_kalman.h)
+
+/** @brief Fuente de la velocidad (sin IMU detectada se usa SPEED_GPS) */
+#define SPEED_SOURCE      SPEED_KALMAN
+
+/** @brief Frecuencia de salida del acelerómetro LSM6DS3 (Hz: 52, 104 o 208) */
+#define IMU_RATE_HZ       104
+
+/** @brief Corte del pasa-bajas de los 3 ejes del acelerómetro (Hz, -6 dB por etapa; vibración y ruido del sensor) */
+#define IMU_LP_HZ         30
+
+/** @brief Eje del acelerómetro alineado con la dirección de avance (0 = X, 1 = Y, 2 = Z) */
+#define IMU_FWD_AXIS      0
+
+/** @brief Signo del eje de avance según el montaje (1 o -1) */
+#define IMU_FWD_SIGN      1
+
+/** @brief Aceleración total que cuenta como impacto (g; placajes, caídas, saltos) */
+#define IMU_IMPACT_G      5.0f
+
+/** @brief Ruido del filtro de velocidad */
+#define KF_ACC_SIGMA      2.0f            ///< Aceleración de avance no modelada: zancada, vibración (m/s²)
+#define KF_BIAS_SIGMA     0.05f           ///< Deriva del sesgo (gravedad por inclinación) (m/s² por √s)
+#define KF_GPS_SIGMA_KMH  0.7f            ///< Ruido de la velocidad Doppler del GPS (km/h)
+
+/** @brief Segundos del buffer de ventanas deslizantes (la mayor ventana: 10 min, ver rolling.h) */
+#define ROLL_SECONDS      600
+
+/** @brief Zona de velocidad desde la que la distancia cuenta como alta velocidad (2 = correr) */
+#define ROLL_HS_ZONE      2
+
 /** @brief Offset de zona horaria en horas (México: -6) */
 #define UTC_OFFSET_H      -6
 
+/** @brief Perfil del atleta en la SD: FC máxima, zonas y pesos de TRIMP (ver athlete_profile.h) */
+#define PROFILE_FILENAME  "atleta.cfg"
+
 /** @brief Nombre del archivo CSV para guardar datos */
 #define CSV_FILENAME      "datos.csv"
 
+/** @brief Formatos del registro de sesión en SD */
+#define LOG_CSV           0   ///< Texto, una fila por minuto (CSV_FILENAME)
+#define LOG_BIN           1   ///< Registros binarios con CRC (LOG_BIN_FILENAME, ver session_log.h)
+
+/** @brief Formato del registro de sesión */
+#define LOG_FORMAT        LOG_BIN
+
+/** @brief Nombre del archivo del registro binario */
+#define LOG_BIN_FILENAME  "sesion.bin"
+
+/** @brief Formatos de la salida por Serial (USB) */
+#define TELEM_TEXT        0   ///< Resúmenes en texto legible
+#define TELEM_BIN         1   ///< Paquetes binarios COBS con CRC (ver telemetry.h y tools/telem2txt.cpp)
+
+/** @brief Formato de la salida por Serial */
+#define TELEMETRY         TELEM_BIN
+
+/** @brief Detalle de la telemetría binaria: 0 = minuto y sprints, 1 = + estado y ventanas, 2 = + diagnóstico */
+#define TELEM_LEVEL       1
+
+/** @brief Paquetes de estado (posición, velocidad, BPM) por segundo con TELEM_LEVEL >= 1 */
+#define TELEM_STATE_HZ    1
+
+/** @brief Captura de la forma de onda ECG cruda y filtrada en SD (1 = activa) */
+#define ECG_CAPTURE       0
+
+/** @brief Duración máxima de la captura (min): define el tamaño preasignado del archivo */
+#define CAPTURE_MINUTES   90
+
+/** @brief Sectores de 512 B en RAM para la captura (mínimo 2: doble buffer) */
+#define CAPTURE_SECTORS   4
+
+/** @brief Buffer circular del registro en SD (múltiplo de 512: sectores completos) */
+#define SD_LOG_RING       2048
+
+/** @brief Archivo de sprints: un registro por sprint (ver sprint.h y session_log.h) */
+#define SPRINT_LOG_FILENAME "sprints.bin"
+
+/** @brief Buffer circular del archivo de sprints (múltiplo de 512) */
+#define SPRINT_LOG_RING   512
+
+/** @brief Intervalo de sincronización del archivo de registro (ms) */
+#define SD_LOG_FLUSH_MS   10000
+
 // ==================== CONSTANTES DE DETECCIÓN CARDÍACA ====================
 
-/** @brief Período refractario en ms (~200 bpm máximo) */
+/** @brief Período refractario del detector QRS en ms (~200 bpm máximo) */
 extern const int REFRACT_MS;
 
 /** @brief Rango válido de intervalos RR en ms (30-200 bpm) */
@@ -43,6 +228,12 @@ extern const int MAX_RR;
 /** @brief Tamaño del buffer para promedio de intervalos RR */
 #define RR_BUF 4
 
+/** @brief Intervalos RR en la ventana deslizante de HRV (RMSSD/SDNN/pNN50) */
+#define HRV_WIN 64
+
+/** @brief Desviación máxima (%) de un RR respecto al anterior antes de descartarlo en HRV */
+#define HRV_ARTIFACT_PCT 20
+
 // ==================== CONSTANTES GPS ====================
 
 /** @brief Tamaño de ventana para promedio móvil de velocidad */
@@ -53,19 +244,25 @@ extern const float V_THRESH_KMH;
 
 // ==================== CONSTANTES DE ZONAS ====================
 
-/** @brief Umbrales de velocidad para zonas (km/h): caminar/trotar/correr/sprint */
+/** @brief Umbrales de velocidad para zonas (km/h): caminar/trotar/correr/sprint (por omisión, ver PROFILE_FILENAME) */
 extern const float V_BINS[3];
 
-/** @brief Frecuencia cardíaca máxima de referencia (bpm) */
+/** @brief Frecuencia cardíaca máxima de referencia (bpm, por omisión) */
 extern const int FCMAX;
 
-/** @brief Bordes de zonas de FC como porcentaje de FC máxima */
+/** @brief Bordes de zonas de FC como fracción de FC máxima (por omisión) */
 extern const float Z_EDGES[5];
 
-/** @brief Pesos para cálculo de TRIMP por zona de FC */
+/** @brief Pesos para cálculo de TRIMP por zona de FC (por omisión) */
 extern const float TRIMP_W[6];
 
-/** @brief Umbral de velocidad para considerar sprint (km/h) */
+/** @brief Velocidad que inicia un sprint (km/h) */
 extern const float SPRINT_KMH;
 
+/** @brief Velocidad bajo la cual termina el sprint (km/h, histéresis respecto a SPRINT_KMH) */
+extern const float SPRINT_EXIT_KMH;
+
+/** @brief Duración mínima de un sprint, del cruce de SPRINT_KMH al de SPRINT_EXIT_KMH (ms) */
+extern const uint32_t SPRINT_HOLD_MS;
+
 #endif // CONFIG_H
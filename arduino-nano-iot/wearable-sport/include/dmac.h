@@ -0,0 +1,81 @@
+/**
+ * @file dmac.h
+ * @brief Controlador DMA (DMAC) del SAMD21 compartido entre módulos
+ * @authors Juan Perez, Ana Gomez
+ * @date 2025
+ *
+ * @details El DMAC usa una sola tabla de descriptores base y una sola de
+ * write-back para todos los canales. Este módulo es dueño de ambas tablas
+ * y del vector DMAC_Handler; cada módulo usa un canal fijo y registra un
+ * callback que se ejecuta en contexto de interrupción.
+ */
+
+#ifndef DMAC_H
+#define DMAC_H
+
+#include <stdint.h>
+
+#if defined(ARDUINO_ARCH_SAMD)
+#include <Arduino.h>
+
+// ==================== ASIGNACIÓN DE CANALES ====================
+
+/** @brief Canales DMA usados por el firmware */
+enum DmacChannel {
+  DMAC_CH_ECG_ADC = 0,  ///< Resultados del ADC de ECG a buffers ping-pong
+  DMAC_CH_GPS_RX  = 1,  ///< Bytes del GPS (Serial1) a un anillo circular
+  DMAC_CH_COUNT   = 2   ///< Número de canales en uso
+};
+
+/**
+ * @brief Callback de canal (contexto de interrupción)
+ *
+ * @param flags Banderas CHINTFLAG del canal (TCMPL, TERR, SUSP)
+ */
+typedef void (*DmacCallback)(uint8_t flags);
+
+/**
+ * @brief Habilita el reloj del DMAC e instala las tablas de descriptores
+ *
+ * Puede llamarse varias veces; solo la primera configura el periférico.
+ */
+void dmacBegin();
+
+/**
+ * @brief Devuelve el descriptor base de un canal
+ *
+ * @param ch Canal DMA
+ * @return DmacDescriptor* Descriptor en la tabla base
+ */
+DmacDescriptor *dmacDescriptor(uint8_t ch);
+
+/**
+ * @brief Devuelve el estado de un canal (área de write-back)
+ *
+ * BTCNT indica los beats que faltan del bloque en curso; el DMAC lo
+ * actualiza cada vez que el canal queda esperando su disparo.
+ *
+ * @param ch Canal DMA
+ * @return volatile DmacDescriptor* Descriptor en la tabla de write-back
+ */
+volatile DmacDescriptor *dmacStatus(uint8_t ch);
+
+/**
+ * @brief Configura un canal: disparo, prioridad y callback de fin de bloque
+ *
+ * @param ch Canal DMA
+ * @param trigSrc Fuente de disparo (p. ej. ADC_DMAC_ID_RESRDY)
+ * @param cb Callback a ejecutar con cada interrupción del canal
+ */
+void dmacConfigChannel(uint8_t ch, uint8_t trigSrc, DmacCallback cb);
+
+/**
+ * @brief Habilita el canal; el descriptor base debe estar listo
+ *
+ * @param ch Canal DMA
+ */
+void dmacEnableChannel(uint8_t ch);
+
+#endif // ARDUINO_ARCH_SAMD
+
+#endif // DMAC_H
@@ -0,0 +1,65 @@
+/**
+ * @file ecg_adc.h
+ * @brief Adquisición de ECG por ADC disparado por temporizador y DMA
+ * @authors Juan Perez, Ana Gomez
+ * @date 2025
+ *
+ * @details TC3 desborda a SAMPLE_RATE y, a través del sistema de eventos,
+ * inicia cada conversión del ADC sin intervención de la CPU. El DMA copia
+ * cada resultado a dos buffers de ECG_BLOCK_LEN muestras que se alternan
+ * (ping-pong). El intervalo de muestreo queda fijado por hardware y no lo
+ * afectan las escrituras a SD ni las ráfagas del GPS; loop() solo procesa
+ * bloques completos.
+ *
+ * Con ECG_OVS_ON, TC3 dispara ECG_DECIM veces más rápido, el ADC acumula
+ * ECG_ADC_AVG conversiones por disparo y cada bloque DMA tiene
+ * ECG_BLOCK_LEN * ECG_DECIM lecturas; ecgAdcNextBlock() las diezma
+ * (ecg_decim.h) y entrega ECG_BLOCK_LEN muestras de ECG_SAMPLE_BITS bits.
+ */
+
+#ifndef ECG_ADC_H
+#define ECG_ADC_H
+
+#include <stdint.h>
+#include "config.h"
+
+// ==================== ESTADÍSTICAS DE ADQUISICIÓN ====================
+
+/**
+ * @struct EcgAdcStats
+ * @brief Contadores de bloques del procesamiento de ECG
+ */
+struct EcgAdcStats {
+  uint32_t blocks;                       ///< Bloques procesados
+  uint32_t overruns;                     ///< Bloques perdidos por no procesarse a tiempo
+};
+
+extern EcgAdcStats ecgAdcStats;          ///< Estadísticas de adquisición
+
+/** @brief Tiempo disponible para procesar un bloque (us) */
+#define ECG_BLOCK_BUDGET_US ((uint32_t)ECG_BLOCK_LEN * (1000000UL / SAMPLE_RATE))
+
+/** @brief Aviso de bloque completo (se llama en contexto de interrupción) */
+typedef void (*EcgBlockCallback)();
+
+/**
+ * @brief Configura TC3, el sistema de eventos, el ADC y el DMA e inicia el muestreo
+ *
+ * @param onBlock Función llamada al completarse cada bloque (opcional)
+ */
+void ecgAdcBegin(EcgBlockCallback onBlock = nullptr);
+
+/**
+ * @brief Devuelve el siguiente bloque completo, si existe
+ * 
+ * El bloque es válido hasta que el DMA termine de llenar el siguiente
+ * (ECG_BLOCK_LEN / SAMPLE_RATE segundos) o, con sobremuestreo, hasta la
+ * siguiente llamada. Si el consumidor se atrasó más de un bloque, se
+ * descartan los bloques sobrescritos y se cuentan como overruns.
+ * 
+ * @param firstSample Índice absoluto de la primera muestra del bloque
+ * @return const uint16_t* Bloque de ECG_BLOCK_LEN muestras de ECG_SAMPLE_BITS bits, o nullptr
+ */
+const uint16_t *ecgAdcNextBlock(uint32_t *firstSample);
+
+#endif // ECG_ADC_H
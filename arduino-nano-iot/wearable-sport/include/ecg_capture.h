@@ -0,0 +1,161 @@
+/**
+ * @file ecg_capture.h
+ * @brief Captura de la forma de onda ECG (cruda y filtrada) en la tarjeta SD
+ * @authors Juan Perez, Ana Gomez
+ * @date 2025
+ *
+ * @details Modo opcional (ECG_CAPTURE = 1) para depurar el detector: cada
+ * muestra se guarda con la lectura del ADC y la salida del filtro en un
+ * archivo ECGnn.BIN preasignado al arrancar como un rango contiguo de
+ * sectores (CAPTURE_MINUTES de duración).
+ *
+ * - La tarea ECG (contexto de interrupción) solo copia muestras a un anillo
+ *   de CAPTURE_SECTORS sectores en RAM (mínimo 2: doble buffer).
+ * - Una tarea diferida escribe cada sector lleno directamente en su bloque
+ *   de la tarjeta con Sd2Card::writeBlock(): sin FAT, sin caché y sin
+ *   búsquedas, así que la escritura dura lo mismo al principio y al final.
+ * - Si la tarjeta se atrasa más de CAPTURE_SECTORS - 1 sectores, el sector
+ *   en curso se descarta (se cuenta) y el muestreo sigue sin bloquearse.
+ *
+ * A 500 Hz son ~4 sectores/s (2 KB/s) y 90 minutos ocupan ~10.8 MB; una
+ * escritura de bloque tarda unos pocos ms en una tarjeta típica.
+ *
+ * Cada sector lleva el índice de su primera muestra (contado desde el
+ * arranque del ADC a SAMPLE_RATE), así que el tiempo de cada muestra es
+ * exacto y los huecos por descarte se detectan. tools/ecgcap2csv.cpp
+ * convierte el archivo a CSV o a la entrada del reproductor en PC.
+ *
+ * Este encabezado no depende de Arduino para poder usarse desde el PC.
+ */
+
+#ifndef ECG_CAPTURE_H
+#define ECG_CAPTURE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "session_log.h"                 // crc16Ccitt()
+
+// ==================== FORMATO ====================
+
+/** @brief Versión del formato de captura */
+#define CAPTURE_VERSION     1
+
+/** @brief Muestras por sector: 8 B de encabezado + 126 × 4 B = 512 B */
+#define CAPTURE_PER_SECTOR  126
+
+/**
+ * @struct CaptureFileHeader
+ * @brief Primer sector del archivo
+ */
+struct __attribute__((packed)) CaptureFileHeader {
+  char magic[4];                         ///< "WECG"
+  uint16_t version;                      ///< CAPTURE_VERSION
+  uint16_t sampleRate;                   ///< SAMPLE_RATE (Hz)
+  uint8_t adcBits;                       ///< ECG_SAMPLE_BITS (bits de raw)
+  uint8_t perSector;                     ///< CAPTURE_PER_SECTOR
+  uint16_t reserved;
+  uint32_t startMs;                      ///< millis() al crear el archivo
+  uint32_t dataSectors;                  ///< Sectores de datos preasignados
+  uint16_t crc;                          ///< CRC-16 de los bytes anteriores
+  uint8_t pad[512 - 22];
+};
+
+/**
+ * @struct CaptureSample
+ * @brief Una muestra en los dos canales
+ */
+struct __attribute__((packed)) CaptureSample {
+  uint16_t raw;                          ///< Muestra de la adquisición (adcBits bits)
+  int16_t filt;                          ///< Salida del filtro (cuentas del ADC, redondeada)
+};
+
+/**
+ * @struct CaptureSector
+ * @brief Sector de datos
+ *
+ * Las muestras son consecutivas desde firstSample. La región preasignada se
+ * borra al crear el archivo; según la tarjeta el borrado deja los bloques en
+ * 0x00 o en 0xFF, así que un sector con count == 0 o con todos sus bytes en
+ * 0xFF no se escribió (ver captureSectorErased()).
+ */
+struct __attribute__((packed)) CaptureSector {
+  uint16_t crc;                          ///< CRC-16 del resto del sector
+  uint16_t count;                        ///< Muestras válidas (≤ CAPTURE_PER_SECTOR)
+  uint32_t firstSample;                  ///< Índice de la primera muestra
+  CaptureSample s[CAPTURE_PER_SECTOR];
+};
+
+static_assert(sizeof(CaptureFileHeader) == 512, "CaptureFileHeader debe ocupar un sector");
+static_assert(sizeof(CaptureSector) == 512, "CaptureSector debe ocupar un sector");
+
+/**
+ * @brief CRC-16 de un sector de datos (todo menos el propio campo crc)
+ */
+static inline uint16_t captureSectorCrc(const CaptureSector &s) {
+  return crc16Ccitt(&s.count, sizeof(CaptureSector) - offsetof(CaptureSector, count));
+}
+
+/**
+ * @brief Indica si un sector quedó como lo dejó el borrado (fin de la captura)
+ *
+ * Un sector escrito nunca tiene count == 0, y todo en 0xFF daría
+ * count = 0xFFFF, fuera de rango.
+ */
+static inline bool captureSectorErased(const CaptureSector &s) {
+  if (s.count == 0) return true;
+  const uint8_t *p = (const uint8_t *)&s;
+  for (size_t i = 0; i < sizeof(s); i++) {
+    if (p[i] != 0xFF) return false;
+  }
+  return true;
+}
+
+// ==================== CAPTURA (FIRMWARE) ====================
+
+/**
+ * @struct CaptureStats
+ * @brief Contadores de la captura
+ */
+struct CaptureStats {
+  uint32_t sectors;                      ///< Sectores escritos
+  uint32_t dropped;                      ///< Sectores descartados por atraso de la tarjeta
+  uint32_t errors;                       ///< Escrituras fallidas
+  uint32_t writeMaxUs;                   ///< Escritura de bloque más lenta desde la última lectura
+};
+
+/**
+ * @brief Crea y preasigna el archivo de captura
+ *
+ * Debe llamarse antes de SD.begin(): usa su propia instancia de la tarjeta
+ * y del volumen, y la FAT solo se modifica aquí.
+ *
+ * @param csPin Pin CS de la tarjeta
+ * @return true Si la captura quedó activa
+ */
+bool captureBegin(uint8_t csPin);
+
+/**
+ * @brief Agrega una muestra (contexto de la tarea ECG; no accede a la tarjeta)
+ *
+ * @param index Índice de la muestra desde el arranque del ADC
+ * @param raw Lectura del ADC
+ * @param filt Salida del filtro
+ */
+void capturePush(uint32_t index, uint16_t raw, float filt);
+
+/**
+ * @brief Escribe los sectores llenos pendientes (tarea diferida)
+ */
+void captureService();
+
+/**
+ * @brief Indica si la captura está activa y con espacio
+ */
+bool captureActive();
+
+/**
+ * @brief Copia las estadísticas y reinicia la latencia máxima
+ */
+CaptureStats captureTakeStats();
+
+#endif // ECG_CAPTURE_H
@@ -0,0 +1,102 @@
+/**
+ * @file ecg_decim.h
+ * @brief Diezmado de la adquisición ECG sobremuestreada
+ * @authors Juan Perez, Ana Gomez
+ * @date 2025
+ *
+ * @details Con ECG_OVS_ON, TC3 dispara el ADC a ECG_OVS_RATE (ECG_DECIM
+ * veces SAMPLE_RATE) y cada disparo entrega la suma de ECG_ADC_AVG
+ * conversiones acumuladas por el propio ADC (AVGCTRL). EcgDecimator suma
+ * en ventana móvil las últimas ECG_DECIM_TAPS lecturas y entrega una
+ * muestra de cada ECG_DECIM, escalada a 16 bits.
+ *
+ * Cada muestra promedia ECG_ADC_AVG * ECG_DECIM_TAPS conversiones: el ruido
+ * blanco baja en su raíz cuadrada (hasta 3.8 bits más con 4 x 50). Con
+ * ECG_DECIM_MAINS la ventana dura exactamente un ciclo de red, y la suma
+ * móvil tiene ceros en ECG_NOTCH_HZ y en todos sus armónicos, incluidos los
+ * que se plegarían a la banda al diezmar; el notch de la cascada deja de
+ * hacer falta. A cambio, la ventana atenúa la banda alta: -3 dB cerca de
+ * 0.44 * ECG_NOTCH_HZ (26 Hz con red de 60 Hz), suficiente para el QRS.
+ *
+ * Costo por muestra entregada: ECG_DECIM sumas y restas y una
+ * multiplicación entera (sin división: el M0+ no la tiene).
+ */
+
+#ifndef ECG_DECIM_H
+#define ECG_DECIM_H
+
+#include <stdint.h>
+#include <string.h>
+#include "config.h"
+
+/** @brief Resolución de cada conversión al acumular (AVGCTRL convierte siempre a 12 bits) */
+#define ECG_OVS_ADC_BITS  12
+
+/** @brief Disparos del ADC por segundo */
+#define ECG_OVS_RATE      ((uint32_t)SAMPLE_RATE * ECG_DECIM)
+
+/** @brief Longitud de la ventana móvil (lecturas) */
+#if ECG_DECIM_MAINS && ECG_NOTCH_HZ > 0
+#define ECG_DECIM_TAPS    (ECG_OVS_RATE / ECG_NOTCH_HZ)
+#else
+#define ECG_DECIM_TAPS    ECG_DECIM
+#endif
+
+/** @brief La ventana del diezmado anula la red: la cascada no lleva notch */
+#define ECG_DECIM_NOTCH   (ECG_OVS_ON && ECG_DECIM_MAINS && ECG_NOTCH_HZ > 0)
+
+/** @brief Escala de la suma a 16 bits en Q15, truncada para no pasar de 65535 */
+#define ECG_DECIM_RECIP   ((1UL << (31 - ECG_OVS_ADC_BITS)) / ((uint32_t)ECG_ADC_AVG * ECG_DECIM_TAPS))
+
+static_assert((ECG_ADC_AVG & (ECG_ADC_AVG - 1)) == 0 && ECG_ADC_AVG <= 16,
+              "ECG_ADC_AVG debe ser potencia de 2 y no mayor que 16");
+static_assert(!(ECG_DECIM_MAINS && ECG_NOTCH_HZ > 0) || ECG_OVS_RATE % ECG_NOTCH_HZ == 0,
+              "SAMPLE_RATE * ECG_DECIM debe ser múltiplo de ECG_NOTCH_HZ");
+static_assert(ECG_DECIM_TAPS >= ECG_DECIM, "La ventana debe cubrir al menos ECG_DECIM lecturas");
+static_assert(ECG_DECIM_RECIP >= 256, "ECG_ADC_AVG * ECG_DECIM_TAPS demasiado grande (error de escala > 0.4 %)");
+
+/**
+ * @struct EcgDecimator
+ * @brief Suma móvil de ECG_DECIM_TAPS lecturas entregada cada ECG_DECIM
+ *
+ * El buffer de entrada reserva ECG_DECIM_TAPS posiciones antes de la
+ * primera lectura; process() copia ahí la cola del bloque anterior, así que
+ * la lectura que sale de la ventana siempre está ECG_DECIM_TAPS posiciones
+ * atrás y no hay anillo que actualizar: dos cargas, una resta y una suma
+ * por lectura.
+ */
+struct EcgDecimator {
+  uint16_t tail[ECG_DECIM_TAPS];         ///< Últimas lecturas del bloque anterior
+  uint32_t sum;                          ///< Suma de la ventana
+  bool primed;                           ///< tail ya se llenó con la primera lectura
+
+  /**
+   * @brief Diezma un bloque de lecturas del ADC
+   *
+   * La primera lectura llena la ventana entera para que la salida no
+   * arranque desde cero (el pasa-altas tardaría segundos en asentarse).
+   *
+   * @param in nOut * ECG_DECIM sumas de ECG_ADC_AVG conversiones, con
+   *           ECG_DECIM_TAPS posiciones libres antes (se sobrescriben)
+   * @param out nOut muestras de 16 bits
+   * @param nOut Número de muestras a entregar
+   */
+  void process(uint16_t *in, uint16_t *out, int nOut) {
+    if (!primed) {
+      for (uint16_t i = 0; i < ECG_DECIM_TAPS; ++i) tail[i] = in[0];
+      sum = (uint32_t)in[0] * ECG_DECIM_TAPS;
+      primed = true;
+    }
+    memcpy(in - ECG_DECIM_TAPS, tail, sizeof(tail));
+    const uint16_t *p = in;
+    for (int k = 0; k < nOut; ++k) {
+      for (int j = 0; j < ECG_DECIM; ++j, ++p) {
+        sum += p[0] - p[-(int)ECG_DECIM_TAPS];  // Módulo 2^32: la suma sigue siendo exacta
+      }
+      out[k] = (uint16_t)((sum * ECG_DECIM_RECIP) >> 15);
+    }
+    memcpy(tail, p - ECG_DECIM_TAPS, sizeof(tail));
+  }
+};
+
+#endif // ECG_DECIM_H
@@ -8,6 +8,10 @@
 #ifndef FILTER_H
 #define FILTER_H
 
+#include <stdint.h>
+#include "config.h"
+#include "ecg_decim.h"
+
 /**
  * @struct Biquad
  * @brief Filtro biquad de segundo orden para procesamiento de señal
@@ -21,17 +25,57 @@ struct Biquad {
   float z1, z2;      ///< Estados internos del filtro
 };
 
+/** @brief Notch de red eléctrica activo si cabe bajo Nyquist y el diezmado no anula ya la red */
+#define ECG_NOTCH_ON (ECG_NOTCH_HZ > 0 && 2 * ECG_NOTCH_HZ < SAMPLE_RATE && !ECG_DECIM_NOTCH)
+
+/** @brief Número de etapas de la cascada ECG (pasa-banda de 4 etapas + notch) */
+#define SOS_STAGES (4 + (ECG_NOTCH_ON ? 1 : 0))
+
 /**
  * @brief Banco de filtros biquad en cascada para filtrado de señal ECG
  */
-extern Biquad sos[4];
+extern Biquad sos[SOS_STAGES];
 
 /**
  * @brief Aplica el banco de filtros biquad a una muestra
  * 
+ * Usa el motor seleccionado con FILTER_ENGINE en config.h.
+ * 
  * @param x Muestra de entrada sin filtrar
  * @return float Muestra filtrada
  */
 float filterSample(float x);
 
+/**
+ * @brief Aplica la cascada float de referencia (sos) a una muestra
+ * 
+ * @param x Muestra de entrada sin filtrar
+ * @return float Muestra filtrada
+ */
+float filterSampleFloat(float x);
+
+/**
+ * @brief Filtra una lectura cruda del ADC sin pasar por float en la entrada
+ * 
+ * Con un motor de punto fijo la muestra se centra en la mitad de escala y se
+ * escala al formato Q antes de filtrar; la salida vuelve en unidades del ADC
+ * (ADC_RESOLUTION bits) aunque la entrada venga sobremuestreada.
+ * 
+ * @param adc Muestra de la adquisición (0 a 2^ECG_SAMPLE_BITS - 1)
+ * @return float Muestra filtrada en cuentas del ADC
+ */
+float filterAdcSample(int adc);
+
+/**
+ * @brief Filtra un bloque completo de lecturas del ADC
+ * 
+ * Equivale a llamar filterAdcSample() por cada muestra, pero recorre el
+ * bloque dentro del módulo de filtrado sin llamadas por muestra.
+ * 
+ * @param in Muestras de la adquisición (ECG_SAMPLE_BITS bits)
+ * @param out Muestras filtradas en cuentas del ADC
+ * @param n Número de muestras
+ */
+void filterAdcBlock(const uint16_t *in, float *out, int n);
+
 #endif // FILTER_H
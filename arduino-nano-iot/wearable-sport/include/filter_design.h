@@ -0,0 +1,176 @@
+/**
+ * @file filter_design.h
+ * @brief Diseño de biquads en tiempo de compilación (Butterworth y notch)
+ * @authors Juan Perez, Ana Gomez
+ * @date 2025
+ *
+ * @details Todas las funciones son constexpr (C++11): los coeficientes de
+ * la cascada se calculan durante la compilación a partir de las frecuencias
+ * de corte y de SAMPLE_RATE, sin costo en el arranque ni en RAM adicional.
+ * Se usa la transformada bilineal con pre-distorsión de frecuencia
+ * (K = tan(pi*fc/fs)), igual que butter() de MATLAB/SciPy.
+ *
+ * Convención de signos igual que Biquad:
+ * y[n] = b0*x[n] + b1*x[n-1] + b2*x[n-2] - a1*y[n-1] - a2*y[n-2]
+ */
+
+#ifndef FILTER_DESIGN_H
+#define FILTER_DESIGN_H
+
+#include "filter.h"
+
+namespace fdesign {
+
+// ==================== MATEMÁTICAS CONSTEXPR ====================
+
+/** @brief pi (no se llama PI: Arduino.h lo define como macro) */
+constexpr double kPi = 3.14159265358979323846;
+
+/** @brief Lleva el ángulo al intervalo [-pi, pi] */
+constexpr double wrapPi(double x) {
+  return x > kPi ? wrapPi(x - 2 * kPi) : (x < -kPi ? wrapPi(x + 2 * kPi) : x);
+}
+
+/** @brief Serie de Taylor de sin(x) a partir del término k */
+constexpr double sinSeries(double x2, double term, int k) {
+  return k > 40 ? term : term + sinSeries(x2, -term * x2 / ((k + 1) * (k + 2)), k + 2);
+}
+
+/** @brief Serie de Taylor de cos(x) a partir del término k */
+constexpr double cosSeries(double x2, double term, int k) {
+  return k > 40 ? term : term + cosSeries(x2, -term * x2 / ((k + 1) * (k + 2)), k + 2);
+}
+
+constexpr double sinC(double x) {
+  return sinSeries(wrapPi(x) * wrapPi(x), wrapPi(x), 1);
+}
+
+constexpr double cosC(double x) {
+  return cosSeries(wrapPi(x) * wrapPi(x), 1.0, 0);
+}
+
+constexpr double tanC(double x) {
+  return sinC(x) / cosC(x);
+}
+
+// ==================== ETAPAS DE SEGUNDO ORDEN ====================
+
+/** @brief Factor de calidad de la etapa k de un Butterworth de orden par N */
+constexpr double butterQ(int order, int k) {
+  return 1.0 / (2.0 * cosC((2 * k + 1) * kPi / (2.0 * order)));
+}
+
+/** @brief Pre-distorsión bilineal: K = tan(pi*fc/fs) */
+constexpr double prewarp(double fc, double fs) {
+  return tanC(kPi * fc / fs);
+}
+
+constexpr Biquad lowpassK(double K, double Q, double D) {
+  return Biquad{(float)(K * K / D), (float)(2 * K * K / D), (float)(K * K / D),
+                (float)(2 * (K * K - 1) / D), (float)((1 - K / Q + K * K) / D), 0, 0};
+}
+
+constexpr Biquad highpassK(double K, double Q, double D) {
+  return Biquad{(float)(1 / D), (float)(-2 / D), (float)(1 / D),
+                (float)(2 * (K * K - 1) / D), (float)((1 - K / Q + K * K) / D), 0, 0};
+}
+
+/**
+ * @brief Pasa-bajas de segundo orden con ganancia unitaria en DC
+ *
+ * @param fc Frecuencia de corte (Hz)
+ * @param fs Frecuencia de muestreo (Hz)
+ * @param Q Factor de calidad (0.7071 = Butterworth de 2o orden)
+ */
+constexpr Biquad lowpass(double fc, double fs, double Q) {
+  return lowpassK(prewarp(fc, fs), Q, 1 + prewarp(fc, fs) / Q + prewarp(fc, fs) * prewarp(fc, fs));
+}
+
+/**
+ * @brief Pasa-altas de segundo orden con ganancia unitaria en Nyquist
+ *
+ * @param fc Frecuencia de corte (Hz)
+ * @param fs Frecuencia de muestreo (Hz)
+ * @param Q Factor de calidad
+ */
+constexpr Biquad highpass(double fc, double fs, double Q) {
+  return highpassK(prewarp(fc, fs), Q, 1 + prewarp(fc, fs) / Q + prewarp(fc, fs) * prewarp(fc, fs));
+}
+
+constexpr Biquad notchW(double c, double alpha) {
+  return Biquad{(float)(1 / (1 + alpha)), (float)(-2 * c / (1 + alpha)), (float)(1 / (1 + alpha)),
+                (float)(-2 * c / (1 + alpha)), (float)((1 - alpha) / (1 + alpha)), 0, 0};
+}
+
+/**
+ * @brief Rechaza-banda (notch) de segundo orden, ganancia unitaria fuera de f0
+ *
+ * @param f0 Frecuencia a eliminar (Hz)
+ * @param fs Frecuencia de muestreo (Hz)
+ * @param Q Factor de calidad (ancho de banda = f0 / Q)
+ */
+constexpr Biquad notch(double f0, double fs, double Q) {
+  return notchW(cosC(2 * kPi * f0 / fs), sinC(2 * kPi * f0 / fs) / (2 * Q));
+}
+
+constexpr Biquad bandpassW(double c, double alpha) {
+  return Biquad{(float)(alpha / (1 + alpha)), 0.0f, (float)(-alpha / (1 + alpha)),
+                (float)(-2 * c / (1 + alpha)), (float)((1 - alpha) / (1 + alpha)), 0, 0};
+}
+
+/**
+ * @brief Pasa-banda resonante de segundo orden, ganancia unitaria en f0
+ *
+ * @param f0 Frecuencia central (Hz)
+ * @param fs Frecuencia de muestreo (Hz)
+ * @param Q Factor de calidad
+ */
+constexpr Biquad bandpass(double f0, double fs, double Q) {
+  return bandpassW(cosC(2 * kPi * f0 / fs), sinC(2 * kPi * f0 / fs) / (2 * Q));
+}
+
+// ==================== BUTTERWORTH DE ORDEN N ====================
+
+/**
+ * @brief Etapa k de un pasa-bajas Butterworth de orden par N (N/2 etapas)
+ */
+constexpr Biquad butterLowpass(double fc, double fs, int order, int k) {
+  return lowpass(fc, fs, butterQ(order, k));
+}
+
+/**
+ * @brief Etapa k de un pasa-altas Butterworth de orden par N (N/2 etapas)
+ */
+constexpr Biquad butterHighpass(double fc, double fs, int order, int k) {
+  return highpass(fc, fs, butterQ(order, k));
+}
+
+/**
+ * @brief Etapa k de un pasa-banda Butterworth (pasa-altas + pasa-bajas)
+ *
+ * Las primeras order/2 etapas son el pasa-bajas en fHigh y las siguientes
+ * order/2 el pasa-altas en fLow, en total `order` etapas.
+ *
+ * @param fLow Corte inferior (Hz)
+ * @param fHigh Corte superior (Hz)
+ * @param fs Frecuencia de muestreo (Hz)
+ * @param order Orden par de cada sección (pasa-bajas y pasa-altas)
+ * @param k Etapa (0 .. order-1)
+ */
+constexpr Biquad butterBandpass(double fLow, double fHigh, double fs, int order, int k) {
+  return k < order / 2 ? butterLowpass(fHigh, fs, order, k)
+                       : butterHighpass(fLow, fs, order, k - order / 2);
+}
+
+// ==================== VERIFICACIÓN ====================
+
+/**
+ * @brief Polos dentro del círculo unitario (triángulo de estabilidad)
+ */
+constexpr bool isStable(const Biquad &s) {
+  return s.a2 < 1.0f && s.a1 < 1.0f + s.a2 && -s.a1 < 1.0f + s.a2;
+}
+
+} // namespace fdesign
+
+#endif // FILTER_DESIGN_H
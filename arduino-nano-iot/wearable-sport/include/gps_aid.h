@@ -0,0 +1,97 @@
+/**
+ * @file gps_aid.h
+ * @brief Arranque en caliente del GPS: última posición y base de navegación en la SD
+ * @authors Juan Perez, Ana Gomez
+ * @date 2025
+ *
+ * @details Sin datos previos el receptor tarda de 30 s a varios minutos en
+ * el primer fix (arranque en frío). Cada GPS_AID_SAVE_MIN minutos se guarda
+ * en GPS_AID_FILENAME la última posición válida, su hora y, en modo UBX, la
+ * base de navegación del receptor (efemérides, almanaque, ionosfera), que se
+ * pide con un MGA-DBD vacío y llega como una serie de MGA-DBD. Al arrancar
+ * se devuelven al receptor:
+ *
+ * - MGA-INI-POS_LLH con la última posición y una incertidumbre de al menos
+ *   GPS_AID_POS_ACC_M (el atleta vuelve a la misma cancha o a la ciudad).
+ * - Los MGA-DBD guardados, tal como los entregó el receptor.
+ *
+ * No hay una señal de apagado: se guarda periódicamente, así que lo que se
+ * recupera tiene a lo sumo GPS_AID_SAVE_MIN minutos de antigüedad. La hora
+ * se guarda pero no se envía: sin reloj con batería la placa no sabe cuánto
+ * tiempo estuvo apagada, y una hora errónea retrasa el fix más que ninguna.
+ *
+ * Formato del archivo: GpsAidHeader seguido de dbdBytes bytes con una
+ * entrada por mensaje, [longitud (2 B, little-endian)][carga útil].
+ *
+ * Requiere un receptor u-blox M8 o posterior (mensajes MGA); otros
+ * receptores ignoran las tramas.
+ */
+
+#ifndef GPS_AID_H
+#define GPS_AID_H
+
+#include <stdint.h>
+
+struct GpsFix;
+class HardwareSerial;
+
+/** @brief Versión del formato de GPS_AID_FILENAME */
+#define GPS_AID_VERSION 1
+
+/**
+ * @struct GpsAidHeader
+ * @brief Encabezado de GPS_AID_FILENAME
+ */
+struct __attribute__((packed)) GpsAidHeader {
+  char magic[4];                         ///< "WSGA"
+  uint16_t version;                      ///< GPS_AID_VERSION
+  uint16_t dbdBytes;                     ///< Bytes de MGA-DBD que siguen al encabezado
+  int32_t latE7;                         ///< Última latitud (1e-7 grados)
+  int32_t lonE7;                         ///< Última longitud (1e-7 grados)
+  int32_t altCm;                         ///< Altitud (cm)
+  uint32_t hAccMm;                       ///< Precisión horizontal (mm; 0 = no disponible)
+  uint32_t utcDate;                      ///< AAAAMMDD de la posición (0 = sin fecha)
+  uint32_t utcTimeMs;                    ///< Hora UTC de la posición (ms desde las 00:00)
+  uint16_t dbdCrc;                       ///< CRC-16 de los bytes de MGA-DBD
+  uint16_t crc;                          ///< CRC-16 de los bytes anteriores
+};
+
+/**
+ * @brief Lee GPS_AID_FILENAME de la SD
+ *
+ * @return true Si hay una posición válida que enviar
+ */
+bool gpsAidLoad();
+
+/**
+ * @brief Envía al receptor la posición y la base de navegación leídas
+ *
+ * Se llama una vez, con el puerto ya a la velocidad del receptor.
+ *
+ * @param port Puerto serie del GPS
+ */
+void gpsAidPush(HardwareSerial &port);
+
+/**
+ * @brief Guarda un MGA-DBD recibido (ver UbxParser::takeDbd())
+ *
+ * Solo se aceptan tramas entre el pedido del volcado y el guardado; las
+ * que lleguen fuera de ese minuto se descartan.
+ *
+ * @param payload Carga útil
+ * @param len Bytes de la carga útil
+ */
+void gpsAidDbd(const uint8_t *payload, uint16_t len);
+
+/**
+ * @brief Actualiza la última posición; pide el volcado y guarda el archivo según GPS_AID_SAVE_MIN
+ *
+ * Se llama una vez por minuto. El volcado se pide un minuto antes del
+ * guardado para que el receptor tenga tiempo de enviarlo.
+ *
+ * @param port Puerto serie del GPS
+ * @param fix Última solución
+ */
+void gpsAidMinute(HardwareSerial &port, const GpsFix &fix);
+
+#endif // GPS_AID_H
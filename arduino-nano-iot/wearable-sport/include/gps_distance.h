@@ -0,0 +1,82 @@
+/**
+ * @file gps_distance.h
+ * @brief Distancia recorrida fusionando la velocidad Doppler con las posiciones GPS
+ * @authors Juan Perez, Ana Gomez
+ * @date 2025
+ *
+ * @details La velocidad Doppler da una distancia inmediata y de poco ruido
+ * por época, pero el promedio móvil y el umbral de V_THRESH_KMH la sesgan
+ * en arranques, frenadas y al caminar despacio. Las posiciones no tienen
+ * ese sesgo, pero su ruido (varios metros) domina en tramos cortos.
+ *
+ * Por eso la distancia se entrega en cada época con la velocidad y se
+ * corrige por tramos: desde una posición ancla se acumula la distancia
+ * Doppler, y cuando la posición actual se aleja del ancla más de
+ * GPS_SEG_MIN_M (o 3 σ de la posición), o pasa GPS_SEG_MAX_MS, se combinan
+ * la cuerda ancla-posición y la distancia Doppler del tramo con pesos
+ * inversos a sus varianzas. La diferencia se suma como corrección.
+ *
+ * - Distancia entre posiciones: equirrectangular con cos(latitud) en caché
+ *   (se recalcula cuando la latitud cambia más de 0.01°); haversine solo
+ *   para cuerdas de más de 1 km o latitudes sobre 80°.
+ * - σ de la posición: hAcc del receptor (UBX) o HDOP × GPS_UERE_M (NMEA).
+ * - Se descartan posiciones con HDOP > GPS_HDOP_MAX o con una velocidad
+ *   implícita desde la anterior aceptada mayor que GPS_MAX_KMH.
+ * - Un tramo que llega a GPS_SEG_MAX_MS sin superar el umbral (parado o
+ *   demasiado lento para resolverlo) se cierra sin corrección.
+ *
+ * Por época: un par de restas enteras, ~6 multiplicaciones float y una
+ * sqrtf, sin trigonometría salvo al refrescar la caché; a 10 Hz es una
+ * fracción mínima del M0+.
+ */
+
+#ifndef GPS_DISTANCE_H
+#define GPS_DISTANCE_H
+
+#include <stdint.h>
+#include "gps_fix.h"
+
+/**
+ * @struct GpsDistanceStats
+ * @brief Contadores del motor de distancia (se reinician al leerlos)
+ */
+struct GpsDistanceStats {
+  float dopplerM;                        ///< Distancia por velocidad
+  float positionM;                       ///< Suma de cuerdas de los tramos aceptados
+  float correctionM;                     ///< Corrección total aplicada
+  uint16_t segments;                     ///< Tramos cerrados con corrección
+  uint16_t rejected;                     ///< Posiciones descartadas
+};
+
+/**
+ * @brief Reinicia el ancla (tras un hueco sin soluciones)
+ */
+void gpsDistanceReset();
+
+/**
+ * @brief Distancia de una época: velocidad × intervalo más la corrección por posición
+ *
+ * @param fix Solución de la época
+ * @param v_kmh Velocidad filtrada de la época (km/h)
+ * @param dtMs Intervalo desde la época anterior (ms)
+ * @return float Distancia a acumular (m, nunca negativa)
+ */
+float gpsDistanceStep(const GpsFix &fix, float v_kmh, uint32_t dtMs);
+
+/**
+ * @brief Distancia entre dos posiciones (m)
+ *
+ * @param latE7A Latitud del punto A (1e-7 grados)
+ * @param lonE7A Longitud del punto A (1e-7 grados)
+ * @param latE7B Latitud del punto B (1e-7 grados)
+ * @param lonE7B Longitud del punto B (1e-7 grados)
+ * @return float Distancia (m)
+ */
+float gpsDistanceM(int32_t latE7A, int32_t lonE7A, int32_t latE7B, int32_t lonE7B);
+
+/**
+ * @brief Copia las estadísticas y las reinicia
+ */
+GpsDistanceStats gpsDistanceTakeStats();
+
+#endif // GPS_DISTANCE_H
@@ -0,0 +1,58 @@
+/**
+ * @file gps_fix.h
+ * @brief Solución GPS en punto fijo, común a los parsers NMEA y UBX
+ * @authors Juan Perez, Ana Gomez
+ * @date 2025
+ */
+
+#ifndef GPS_FIX_H
+#define GPS_FIX_H
+
+#include <stdint.h>
+
+/** @brief Bits de GpsFix::valid */
+enum GpsValid : uint16_t {
+  GPS_LOCATION = 1 << 0,
+  GPS_SPEED    = 1 << 1,
+  GPS_COURSE   = 1 << 2,
+  GPS_DATE     = 1 << 3,
+  GPS_TIME     = 1 << 4,
+  GPS_SATS     = 1 << 5,
+  GPS_HDOP     = 1 << 6,
+  GPS_ALTITUDE = 1 << 7
+};
+
+/**
+ * @struct GpsFix
+ * @brief Último valor válido de cada campo
+ */
+struct GpsFix {
+  int32_t latE7;                         ///< Latitud (1e-7 grados, norte positivo)
+  int32_t lonE7;                         ///< Longitud (1e-7 grados, este positivo)
+  int32_t altCm;                         ///< Altitud sobre el nivel del mar (cm)
+  uint32_t towMs;                        ///< Hora de la solución (ms; del día en NMEA, de la semana en UBX)
+  uint32_t hAccMm;                       ///< Precisión horizontal estimada (mm; 0 = no disponible)
+  uint32_t speed;                        ///< Velocidad sobre el suelo (0.01 km/h)
+  uint16_t course;                       ///< Rumbo (0.01 grados)
+  uint16_t hdop;                         ///< HDOP (0.01; PDOP en UBX)
+  uint16_t year;
+  uint8_t month, day;
+  uint8_t hour, minute, second, centis;  ///< Hora UTC
+  uint8_t sats;                          ///< Satélites en uso
+  uint8_t quality;                       ///< Calidad del fix de GGA (0 = sin fix)
+  uint16_t valid;                        ///< Campos con valor (GpsValid)
+  uint16_t updated;                      ///< Campos de la última oración/mensaje aceptado
+
+  bool has(uint16_t mask) const { return (valid & mask) == mask; }
+
+  /** @brief Fecha UTC como AAAAMMDD */
+  uint32_t utcDate() const { return year * 10000UL + month * 100UL + day; }
+
+  /** @brief Hora UTC como HHMMSS */
+  uint32_t utcHms() const { return hour * 10000UL + minute * 100UL + second; }
+
+  /** @brief Hora UTC en ms desde la medianoche */
+  uint32_t utcMs() const { return ((hour * 60UL + minute) * 60UL + second) * 1000UL + centis * 10UL; }
+};
+
+#endif // GPS_FIX_H
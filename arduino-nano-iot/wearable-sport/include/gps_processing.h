@@ -8,12 +8,19 @@
 #ifndef GPS_PROCESSING_H
 #define GPS_PROCESSING_H
 
-#include <TinyGPSPlus.h>
 #include "config.h"
 
+#if GPS_PROTOCOL == GPS_UBX
+#include "ubx.h"
+typedef UbxParser GpsParser;
+#else
+#include "nmea_parser.h"
+typedef NmeaParser GpsParser;
+#endif
+
 // ==================== VARIABLES GPS ====================
 
-extern TinyGPSPlus gps;                  ///< Objeto para procesamiento de datos GPS
+extern GpsParser gps;                    ///< Parser del receptor GPS (NMEA o UBX según GPS_PROTOCOL)
 
 extern float vbuf[5];                    ///< Buffer para promedio móvil de velocidad
 extern int vidx;                         ///< Índice en buffer de velocidad
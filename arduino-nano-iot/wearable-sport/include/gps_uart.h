@@ -0,0 +1,81 @@
+/**
+ * @file gps_uart.h
+ * @brief Recepción del GPS por DMA a un anillo circular
+ * @authors Juan Perez, Ana Gomez
+ * @date 2025
+ *
+ * @details Con el buffer RX del core, cualquier bloqueo de loop() más largo
+ * que lo que cabe en él (apertura de archivos en la SD, el resumen del
+ * minuto, una ráfaga de Serial.print) pierde bytes sin aviso. Con
+ * GPS_RX_MODE == GPS_RX_DMA un canal DMA copia cada byte recibido por el
+ * SERCOM de Serial1 a un anillo de GPS_RX_RING bytes con un descriptor que
+ * se encadena a sí mismo, sin interrupción por byte. tareaGps() procesa
+ * por lotes lo acumulado desde la última vez:
+ *
+ *   const uint8_t *p;
+ *   size_t n;
+ *   while ((n = gpsUartPeek(&p)) > 0) {
+ *     for (size_t i = 0; i < n; i++) gps.encode(p[i]);
+ *     gpsUartConsume(n);
+ *   }
+ *
+ * La posición de escritura sale del BTCNT del canal y de las vueltas
+ * completas (interrupción de fin de bloque). Si el consumidor se atrasa
+ * más de una vuelta, los bytes sobrescritos se cuentan como overruns y la
+ * lectura salta a los más recientes; el checksum del parser descarta la
+ * trama cortada.
+ *
+ * La transmisión (configuración UBX, ayuda al GPS) sigue usando
+ * Serial1.write(). Con GPS_RX_CORE, o fuera del SAMD21, la misma interfaz
+ * lee de Serial1 y no detecta pérdidas.
+ */
+
+#ifndef GPS_UART_H
+#define GPS_UART_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "config.h"
+
+/**
+ * @struct GpsUartStats
+ * @brief Contadores de la recepción del GPS
+ */
+struct GpsUartStats {
+  uint32_t bytes;                        ///< Bytes entregados al parser
+  uint32_t overruns;                     ///< Bytes sobrescritos antes de leerse
+  uint32_t maxFill;                      ///< Mayor ocupación del anillo vista (B)
+};
+
+/**
+ * @brief Inicia la recepción por DMA
+ *
+ * Se llama después de configurar el receptor (ubxConfigure() y
+ * Serial1.begin() reinician el SERCOM). Los bytes que quedaban en el
+ * buffer del core se descartan.
+ */
+void gpsUartBegin();
+
+/**
+ * @brief Bytes recibidos contiguos en memoria
+ *
+ * @param data Primer byte sin leer (salida)
+ * @return size_t Bytes contiguos disponibles (0 si no hay)
+ */
+size_t gpsUartPeek(const uint8_t **data);
+
+/**
+ * @brief Marca como leídos los bytes entregados por gpsUartPeek()
+ *
+ * @param n Bytes procesados
+ */
+void gpsUartConsume(size_t n);
+
+/**
+ * @brief Devuelve y reinicia los contadores
+ *
+ * @return GpsUartStats Contadores desde la llamada anterior
+ */
+GpsUartStats gpsUartTakeStats();
+
+#endif // GPS_UART_H
@@ -1,6 +1,6 @@
 /**
  * @file heart_rate.h
- * @brief Detección de frecuencia cardíaca mediante señal ECG/EMG
+ * @brief Frecuencia cardíaca a partir de los intervalos RR del detector QRS
  * @authors Juan Perez, Ana Gomez
  * @date 2025
  */
@@ -12,11 +12,6 @@
 
 // ==================== VARIABLES DE DETECCIÓN CARDÍACA ====================
 
-extern float s0, s1, s2;                 ///< Buffer para detección de picos locales
-extern float signalLevel;                ///< Nivel promedio de señal
-extern float noiseLevel;                 ///< Nivel promedio de ruido
-extern float thresh;                     ///< Umbral adaptativo para detección
-extern unsigned long lastBeatMs;         ///< Timestamp del último latido detectado
 extern unsigned long lastPrintBpmMs;     ///< Timestamp de última impresión de BPM
 extern float bpmAvg;                     ///< BPM promedio actual
 
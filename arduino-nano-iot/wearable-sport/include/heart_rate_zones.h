@@ -22,9 +22,15 @@ enum HRZone {
   HZ6 = 5   ///< Zona 6: >= 90% FC máx
 };
 
-extern float secInHZ[6];                 ///< Segundos acumulados por zona de FC
-extern float bpmSumSec;                  ///< Suma de BPM para promedio
-extern int bpmSecCount;                  ///< Contador de muestras para promedio BPM
+/**
+ * @brief Fija la FC máxima y los bordes de las zonas (perfil del atleta)
+ * 
+ * Los bordes se guardan como umbrales enteros en 0.1 bpm: clasificar no divide.
+ * 
+ * @param fcMax Frecuencia cardíaca máxima (bpm)
+ * @param edges Bordes ascendentes como fracción de fcMax
+ */
+void hrZonesConfigure(int fcMax, const float edges[5]);
 
 /**
  * @brief Determina la zona de frecuencia cardíaca según BPM actual
@@ -0,0 +1,59 @@
+/**
+ * @file hrv.h
+ * @brief Variabilidad de la frecuencia cardíaca (RMSSD, SDNN, pNN50)
+ * @authors Juan Perez, Ana Gomez
+ * @date 2025
+ *
+ * @details Mantiene los últimos HRV_WIN intervalos RR en un buffer circular
+ * junto con sumas corrientes enteras (suma, suma de cuadrados, suma de
+ * diferencias sucesivas al cuadrado y conteo de diferencias > 50 ms). Cada
+ * latido entra y el más antiguo sale de las sumas en O(1); las métricas se
+ * obtienen de las sumas sin recorrer la ventana.
+ *
+ * RMSSD y pNN50 usan solo diferencias entre latidos sucesivos: el primer RR
+ * aceptado después de uno descartado no aporta diferencia.
+ */
+
+#ifndef HRV_H
+#define HRV_H
+
+#include <stdint.h>
+#include "config.h"
+
+/**
+ * @struct HrvMetrics
+ * @brief Métricas de HRV sobre la ventana actual
+ */
+struct HrvMetrics {
+  float rmssd;                           ///< Raíz de la media de diferencias sucesivas al cuadrado (ms)
+  float sdnn;                            ///< Desviación estándar de los intervalos RR (ms)
+  float pnn50;                           ///< Porcentaje de diferencias sucesivas > 50 ms
+  int n;                                 ///< Intervalos RR en la ventana
+};
+
+extern uint32_t hrvRejected;             ///< Intervalos RR descartados como artefacto
+
+/**
+ * @brief Agrega un intervalo RR a la ventana de HRV
+ * 
+ * Los intervalos que se alejan más de HRV_ARTIFACT_PCT % del último RR
+ * aceptado (latidos perdidos o ectópicos) o que pasan de 2000 ms se
+ * descartan.
+ * 
+ * @param rr Intervalo RR en milisegundos
+ */
+void hrvPush(unsigned int rr);
+
+/**
+ * @brief Calcula RMSSD, SDNN y pNN50 a partir de las sumas corrientes
+ * 
+ * @return HrvMetrics Métricas de la ventana (ceros si hay menos de 3 RR)
+ */
+HrvMetrics hrvCompute();
+
+/**
+ * @brief Vacía la ventana de HRV
+ */
+void hrvReset();
+
+#endif // HRV_H
@@ -0,0 +1,90 @@
+/**
+ * @file imu.h
+ * @brief Acelerómetro LSM6DS3 integrado en el Arduino Nano 33 IoT (I2C, FIFO)
+ * @authors Juan Perez, Ana Gomez
+ * @date 2025
+ *
+ * @details El sensor está en el bus I2C interno (Wire, dirección 0x6A). Se
+ * configura solo el acelerómetro a IMU_RATE_HZ y ±16 g (los impactos de
+ * placajes y caídas pasan de 8 g), con la FIFO interna en modo continuo.
+ *
+ * La FIFO (8 KB, 1365 muestras de 3 ejes: ~13 s a 104 Hz) guarda cada
+ * muestra como tres palabras X, Y, Z. imuReadFifo() lee FIFO_STATUS1..4 en
+ * una transacción y luego las muestras pendientes en ráfagas de hasta
+ * IMU_BURST_SAMPLES: con IF_INC el puntero vuelve de FIFO_DATA_OUT_H a
+ * FIFO_DATA_OUT_L, así que una sola lectura de 6·n bytes trae n muestras.
+ * Vaciarla cada 100 ms son ~2 transacciones I2C por cada 10–21 muestras en
+ * lugar de 2 por muestra, y una activación de la tarea en lugar de 10–20.
+ */
+
+#ifndef IMU_H
+#define IMU_H
+
+#include <stdint.h>
+
+/** @brief Dirección I2C del LSM6DS3 en el Nano 33 IoT */
+#define IMU_I2C_ADDR      0x6A
+
+/** @brief Registros usados */
+#define LSM6_FIFO_CTRL3   0x08
+#define LSM6_FIFO_CTRL5   0x0A
+#define LSM6_WHO_AM_I     0x0F
+#define LSM6_CTRL1_XL     0x10
+#define LSM6_CTRL3_C      0x12
+#define LSM6_FIFO_STATUS1 0x3A
+#define LSM6_FIFO_DATA_OUT_L 0x3E
+
+/** @brief Identificadores aceptados (LSM6DS3 y LSM6DS3TR-C) */
+#define LSM6_ID_DS3       0x69
+#define LSM6_ID_DS3TRC    0x6A
+
+/** @brief Muestras en la FIFO llena (4096 palabras / 3 ejes) */
+#define LSM6_FIFO_SAMPLES 1365
+
+/** @brief Muestras por transacción I2C (6 B c/u; el buffer de Wire en SAMD es de 256 B) */
+#define IMU_BURST_SAMPLES 40
+
+/** @brief Aceleración por LSB a ±16 g: 0.488 mg */
+#define IMU_G_PER_LSB     0.000488f
+#define IMU_MS2_PER_LSB   (IMU_G_PER_LSB * 9.80665f)
+
+/**
+ * @struct ImuSample
+ * @brief Lectura cruda del acelerómetro (LSB, ejes del sensor)
+ */
+struct ImuSample {
+  int16_t ax, ay, az;
+};
+
+static_assert(sizeof(ImuSample) == 6, "imuReadFifo() decodifica 6 B por muestra en el mismo buffer");
+
+/**
+ * @brief Detecta el acelerómetro y arranca la FIFO en modo continuo
+ *
+ * @return true Si respondió con un WHO_AM_I conocido
+ */
+bool imuBegin();
+
+/**
+ * @brief Lee en ráfaga las muestras acumuladas en la FIFO
+ *
+ * @param buf Muestras leídas (salida)
+ * @param maxSamples Capacidad de buf (hasta IMU_BURST_SAMPLES por transacción)
+ * @return int Muestras leídas (0 si la FIFO está vacía)
+ */
+int imuReadFifo(ImuSample *buf, int maxSamples);
+
+/**
+ * @brief Veces que la FIFO se llenó y perdió muestras desde la última llamada
+ */
+uint16_t imuTakeOverruns();
+
+/**
+ * @brief Aceleración en el eje de avance (IMU_FWD_AXIS, IMU_FWD_SIGN)
+ *
+ * @param s Muestra cruda
+ * @return float Aceleración (m/s²)
+ */
+float imuForwardAccel(const ImuSample &s);
+
+#endif // IMU_H
@@ -10,24 +10,84 @@
 
 #include "config.h"
 
-// ==================== MÉTRICAS DE ENTRENAMIENTO ====================
+// ==================== ACUMULADORES DEL MINUTO ====================
 
-extern float trimpMinute;                ///< TRIMP acumulado en el minuto actual
-extern float dist_m_total;               ///< Distancia total acumulada (m)
-extern float dist_m_minute;              ///< Distancia del minuto actual (m)
-extern float v_kmh_last;                 ///< Última velocidad válida (km/h)
-extern float v_kmh_max_min;              ///< Velocidad máxima del minuto (km/h)
+/**
+ * @struct MinuteBank
+ * @brief Acumuladores de un minuto
+ *
+ * Los totales de la sesión se copian al cerrar el banco para que el
+ * reporte del minuto no lea valores que siguen cambiando.
+ */
+struct MinuteBank {
+  float trimp;                           ///< TRIMP acumulado
+  float distM;                           ///< Distancia (m)
+  float vMaxKmh;                         ///< Velocidad máxima (km/h)
+  float secInVZ[4];                      ///< Segundos por zona de velocidad
+  float distInVZ[4];                     ///< Distancia por zona de velocidad (m)
+  float secInHZ[6];                      ///< Segundos por zona de FC
+  float bpmSum;                          ///< Suma de BPM por segundo (para el promedio)
+  int bpmCount;                          ///< Segundos con BPM
+  int sprints;                           ///< Sprints confirmados
+  float distTotalM;                      ///< Distancia de la sesión al cerrar (m)
+  int sprintsTotal;                      ///< Sprints de la sesión al cerrar
+
+  float bpmMean() const { return bpmCount > 0 ? bpmSum / bpmCount : 0.0f; }
+  float vMeanKmh() const { return distM / 60.0f * 3.6f; }
+};
+
+/**
+ * @struct SessionState
+ * @brief Totales de la sesión y dos bancos de minuto que se alternan
+ *
+ * Las tareas de adquisición acumulan en el banco vivo; al cierre del
+ * minuto minuteSwap() cambia de banco en O(1) y el anterior queda intacto
+ * hasta el cierre siguiente, mientras el reporte lo formatea por partes.
+ */
+struct SessionState {
+  MinuteBank bank[2];
+  uint8_t live;                          ///< Banco en el que se acumula
+  float distTotalM;                      ///< Distancia total (m)
+  int sprintsTotal;                      ///< Sprints totales
+};
+
+extern SessionState session;             ///< Estado de la sesión
+
+/** @brief Banco del minuto en curso */
+static inline MinuteBank &minuteLive() { return session.bank[session.live]; }
 
-// ==================== DETECCIÓN DE SPRINTS ====================
+/**
+ * @brief Cierra el minuto: pasa al otro banco (vacío) y devuelve el cerrado
+ *
+ * @return const MinuteBank& Minuto cerrado; válido hasta la siguiente llamada
+ */
+const MinuteBank &minuteSwap();
 
-extern int sprints_min;                  ///< Sprints detectados en el minuto actual
-extern int sprints_total;                ///< Sprints totales acumulados
-extern bool inSprint;                    ///< Indica si está en sprint actualmente
-extern int sprintHold_s;                 ///< Segundos consecutivos sobre umbral de sprint
+extern float v_kmh_last;                 ///< Última velocidad válida (km/h)
 
 // ==================== VARIABLES DE TEMPORIZACIÓN ====================
 
-extern uint32_t lastGpsMs;               ///< Timestamp de última lectura GPS
+extern uint32_t lastGpsMs;               ///< millis() de la última época GPS con hora
 extern uint32_t tMinuteStartMs;          ///< Timestamp de inicio del minuto actual
 
+/**
+ * @brief Integra una velocidad sobre el intervalo desde la anterior
+ * 
+ * Acumula tiempo en zona de velocidad, velocidad pico y sprints del minuto
+ * con el intervalo real: por época GPS (SPEED_GPS) o por muestra del
+ * acelerómetro (SPEED_KALMAN).
+ * 
+ * @param v_kmh Velocidad filtrada (km/h)
+ * @param dtMs Intervalo desde la velocidad anterior (ms)
+ */
+void integrateSpeed(float v_kmh, uint32_t dtMs);
+
+/**
+ * @brief Acumula la distancia de una época GPS
+ * 
+ * @param d_m Distancia del intervalo, ya corregida por posición (m, ver gps_distance.h)
+ * @param v_kmh Velocidad media del intervalo (km/h): zona a la que se asigna
+ */
+void integrateDistance(float d_m, float v_kmh);
+
 #endif // METRICS_H
@@ -0,0 +1,71 @@
+/**
+ * @file motion.h
+ * @brief Pasos, cadencia e impactos a partir del acelerómetro
+ * @authors Juan Perez, Ana Gomez
+ * @date 2025
+ *
+ * @details Procesa cada muestra de la FIFO en O(1), sin ventanas:
+ *
+ * - Magnitud |a| en g (independiente de la orientación del dispositivo).
+ * - Pasos: |a| menos su promedio lento (~1 s, la gravedad) pasa por un
+ *   pasa-bajas de ~4 Hz; cada cruce ascendente de un umbral adaptativo
+ *   (la mitad del pico promedio de los últimos pasos, mínimo
+ *   0.15 g) separado al menos 250 ms del anterior es un paso. El umbral se
+ *   rearma cuando la señal baja de su mitad y vuelve al mínimo tras 2 s
+ *   sin pasos.
+ * - Cadencia: pasos por minuto sobre los intervalos entre pasos menores a
+ *   2 s (las pausas no la diluyen).
+ * - Impactos: |a| > IMU_IMPACT_G sobre la muestra cruda (el pasa-bajas de
+ *   los pasos recortaría el pico), uno por evento (se rearma al bajar de la
+ *   mitad y tras 300 ms).
+ */
+
+#ifndef MOTION_H
+#define MOTION_H
+
+#include <stdint.h>
+#include "imu.h"
+
+/**
+ * @struct MotionMinute
+ * @brief Agregados de movimiento de un minuto
+ */
+struct MotionMinute {
+  uint16_t steps;                        ///< Pasos
+  float cadenceSpm;                      ///< Cadencia media mientras hay pasos (pasos/min)
+  uint16_t impacts;                      ///< Impactos sobre IMU_IMPACT_G
+  float peakG;                           ///< Aceleración total máxima (g)
+  uint16_t fifoOverruns;                 ///< Desbordamientos de la FIFO (los llena quien registra)
+};
+
+/**
+ * @brief Reinicia detectores y agregados
+ */
+void motionReset();
+
+/**
+ * @brief Pasa-bajas de 4o orden sin sobreimpulso de los 3 ejes, en el mismo buffer
+ *
+ * Quita la vibración de la correa y el ruido del sensor antes de la
+ * detección de pasos y del filtro de velocidad; los impactos se detectan
+ * sobre la muestra cruda. Los 3 ejes comparten la cascada en un BiquadBank
+ * Q31.
+ *
+ * @param s Muestra cruda; se reemplaza por la filtrada (LSB, saturada a 16 bits)
+ */
+void motionFilter(ImuSample &s);
+
+/**
+ * @brief Procesa una muestra del acelerómetro (a IMU_RATE_HZ)
+ *
+ * @param raw Muestra cruda: impactos y aceleración pico
+ * @param filt La misma muestra tras motionFilter(): pasos y cadencia
+ */
+void motionProcess(const ImuSample &raw, const ImuSample &filt);
+
+/**
+ * @brief Copia los agregados del minuto y los reinicia
+ */
+MotionMinute motionTakeMinute();
+
+#endif // MOTION_H
@@ -0,0 +1,91 @@
+/**
+ * @file nmea_parser.h
+ * @brief Parser NMEA incremental para RMC, GGA y VTG con valores en punto fijo
+ * @authors Juan Perez, Ana Gomez
+ * @date 2025
+ *
+ * @details Reemplaza a TinyGPSPlus para los campos que usa el firmware
+ * (posición, velocidad, rumbo, fecha/hora, satélites, HDOP y altitud):
+ *
+ * - No guarda la oración: cada carácter actualiza el checksum y el
+ *   acumulador del campo en curso, y al llegar la coma el valor se convierte
+ *   directamente al formato final (enteros escalados, sin float ni strtod).
+ * - Las oraciones que no son RMC/GGA/VTG solo se recorren para el checksum;
+ *   sus campos no se interpretan.
+ * - Los valores de una oración quedan pendientes y se copian a GpsFix solo
+ *   si el checksum coincide, igual que el commit() de TinyGPSPlus.
+ *
+ * Se acepta cualquier emisor ($GP, $GN, $GL, $GA, $BD...). Este encabezado no
+ * depende de Arduino para poder medirlo en el PC (tools/bench_nmea.cpp).
+ */
+
+#ifndef NMEA_PARSER_H
+#define NMEA_PARSER_H
+
+#include <stdint.h>
+#include "gps_fix.h"
+
+/**
+ * @class NmeaParser
+ * @brief Tokenizador NMEA carácter por carácter
+ */
+class NmeaParser {
+public:
+  NmeaParser();
+
+  /**
+   * @brief Procesa un carácter del receptor
+   *
+   * @param c Carácter recibido
+   * @return true Si completó una oración RMC/GGA/VTG con checksum válido
+   */
+  bool encode(char c);
+
+  /** @brief Último fix (valores con checksum válido) */
+  const GpsFix &fix() const { return fix_; }
+
+  /** @brief La última oración aceptada cierra una época de navegación (RMC) */
+  bool epoch() const { return epoch_; }
+
+  uint32_t passedChecksum() const { return passed_; }  ///< Oraciones con checksum válido
+  uint32_t failedChecksum() const { return failed_; }  ///< Oraciones descartadas por checksum
+
+private:
+  enum Sentence : uint8_t { S_OTHER, S_RMC, S_GGA, S_VTG };
+
+  void beginField();
+  void endField();
+  void commit();
+  uint32_t scaled(int decimals) const;
+  int32_t coordE7() const;
+
+  // Oración en curso
+  bool inSentence_;
+  bool inChecksum_;
+  uint8_t cs_;                           ///< XOR de los caracteres entre '$' y '*'
+  uint8_t csRecv_;                       ///< Checksum recibido
+  uint8_t csDigits_;
+  uint8_t field_;                        ///< Índice del campo en curso (0 = dirección)
+  Sentence type_;
+  uint32_t tag_;                         ///< Últimos 3 caracteres del campo de dirección
+
+  // Campo en curso
+  uint32_t acc_;                         ///< Dígitos acumulados (sin punto decimal)
+  int8_t frac_;                          ///< Decimales acumulados (-1 = sin punto)
+  uint8_t len_;                          ///< Caracteres del campo
+  char first_;                           ///< Primer carácter (indicadores N/S/E/W/A/V...)
+  bool neg_;
+  bool bad_;                             ///< Carácter inesperado o desbordamiento
+
+  // Valores pendientes hasta validar el checksum
+  GpsFix pend_;
+  uint16_t pendSet_;                     ///< Campos presentes en la oración
+  bool active_;                          ///< RMC 'A', GGA con calidad > 0, VTG sin modo 'N'
+
+  GpsFix fix_;
+  bool epoch_;
+  uint32_t passed_;
+  uint32_t failed_;
+};
+
+#endif // NMEA_PARSER_H
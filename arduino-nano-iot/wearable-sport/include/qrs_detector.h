@@ -0,0 +1,60 @@
+/**
+ * @file qrs_detector.h
+ * @brief Detector de complejos QRS en línea (Pan-Tompkins)
+ * @authors Juan Perez, Ana Gomez
+ * @date 2025
+ *
+ * @details Opera muestra a muestra sobre la señal ya filtrada por
+ * filterSample(), con costo O(1) y memoria fija:
+ * derivada de 5 puntos -> cuadrado -> integración en ventana móvil de
+ * 150 ms -> detección de picos -> umbrales adaptativos duales (señal
+ * integrada y señal filtrada) con búsqueda hacia atrás (search-back) y
+ * discriminación de ondas T. Todas las ventanas se derivan de SAMPLE_RATE.
+ */
+
+#ifndef QRS_DETECTOR_H
+#define QRS_DETECTOR_H
+
+#include <stdint.h>
+#include "config.h"
+
+/**
+ * @struct QrsBeat
+ * @brief Latido reportado por el detector
+ */
+struct QrsBeat {
+  uint32_t sample;                       ///< Índice de la muestra del pico R (señal filtrada)
+  uint32_t rrMs;                         ///< Intervalo RR respecto al latido anterior (0 si es el primero)
+  bool searchBack;                       ///< true si se recuperó por búsqueda hacia atrás
+};
+
+/**
+ * @struct QrsStats
+ * @brief Contadores del detector
+ */
+struct QrsStats {
+  uint32_t beats;                        ///< Latidos detectados
+  uint32_t searchBacks;                  ///< Latidos recuperados por search-back
+  uint32_t tWaves;                       ///< Picos descartados como onda T
+};
+
+extern QrsStats qrsStats;                ///< Contadores del detector
+
+/**
+ * @brief Reinicia el detector (fase de aprendizaje de 2 s incluida)
+ */
+void qrsReset();
+
+/**
+ * @brief Procesa una muestra filtrada
+ *
+ * La detección se confirma con un retardo de unos cientos de ms tras el
+ * pico R; beat->sample indica dónde ocurrió el pico.
+ *
+ * @param x Muestra filtrada (cuentas del ADC)
+ * @param beat Latido detectado (solo válido si retorna true)
+ * @return true Si se confirmó un latido en esta muestra
+ */
+bool qrsProcess(float x, QrsBeat *beat);
+
+#endif // QRS_DETECTOR_H
@@ -0,0 +1,103 @@
+/**
+ * @file rolling.h
+ * @brief Ventanas deslizantes de carga (1, 5 y 10 min) y pico de 5 min, en O(1) por segundo
+ * @authors Juan Perez, Ana Gomez
+ * @date 2025
+ *
+ * @details Los acumuladores del minuto se reinician cada 60 s, así que no
+ * hay vista continua. Este módulo guarda un bin por segundo en un buffer
+ * circular de ROLL_SECONDS (distancia, distancia a alta velocidad y zona
+ * de FC del segundo) y mantiene sumas enteras de cada ventana: al cerrar
+ * un segundo se suma el bin nuevo y se resta el que sale de cada ventana.
+ * Las sumas son enteras (0.1 m y TRIMP × 60000), así que no acumulan
+ * error de redondeo en sesiones largas.
+ *
+ * - Distancia a alta velocidad: la de las zonas de velocidad desde
+ *   ROLL_HS_ZONE (por omisión correr y sprint).
+ * - TRIMP: el peso de la zona de FC de cada segundo / 60, igual que
+ *   tareaSegundo().
+ * - Picos: máximo de la distancia y del TRIMP de 5 min (ventana llena)
+ *   en la sesión; es la métrica de intensidad de partido.
+ * - Agudo:crónico: carga por minuto de la ventana de 1 min respecto a la
+ *   de 10 min (> 1 = el último minuto está por encima de la media reciente).
+ *   El cociente de días (7/28) se calcula fuera, con los registros.
+ *
+ * Memoria: 5 B por segundo (3000 B para 10 min) más ~100 B de sumas.
+ */
+
+#ifndef ROLLING_H
+#define ROLLING_H
+
+#include <stdint.h>
+#include "config.h"
+
+/** @brief Ventanas */
+enum RollWindow {
+  ROLL_1MIN = 0,                         ///< 60 s
+  ROLL_5MIN = 1,                         ///< 300 s
+  ROLL_10MIN = 2,                        ///< 600 s (ROLL_SECONDS)
+  ROLL_WINDOWS = 3
+};
+
+/**
+ * @struct RollingTotals
+ * @brief Sumas de una ventana
+ */
+struct RollingTotals {
+  float distM;                           ///< Distancia (m)
+  float hsDistM;                         ///< Distancia a alta velocidad (m)
+  float trimp;                           ///< TRIMP
+  uint16_t secInHZ[6];                   ///< Segundos en cada zona de FC
+  uint16_t seconds;                      ///< Segundos cubiertos (menos que la ventana al inicio)
+};
+
+/**
+ * @struct RollingPeaks
+ * @brief Máximos de la sesión de las ventanas de 5 min llenas
+ */
+struct RollingPeaks {
+  float dist5M;                          ///< Distancia máxima en 5 min (m)
+  float hsDist5M;                        ///< Distancia a alta velocidad máxima en 5 min (m)
+  float trimp5;                          ///< TRIMP máximo en 5 min
+};
+
+/**
+ * @brief Vacía las ventanas y fija los pesos de TRIMP (los del perfil del atleta)
+ *
+ * @param trimpW Peso por zona de FC
+ */
+void rollingBegin(const float trimpW[6]);
+
+/**
+ * @brief Suma distancia al segundo en curso
+ *
+ * @param d_m Distancia (m)
+ * @param vz Zona de velocidad del intervalo
+ */
+void rollingAddDistance(float d_m, int vz);
+
+/**
+ * @brief Cierra el segundo en curso y desliza las ventanas
+ *
+ * @param hz Zona de FC del segundo
+ */
+void rollingSecond(int hz);
+
+/**
+ * @brief Sumas de una ventana
+ */
+RollingTotals rollingTotals(RollWindow w);
+
+/**
+ * @brief Picos de 5 min de la sesión
+ */
+RollingPeaks rollingPeaks();
+
+/**
+ * @brief Carga (TRIMP) por minuto de la ventana de 1 min respecto a la de 10 min
+ *
+ * @return float Cociente (0 sin carga en 10 min)
+ */
+float rollingAcuteChronic();
+
+#endif // ROLLING_H
@@ -0,0 +1,105 @@
+/**
+ * @file scheduler.h
+ * @brief Planificador de tareas por prioridad con medición de jitter
+ * @authors Juan Perez, Ana Gomez
+ * @date 2025
+ *
+ * @details TC4 genera un tick cada SCHED_TICK_US. En cada tick se liberan
+ * las tareas periódicas que vencieron:
+ * - SCHED_ISR: se ejecutan dentro de la interrupción (TC4 tiene la menor
+ *   prioridad del NVIC, así que SysTick, DMA, USB y UART la interrumpen).
+ *   Deben ser cortas y no usar Serial ni la SD.
+ * - SCHED_DEFERRED: quedan pendientes y las ejecuta schedRun() desde loop(),
+ *   siempre la de mayor prioridad primero.
+ *
+ * Una tarea de periodo 0 no es periódica: la libera schedRelease(), por
+ * ejemplo desde la interrupción de fin de bloque del DMA.
+ *
+ * Para cada tarea se registra el jitter de liberación (inicio real menos
+ * momento nominal de liberación) y el tiempo de ejecución, máximos y
+ * promedios, además de las liberaciones perdidas porque la anterior
+ * seguía pendiente.
+ */
+
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <Arduino.h>
+#include <stdint.h>
+#include "config.h"
+
+// ==================== TIPOS ====================
+
+/** @brief Contexto de ejecución de una tarea */
+enum SchedMode {
+  SCHED_ISR = 0,                         ///< Dentro de la interrupción del tick
+  SCHED_DEFERRED = 1                     ///< Desde loop() vía schedRun()
+};
+
+/** @brief Función de una tarea */
+typedef void (*TaskFn)();
+
+/**
+ * @struct TaskStats
+ * @brief Estadísticas de temporización de una tarea
+ */
+struct TaskStats {
+  uint32_t runs;                         ///< Ejecuciones
+  uint32_t missed;                       ///< Liberaciones perdidas (la anterior seguía pendiente)
+  uint32_t jitterMaxUs;                  ///< Peor retardo de inicio (us)
+  uint32_t jitterSumUs;                  ///< Suma de retardos de inicio (us)
+  uint32_t execMaxUs;                    ///< Peor tiempo de ejecución (us)
+  uint32_t execSumUs;                    ///< Suma de tiempos de ejecución (us)
+};
+
+// ==================== INTERFAZ ====================
+
+/**
+ * @brief Registra una tarea
+ *
+ * @param name Nombre para el reporte
+ * @param fn Función de la tarea
+ * @param periodUs Periodo (múltiplo de SCHED_TICK_US), o 0 si la libera schedRelease()
+ * @param mode SCHED_ISR o SCHED_DEFERRED
+ * @param prio Prioridad (0 = la más alta)
+ * @return int Identificador de la tarea, o -1 si no hay espacio
+ */
+int schedAdd(const char *name, TaskFn fn, uint32_t periodUs, SchedMode mode, uint8_t prio);
+
+/**
+ * @brief Inicia el tick; la primera liberación de cada tarea es un periodo después
+ */
+void schedBegin();
+
+/**
+ * @brief Libera una tarea de periodo 0 (seguro en interrupciones)
+ *
+ * @param id Identificador de la tarea
+ */
+void schedRelease(int id);
+
+/**
+ * @brief Ejecuta las tareas diferidas pendientes por orden de prioridad
+ *
+ * Se llama en cada pasada de loop().
+ */
+void schedRun();
+
+/**
+ * @brief Lee y reinicia las estadísticas de una tarea
+ *
+ * @param k Posición por orden de prioridad (0 .. número de tareas - 1)
+ * @param name Nombre de la tarea
+ * @param st Estadísticas desde la lectura anterior
+ * @return false Si k no corresponde a una tarea
+ */
+bool schedTakeStats(int k, const char **name, TaskStats *st);
+
+/**
+ * @brief Imprime las estadísticas de todas las tareas y las reinicia
+ *
+ * @param out Destino (Serial, archivo, ...)
+ */
+void schedPrintStats(Print &out);
+
+#endif // SCHEDULER_H
@@ -8,25 +8,24 @@
 #ifndef SD_CARD_H
 #define SD_CARD_H
 
+#include "hrv.h"
+#include "metrics.h"
+
 /**
- * @brief Crea el archivo CSV con encabezados si no existe
+ * @brief Abre el archivo CSV y escribe los encabezados si está vacío
  * 
- * Crea el archivo CSV en la tarjeta SD e inserta la línea de encabezados
- * con los nombres de todas las columnas.
+ * El archivo queda abierto en sdLog (sd_logger.h) durante toda la sesión.
+ * Un CSV_FILENAME con otro encabezado no se toca: las filas van al primer
+ * datosNN.csv libre o con el encabezado actual.
  */
 void crearArchivoCSV();
 
 /**
- * @brief Guarda los datos del resumen del minuto en el archivo CSV
+ * @brief Agrega el resumen de un minuto cerrado al archivo CSV (a través de sdLog)
  * 
- * @param bpmMeanMin BPM promedio del minuto
- * @param vMeanMin Velocidad promedio del minuto (km/h)
- */
-void guardarDatosCSV(float bpmMeanMin, float vMeanMin);
-
-/**
- * @brief Reinicia todos los acumuladores del minuto actual
+ * @param m Acumuladores del minuto (ver minuteSwap() en metrics.h)
+ * @param hrv Métricas de HRV al cierre del minuto
  */
-void resetMinuteAccumulators();
+void guardarDatosCSV(const MinuteBank &m, const HrvMetrics &hrv);
 
 #endif // SD_CARD_H
@@ -0,0 +1,111 @@
+/**
+ * @file sd_logger.h
+ * @brief Registro en SD con buffer en RAM y escrituras de sectores completos
+ * @authors Juan Perez, Ana Gomez
+ * @date 2025
+ *
+ * @details Los registros se formatean con la interfaz Print en un buffer
+ * circular (SD_LOG_RING bytes para sdLog, SPRINT_LOG_RING para sprintLog);
+ * escribir en el buffer no toca la tarjeta.
+ * El archivo permanece abierto y service(), llamada desde una tarea
+ * diferida, escribe solo sectores completos de 512 bytes alineados con el
+ * archivo (la biblioteca SD los pasa directo a la tarjeta sin usar su
+ * caché). Cada SD_LOG_FLUSH_MS se escribe el resto parcial y se sincroniza
+ * el directorio (tamaño del archivo), que es la operación costosa de FAT.
+ *
+ * Si el buffer se llena, los bytes nuevos se descartan y se cuentan. Si la
+ * tarjeta acepta menos bytes de los pedidos, el archivo se cierra: seguir
+ * escribiendo dejaría un hueco entre lo que está en la tarjeta y el buffer.
+ */
+
+#ifndef SD_LOGGER_H
+#define SD_LOGGER_H
+
+#include <Arduino.h>
+#include <SD.h>
+#include <stdint.h>
+#include "config.h"
+
+static_assert(SD_LOG_RING % 512 == 0, "SD_LOG_RING debe ser múltiplo de 512");
+static_assert(SPRINT_LOG_RING % 512 == 0, "SPRINT_LOG_RING debe ser múltiplo de 512");
+
+/**
+ * @struct SdLogStats
+ * @brief Contadores y latencias del registro
+ */
+struct SdLogStats {
+  uint32_t bytes;                        ///< Bytes escritos en la tarjeta
+  uint32_t sectors;                      ///< Escrituras de sector completo
+  uint32_t flushes;                      ///< Sincronizaciones
+  uint32_t dropped;                      ///< Bytes descartados por buffer lleno o error de escritura
+  uint32_t errors;                       ///< Escrituras fallidas (la primera cierra el registro)
+  uint32_t writeMaxUs;                   ///< Peor latencia de escritura de un sector (us)
+  uint32_t flushMaxUs;                   ///< Peor latencia de sincronización (us)
+};
+
+/**
+ * @class SdLogger
+ * @brief Archivo de registro abierto permanentemente con buffer circular
+ */
+class SdLogger : public Print {
+public:
+  /**
+   * @param ring Buffer circular del registro (estático, lo usa durante toda la ejecución)
+   * @param ringSize Bytes del buffer (múltiplo de 512)
+   */
+  SdLogger(uint8_t *ring, uint32_t ringSize) : ring_(ring), ringSize_(ringSize) {}
+
+  /**
+   * @brief Abre (o crea) el archivo para agregar al final
+   *
+   * @param path Nombre del archivo
+   * @return true Si el archivo quedó abierto
+   */
+  bool begin(const char *path);
+
+  size_t write(uint8_t c) override;
+  size_t write(const uint8_t *buf, size_t n) override;
+  using Print::write;
+
+  /**
+   * @brief Escribe los sectores completos pendientes y sincroniza si corresponde
+   *
+   * @param nowMs Tiempo actual en ms
+   */
+  void service(uint32_t nowMs);
+
+  /**
+   * @brief Escribe todo lo pendiente (incluido el sector parcial) y sincroniza
+   */
+  void flush() override;
+
+  /** @brief Bytes del archivo (escritos más pendientes) */
+  uint32_t size() const { return head_; }
+
+  /** @brief Bytes pendientes en el buffer */
+  uint32_t pending() const { return head_ - tail_; }
+
+  /**
+   * @brief Copia las estadísticas y reinicia las latencias máximas
+   */
+  SdLogStats takeStats();
+
+  operator bool() const { return open_; }
+
+private:
+  void writeChunk(uint32_t n);
+
+  File file_;
+  bool open_ = false;
+  uint8_t *const ring_;
+  const uint32_t ringSize_;
+  uint32_t head_ = 0;                    ///< Desplazamiento en el archivo del siguiente byte a formatear
+  uint32_t tail_ = 0;                    ///< Desplazamiento en el archivo del siguiente byte a escribir
+  uint32_t lastFlushMs_ = 0;
+  SdLogStats st_ = {0, 0, 0, 0, 0, 0, 0};
+};
+
+extern SdLogger sdLog;                   ///< Registro de resúmenes (CSV_FILENAME o LOG_BIN_FILENAME)
+extern SdLogger sprintLog;               ///< Registro de sprints (SPRINT_LOG_FILENAME)
+
+#endif // SD_LOGGER_H
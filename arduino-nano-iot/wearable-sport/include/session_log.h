@@ -0,0 +1,249 @@
+/**
+ * @file session_log.h
+ * @brief Formato binario del registro de sesión y su escritura en SD
+ * @authors Juan Perez, Ana Gomez
+ * @date 2025
+ *
+ * @details Alternativa compacta al CSV (LOG_FORMAT == LOG_BIN). El archivo
+ * empieza con un SessionLogHeader y sigue una secuencia de registros de
+ * tamaño fijo por tipo. Cada registro empieza con un RecordPrefix (byte de
+ * sincronía, tipo y longitud total) y termina con un CRC-16/CCITT de todos
+ * sus bytes anteriores, así que un lector puede saltar tipos desconocidos y
+ * resincronizarse tras un registro dañado.
+ *
+ * Los valores se guardan como enteros escalados (ver MinuteRecord): no hay
+ * conversión de float a texto en el M0+ y cada fila ocupa ~60 bytes en lugar
+ * de ~150. La herramienta tools/bin2csv.cpp convierte el archivo a CSV
+ * (mismas columnas que guardarDatosCSV) o JSON.
+ *
+ * Los sprints van en su propio archivo (SPRINT_LOG_FILENAME): el mismo
+ * encabezado con magic "WSSP" y un SprintRecord por sprint terminado, en el
+ * momento en que termina (no al cierre del minuto). bin2csv también lo lee.
+ *
+ * Este encabezado no depende de Arduino para poder usarse desde el PC.
+ * Todos los campos son little-endian (igual en el M0+ y en x86/ARM).
+ */
+
+#ifndef SESSION_LOG_H
+#define SESSION_LOG_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "hrv.h"
+#include "motion.h"
+#include "sprint.h"
+
+// ==================== FORMATO ====================
+
+/** @brief Versión del formato; cambia con cualquier cambio de estructura */
+#define SESSION_LOG_VERSION 1
+
+/** @brief Byte de sincronía al inicio de cada registro */
+#define SESSION_LOG_SYNC    0xA5
+
+/** @brief Tipos de registro */
+enum RecordType {
+  REC_MINUTE = 1,                        ///< Resumen de un minuto (MinuteRecord)
+  REC_MOTION = 2,                        ///< Movimiento del mismo minuto (MotionRecord), si hay IMU
+  REC_SPRINT = 3                         ///< Un sprint (SprintRecord), en el archivo de sprints
+};
+
+/**
+ * @struct SessionLogHeader
+ * @brief Encabezado al inicio del archivo
+ */
+struct __attribute__((packed)) SessionLogHeader {
+  char magic[4];                         ///< "WSLG" (sesión) o "WSSP" (sprints)
+  uint16_t version;                      ///< SESSION_LOG_VERSION
+  uint16_t headerSize;                   ///< sizeof(SessionLogHeader)
+  int8_t utcOffsetH;                     ///< UTC_OFFSET_H del firmware que escribió el archivo
+  uint8_t reserved[5];
+  uint16_t crc;                          ///< CRC-16 de los bytes anteriores
+};
+
+/**
+ * @struct RecordPrefix
+ * @brief Inicio común de todos los registros
+ */
+struct __attribute__((packed)) RecordPrefix {
+  uint8_t sync;                          ///< SESSION_LOG_SYNC
+  uint8_t type;                          ///< RecordType
+  uint8_t len;                           ///< Bytes del registro completo (prefijo y CRC incluidos)
+};
+
+/**
+ * @struct MinuteRecord
+ * @brief Resumen de un minuto: los mismos campos que la fila del CSV
+ */
+struct __attribute__((packed)) MinuteRecord {
+  RecordPrefix pre;
+  uint32_t seq;                          ///< Número de registro desde el arranque
+  uint32_t millisMs;                     ///< millis() al cierre del minuto
+  uint32_t utcDate;                      ///< AAAAMMDD del GPS (0 = sin fecha/hora válida)
+  uint32_t utcTime;                      ///< HHMMSS del GPS
+  uint16_t distMinuteDm;                 ///< Distancia del minuto (0.1 m)
+  uint32_t distTotalDm;                  ///< Distancia total (0.1 m)
+  uint16_t vMean;                        ///< Velocidad promedio (0.01 km/h)
+  uint16_t vMax;                         ///< Velocidad máxima (0.01 km/h)
+  uint16_t bpmMean;                      ///< BPM promedio (0.1 bpm)
+  uint8_t secVZ[4];                      ///< Segundos en cada zona de velocidad
+  uint16_t distVZ[4];                    ///< Metros en cada zona de velocidad
+  uint8_t secHZ[6];                      ///< Segundos en cada zona de FC
+  uint16_t trimp;                        ///< TRIMP del minuto (0.01)
+  uint8_t sprintsMin;                    ///< Sprints del minuto
+  uint16_t sprintsTotal;                 ///< Sprints acumulados
+  uint16_t rmssd;                        ///< RMSSD (0.1 ms)
+  uint16_t sdnn;                         ///< SDNN (0.1 ms)
+  uint16_t pnn50;                        ///< pNN50 (0.1 %)
+  uint16_t crc;                          ///< CRC-16 de los bytes anteriores
+};
+
+/**
+ * @struct MotionRecord
+ * @brief Pasos, cadencia e impactos de un minuto (sigue a su MinuteRecord)
+ */
+struct __attribute__((packed)) MotionRecord {
+  RecordPrefix pre;
+  uint32_t seq;                          ///< seq del MinuteRecord al que acompaña
+  uint16_t steps;                        ///< Pasos del minuto
+  uint16_t cadence;                      ///< Cadencia (0.1 pasos/min)
+  uint16_t impacts;                      ///< Impactos sobre IMU_IMPACT_G
+  uint16_t peakMg;                       ///< Aceleración total máxima (mg)
+  uint16_t fifoOverruns;                 ///< Desbordamientos de la FIFO del acelerómetro
+  uint16_t crc;                          ///< CRC-16 de los bytes anteriores
+};
+
+/**
+ * @struct SprintRecord
+ * @brief Un sprint: inicio, duración, distancia y picos
+ */
+struct __attribute__((packed)) SprintRecord {
+  RecordPrefix pre;
+  uint32_t seq;                          ///< Número de sprint desde el arranque
+  uint32_t startMillis;                  ///< millis() del inicio (misma base que MinuteRecord.millisMs)
+  uint32_t utcDate;                      ///< AAAAMMDD del GPS (0 = sin fecha/hora válida)
+  uint32_t utcStartMs;                   ///< Hora UTC del inicio (ms desde las 00:00)
+  uint32_t durationMs;                   ///< Duración (ms)
+  uint16_t distDm;                       ///< Distancia (0.1 m)
+  uint16_t vPeak;                        ///< Velocidad máxima (0.01 km/h)
+  int16_t aPeak;                         ///< Aceleración máxima (0.01 m/s²)
+  uint16_t crc;                          ///< CRC-16 de los bytes anteriores
+};
+
+static_assert(sizeof(SessionLogHeader) == 16, "SessionLogHeader debe ocupar 16 bytes");
+static_assert(sizeof(MinuteRecord) < 256, "RecordPrefix.len es de 8 bits");
+
+/**
+ * @brief CRC-16/CCITT-FALSE (polinomio 0x1021, valor inicial 0xFFFF)
+ *
+ * @param data Bytes a verificar
+ * @param n Número de bytes
+ * @return uint16_t CRC
+ */
+static inline uint16_t crc16Ccitt(const void *data, size_t n) {
+  const uint8_t *p = (const uint8_t *)data;
+  uint16_t crc = 0xFFFF;
+  while (n--) {
+    crc ^= (uint16_t)(*p++) << 8;
+    for (int i = 0; i < 8; i++) {
+      crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+    }
+  }
+  return crc;
+}
+
+// ==================== ESCALA ====================
+
+/** @brief Escala, redondea y satura a 16 bits sin signo */
+static inline uint16_t toU16(float v, float scale) {
+  float x = v * scale + 0.5f;
+  if (!(x > 0)) return 0;
+  return x >= 65535.0f ? 65535 : (uint16_t)x;
+}
+
+/** @brief Escala, redondea y satura a 32 bits sin signo */
+static inline uint32_t toU32(float v, float scale) {
+  float x = v * scale + 0.5f;
+  if (!(x > 0)) return 0;
+  return x >= 4294967040.0f ? 0xFFFFFFFFUL : (uint32_t)x;
+}
+
+/** @brief Escala, redondea y satura a 16 bits con signo */
+static inline int16_t toI16(float v, float scale) {
+  float x = v * scale;
+  if (x >= 32767.0f) return 32767;
+  if (x <= -32767.0f) return -32767;
+  return (int16_t)(x < 0 ? x - 0.5f : x + 0.5f);
+}
+
+/** @brief Trunca (como el (int) del CSV) y satura a 8 bits sin signo */
+static inline uint8_t truncU8(float v) {
+  if (!(v > 0)) return 0;
+  return v >= 255.0f ? 255 : (uint8_t)v;
+}
+
+/** @brief Trunca (como el (int) del CSV) y satura a 16 bits sin signo */
+static inline uint16_t truncU16(float v) {
+  if (!(v > 0)) return 0;
+  return v >= 65535.0f ? 65535 : (uint16_t)v;
+}
+
+// ==================== ESCRITURA (FIRMWARE) ====================
+
+/**
+ * @brief Abre el archivo binario y escribe el encabezado si está vacío
+ *
+ * Si el archivo existe con otra versión del formato no se registra nada,
+ * para no mezclar formatos en un mismo archivo.
+ */
+void sessionLogBegin();
+
+struct MinuteBank;
+
+/**
+ * @brief Arma el registro de un minuto cerrado
+ *
+ * @param m Acumuladores del minuto (ver minuteSwap() en metrics.h)
+ * @param hrv Métricas de HRV al cierre del minuto
+ * @param out Registro (con CRC)
+ */
+void sessionMinuteRecord(const MinuteBank &m, const HrvMetrics &hrv, MinuteRecord *out);
+
+/**
+ * @brief Arma el registro de movimiento que acompaña a un MinuteRecord
+ *
+ * @param seq seq del MinuteRecord
+ * @param motion Movimiento del minuto
+ * @param out Registro (con CRC)
+ */
+void sessionMotionRecord(uint32_t seq, const MotionMinute &motion, MotionRecord *out);
+
+/**
+ * @brief Agrega el registro del minuto (a través de sdLog)
+ *
+ * @param r Registro del minuto
+ * @param m Movimiento del minuto (nullptr sin IMU: no se escribe MotionRecord)
+ */
+void sessionLogMinute(const MinuteRecord &r, const MotionRecord *m);
+
+/**
+ * @brief Abre el archivo de sprints (en ambos formatos de registro)
+ */
+void sprintLogBegin();
+
+/**
+ * @brief Arma el registro de un sprint terminado
+ *
+ * @param e Sprint (ver sprintTakeEvent())
+ * @param out Registro (con CRC)
+ */
+void sessionSprintRecord(const SprintEvent &e, SprintRecord *out);
+
+/**
+ * @brief Agrega el registro de un sprint (a través de sprintLog)
+ *
+ * @param r Registro del sprint
+ */
+void sessionLogSprint(const SprintRecord &r);
+
+#endif // SESSION_LOG_H
@@ -0,0 +1,72 @@
+/**
+ * @file speed_kalman.h
+ * @brief Filtro de Kalman de velocidad: acelerómetro a alta tasa corregido con el GPS
+ * @authors Juan Perez, Ana Gomez
+ * @date 2025
+ *
+ * @details El promedio móvil de 5 épocas GPS retrasa la velocidad varios
+ * segundos y aplana los sprints. Este filtro integra la aceleración de
+ * avance a IMU_RATE_HZ y usa cada velocidad Doppler del GPS como medición.
+ *
+ * Estado x = [v, b]: velocidad de avance (m/s) y sesgo del acelerómetro en
+ * el eje de avance (m/s²), que absorbe la proyección de la gravedad por la
+ * inclinación del tronco y el offset del sensor.
+ *
+ *   Predicción:  v += (a - b)·dt        Q = diag(σa²·dt², σb²·dt)
+ *   Medición:    z = v_GPS,  H = [1 0], R = σgps²
+ *
+ * Tamaño fijo (2 estados, covarianza simétrica de 3 términos), sin memoria
+ * dinámica ni matrices genéricas: ~12 operaciones float por muestra y ~10
+ * por medición. No depende de Arduino para poder reproducirlo en el PC.
+ */
+
+#ifndef SPEED_KALMAN_H
+#define SPEED_KALMAN_H
+
+/**
+ * @class SpeedKalman
+ * @brief Kalman de 2 estados (velocidad, sesgo de aceleración)
+ */
+class SpeedKalman {
+public:
+  /**
+   * @param accSigma Ruido de proceso de la aceleración (m/s²)
+   * @param biasSigma Deriva del sesgo (m/s² por √s)
+   */
+  SpeedKalman(float accSigma, float biasSigma);
+
+  /**
+   * @brief Reinicia el estado (primer GPS o tras un hueco)
+   *
+   * @param v Velocidad inicial (m/s)
+   * @param bias Sesgo inicial: la aceleración medida en ese momento (m/s²)
+   */
+  void reset(float v, float bias);
+
+  /**
+   * @brief Propaga el estado con una muestra del acelerómetro
+   *
+   * @param a Aceleración en el eje de avance (m/s²)
+   * @param dt Periodo de muestreo (s)
+   */
+  void predict(float a, float dt);
+
+  /**
+   * @brief Corrige con una velocidad del GPS
+   *
+   * @param v Velocidad medida (m/s)
+   * @param var Varianza de la medición (m²/s²)
+   */
+  void update(float v, float var);
+
+  float speed() const { return v_; }     ///< Velocidad estimada (m/s, nunca negativa)
+  float bias() const { return b_; }      ///< Sesgo estimado (m/s²)
+  float speedVar() const { return p00_; } ///< Varianza de la velocidad (m²/s²)
+
+private:
+  float v_, b_;
+  float p00_, p01_, p11_;                ///< Covarianza (simétrica)
+  float qa_, qb_;                        ///< σa², σb²
+};
+
+#endif // SPEED_KALMAN_H
@@ -0,0 +1,82 @@
+/**
+ * @file sprint.h
+ * @brief Detección de sprints como eventos, a la tasa de la velocidad
+ * @authors Juan Perez, Ana Gomez
+ * @date 2025
+ *
+ * @details Recibe cada velocidad que integra integrateSpeed() (por época
+ * GPS o por muestra del acelerómetro con SPEED_KALMAN) y la trata como una
+ * máquina de estados con histéresis:
+ *
+ * - Inicio: la velocidad cruza SPRINT_KMH hacia arriba. El instante del
+ *   cruce se interpola entre la muestra anterior y la actual, así que a
+ *   1 Hz la resolución sigue siendo de fracciones de segundo.
+ * - Continúa mientras la velocidad no baje de SPRINT_EXIT_KMH (una caída
+ *   breve por debajo de SPRINT_KMH no parte el sprint en dos).
+ * - Fin: cruce interpolado hacia abajo de SPRINT_EXIT_KMH, o un hueco de
+ *   más de GPS_MAX_GAP_MS sin velocidades (se cierra en la última muestra).
+ * - Cuenta solo si duró al menos SPRINT_HOLD_MS; se suma a los sprints del
+ *   minuto y de la sesión (metrics.h) en cuanto se confirma, una sola vez.
+ *
+ * El estado no depende del minuto: un sprint que cruza el cierre del
+ * minuto se cuenta una vez (en el minuto en que se confirma) y su registro
+ * se emite al terminar.
+ *
+ * La aceleración se mide como dv/dt sobre ventanas de ~1 s (en modo
+ * Kalman la derivada muestra a muestra es ruido de zancada y saltos de
+ * corrección). El pico incluye la fase de aceleración previa al cruce: la
+ * arrancada suele ocurrir antes de llegar a la velocidad de sprint.
+ *
+ * Los sprints terminados quedan en una cola corta que vacía la tarea de SD
+ * (ver sessionLogSprint()). No depende de Arduino.
+ */
+
+#ifndef SPRINT_H
+#define SPRINT_H
+
+#include <stdint.h>
+
+/** @brief Sprints terminados que esperan a la tarea de SD */
+#define SPRINT_QUEUE 4
+
+/**
+ * @struct SprintEvent
+ * @brief Un sprint completo
+ */
+struct SprintEvent {
+  uint32_t startMs;                      ///< millis() del cruce de SPRINT_KMH
+  uint32_t durationMs;                   ///< Duración hasta el cruce de SPRINT_EXIT_KMH
+  float distM;                           ///< Distancia recorrida en el sprint (m)
+  float vPeakKmh;                        ///< Velocidad máxima (km/h)
+  float aPeakMs2;                        ///< Aceleración máxima, incluida la arrancada (m/s²)
+};
+
+/**
+ * @brief Descarta el sprint en curso y la cola
+ */
+void sprintReset();
+
+/**
+ * @brief Procesa una velocidad
+ *
+ * @param v_kmh Velocidad filtrada (km/h)
+ * @param dtMs Intervalo desde la velocidad anterior (ms)
+ * @param nowMs millis() de la muestra: sella el inicio y detecta huecos
+ * @return true Si con esta muestra se confirmó un sprint nuevo
+ */
+bool sprintStep(float v_kmh, uint32_t dtMs, uint32_t nowMs);
+
+/**
+ * @brief Saca el sprint terminado más antiguo de la cola
+ *
+ * @param ev Destino
+ * @return true Si había uno
+ */
+bool sprintTakeEvent(SprintEvent *ev);
+
+/**
+ * @brief Sprints perdidos por cola llena desde la última llamada
+ */
+uint16_t sprintTakeDropped();
+
+#endif // SPRINT_H
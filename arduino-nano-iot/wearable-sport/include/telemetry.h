@@ -0,0 +1,235 @@
+/**
+ * @file telemetry.h
+ * @brief Telemetría binaria por Serial: registros de tamaño fijo en tramas COBS
+ * @authors Juan Perez, Ana Gomez
+ * @date 2025
+ *
+ * @details Con TELEMETRY == TELEM_BIN los resúmenes de texto se reemplazan
+ * por registros con el mismo formato que el registro de sesión
+ * (session_log.h: RecordPrefix, campos enteros escalados y CRC-16 al
+ * final). Cada registro se codifica con COBS, que elimina los bytes 0, y
+ * se envía entre dos delimitadores 0x00:
+ *
+ *   00 | COBS(registro) | 00
+ *
+ * El delimitador inicial separa la trama de cualquier texto previo (los
+ * mensajes de arranque y de error siguen siendo texto), así que un lector
+ * se sincroniza en el primer 0x00 y nunca mezcla texto con una trama.
+ * tools/telem2txt.cpp decodifica el flujo y lo muestra igual que la salida
+ * de texto.
+ *
+ * Registros por nivel (TELEM_LEVEL):
+ * - 0: MinuteRecord y MotionRecord cada minuto, SprintRecord por sprint.
+ * - 1: además StateRecord a TELEM_STATE_HZ y RollingRecord cada minuto.
+ * - 2: además DiagRecord y un TaskRecord por tarea cada minuto.
+ *
+ * El resumen del minuto ocupa ~60 B en lugar de ~1500 B de texto y no
+ * formatea ningún float en el M0+.
+ *
+ * Este encabezado no depende de Arduino para poder usarse desde el PC.
+ */
+
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "session_log.h"
+
+// ==================== FORMATO ====================
+
+/** @brief Tipos de registro exclusivos de la telemetría (siguen a los de RecordType) */
+enum TelemRecordType {
+  REC_STATE = 4,                         ///< Estado cada 1/TELEM_STATE_HZ s (StateRecord)
+  REC_ROLLING = 5,                       ///< Ventanas deslizantes del minuto (RollingRecord)
+  REC_DIAG = 6,                          ///< Contadores de distancia, SD y ECG (DiagRecord)
+  REC_TASK = 7                           ///< Estadísticas de una tarea (TaskRecord)
+};
+
+/**
+ * @struct StateRecord
+ * @brief Posición, hora, velocidad y BPM actuales
+ */
+struct __attribute__((packed)) StateRecord {
+  RecordPrefix pre;
+  uint32_t millisMs;                     ///< millis() al enviar
+  uint32_t utcDate;                      ///< AAAAMMDD del GPS (0 = sin fecha/hora válida)
+  uint32_t utcTimeMs;                    ///< Hora UTC (ms desde las 00:00)
+  int32_t latE7;                         ///< Latitud (1e-7 grados)
+  int32_t lonE7;                         ///< Longitud (1e-7 grados)
+  int32_t altCm;                         ///< Altitud (cm)
+  uint16_t speed;                        ///< Última velocidad válida (0.01 km/h)
+  uint16_t hdop;                         ///< HDOP (0.01)
+  uint16_t bpm;                          ///< BPM promedio (0.1 bpm; 0 = sin latidos)
+  uint8_t sats;                          ///< Satélites en uso
+  uint8_t valid;                         ///< Campos con valor (GpsValid)
+  uint16_t crc;                          ///< CRC-16 de los bytes anteriores
+};
+
+/**
+ * @struct RollingRecord
+ * @brief Ventanas de 1, 5 y 10 min y picos de 5 min (ver rolling.h)
+ */
+struct __attribute__((packed)) RollingRecord {
+  RecordPrefix pre;
+  uint32_t seq;                          ///< seq del MinuteRecord al que acompaña
+  uint16_t distM[3];                     ///< Distancia por ventana (m)
+  uint16_t hsDistM[3];                   ///< Distancia a alta velocidad por ventana (m)
+  uint16_t trimp[3];                     ///< TRIMP por ventana (0.01)
+  uint16_t secHZ[3][6];                  ///< Segundos en cada zona de FC por ventana
+  uint16_t seconds[3];                   ///< Segundos cubiertos por ventana
+  uint16_t peakDist5M;                   ///< Distancia máxima en 5 min (m)
+  uint16_t peakHsDist5M;                 ///< Distancia a alta velocidad máxima en 5 min (m)
+  uint16_t peakTrimp5;                   ///< TRIMP máximo en 5 min (0.01)
+  uint16_t acuteChronic;                 ///< Cociente agudo:crónico (0.001)
+  uint16_t crc;                          ///< CRC-16 de los bytes anteriores
+};
+
+/**
+ * @struct DiagRecord
+ * @brief Contadores de diagnóstico del minuto
+ */
+struct __attribute__((packed)) DiagRecord {
+  RecordPrefix pre;
+  uint32_t seq;                          ///< seq del MinuteRecord al que acompaña
+  uint16_t dopplerDm;                    ///< Distancia por velocidad (0.1 m)
+  uint16_t positionDm;                   ///< Distancia por posiciones (0.1 m)
+  int16_t correctionDm;                  ///< Corrección aplicada (0.1 m)
+  uint16_t segments;                     ///< Tramos cerrados con corrección
+  uint16_t rejected;                     ///< Posiciones descartadas
+  uint16_t sprintsDropped;               ///< Sprints sin registrar (cola llena)
+  uint32_t gpsRxBytes;                   ///< Bytes recibidos del GPS
+  uint32_t gpsRxOverruns;                ///< Bytes del GPS perdidos (anillo desbordado)
+  uint16_t gpsRxMaxFill;                 ///< Mayor ocupación del anillo del GPS (B)
+  uint32_t sdBytes;                      ///< Bytes escritos en la SD
+  uint32_t sdSectors;                    ///< Sectores completos escritos
+  uint32_t sdPending;                    ///< Bytes pendientes en RAM
+  uint32_t sdDropped;                    ///< Bytes descartados
+  uint32_t sdWriteMaxUs;                 ///< Peor escritura de sector (us)
+  uint32_t sdFlushMaxUs;                 ///< Peor sincronización (us)
+  uint32_t ecgBlocks;                    ///< Bloques ECG procesados (0 sin ECG_ACQ_DMA)
+  uint32_t ecgOverruns;                  ///< Bloques ECG perdidos
+  uint32_t capSectors;                   ///< Sectores de captura ECG (0 sin ECG_CAPTURE)
+  uint32_t capDropped;                   ///< Sectores de captura descartados
+  uint32_t capErrors;                    ///< Escrituras de captura fallidas
+  uint32_t capWriteMaxUs;                ///< Peor escritura de captura (us)
+  uint8_t flags;                         ///< DiagFlags
+  uint16_t crc;                          ///< CRC-16 de los bytes anteriores
+};
+
+/** @brief Bits de DiagRecord.flags */
+enum DiagFlags {
+  DIAG_ECG_DMA = 1 << 0,                 ///< Adquisición ECG por DMA
+  DIAG_CAPTURE = 1 << 1,                 ///< Captura ECG compilada
+  DIAG_CAPTURE_ON = 1 << 2               ///< Captura ECG activa
+};
+
+/**
+ * @struct TaskRecord
+ * @brief Estadísticas de una tarea del planificador (ver scheduler.h)
+ */
+struct __attribute__((packed)) TaskRecord {
+  RecordPrefix pre;
+  uint32_t seq;                          ///< seq del MinuteRecord al que acompaña
+  char name[10];                         ///< Nombre (sin terminador si ocupa los 10)
+  uint32_t runs;                         ///< Ejecuciones
+  uint32_t missed;                       ///< Liberaciones perdidas
+  uint32_t jitterAvgUs;                  ///< Retardo de inicio promedio (us)
+  uint32_t jitterMaxUs;                  ///< Peor retardo de inicio (us)
+  uint32_t execAvgUs;                    ///< Ejecución promedio (us)
+  uint32_t execMaxUs;                    ///< Peor ejecución (us)
+  uint16_t crc;                          ///< CRC-16 de los bytes anteriores
+};
+
+/** @brief Registro más largo que puede viajar en una trama */
+#define TELEM_MAX_RECORD  254
+
+static_assert(sizeof(RollingRecord) <= TELEM_MAX_RECORD, "RollingRecord no cabe en una trama");
+static_assert(sizeof(DiagRecord) <= TELEM_MAX_RECORD, "DiagRecord no cabe en una trama");
+
+// ==================== COBS ====================
+
+/**
+ * @brief Codifica con COBS (sin el delimitador final)
+ *
+ * Para n <= 254 la salida ocupa n + 1 bytes y no contiene ceros.
+ *
+ * @param in Bytes de entrada
+ * @param n Número de bytes (<= 254)
+ * @param out Salida (al menos n + 1 bytes)
+ * @return size_t Bytes escritos
+ */
+static inline size_t cobsEncode(const uint8_t *in, size_t n, uint8_t *out) {
+  size_t code = 0;                       // Posición del byte de código del bloque actual
+  size_t o = 1;
+  for (size_t i = 0; i < n; i++) {
+    if (in[i] == 0) {
+      out[code] = (uint8_t)(o - code);
+      code = o++;
+    } else {
+      out[o++] = in[i];
+    }
+  }
+  out[code] = (uint8_t)(o - code);
+  return o;
+}
+
+/**
+ * @brief Decodifica una trama COBS (sin delimitadores)
+ *
+ * @param in Trama codificada
+ * @param n Bytes de la trama
+ * @param out Salida (al menos n bytes)
+ * @return size_t Bytes decodificados (0 si la trama es inválida)
+ */
+static inline size_t cobsDecode(const uint8_t *in, size_t n, uint8_t *out) {
+  size_t o = 0;
+  size_t i = 0;
+  while (i < n) {
+    uint8_t code = in[i++];
+    if (code == 0 || i + code - 1 > n) return 0;
+    for (uint8_t k = 1; k < code; k++) out[o++] = in[i++];
+    if (code < 0xFF && i < n) out[o++] = 0;
+  }
+  return o;
+}
+
+// ==================== ENVÍO (FIRMWARE) ====================
+
+/**
+ * @brief Envía un registro como trama COBS por Serial
+ *
+ * @param rec Registro completo (prefijo y CRC incluidos)
+ * @param n Bytes del registro (<= TELEM_MAX_RECORD)
+ */
+void telemetrySend(const void *rec, size_t n);
+
+/**
+ * @brief Envía el StateRecord con la última época GPS y el BPM actual
+ */
+void telemetryState();
+
+struct GpsDistanceStats;
+struct GpsUartStats;
+struct SdLogStats;
+struct CaptureStats;
+
+/**
+ * @brief Envía el resumen del minuto según TELEM_LEVEL
+ *
+ * Los contadores se leen (y reinician) en tareaMinuto() aunque el nivel no
+ * los envíe; las estadísticas del planificador se reinician aquí.
+ *
+ * @param r Registro del minuto
+ * @param m Movimiento del minuto (nullptr sin IMU)
+ * @param ds Contadores del motor de distancia
+ * @param sprintsLost Sprints sin registrar
+ * @param rx Contadores de la recepción del GPS
+ * @param sd Contadores del registro en SD
+ * @param cap Contadores de la captura ECG (nullptr sin ECG_CAPTURE)
+ */
+void telemetryMinute(const MinuteRecord &r, const MotionRecord *m,
+                     const GpsDistanceStats &ds, uint16_t sprintsLost,
+                     const GpsUartStats &rx, const SdLogStats &sd, const CaptureStats *cap);
+
+#endif // TELEMETRY_H
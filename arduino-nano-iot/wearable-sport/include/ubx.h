@@ -0,0 +1,190 @@
+/**
+ * @file ubx.h
+ * @brief Protocolo binario UBX de u-blox: configuración y NAV-PVT
+ * @authors Juan Perez, Ana Gomez
+ * @date 2025
+ *
+ * @details Modo de GPS de alta tasa (GPS_PROTOCOL == GPS_UBX). Al arrancar,
+ * ubxConfigure() deja el receptor en GPS_UBX_BAUD, GPS_RATE_HZ soluciones
+ * por segundo y solo mensajes NAV-PVT (100 B cada uno): a 10 Hz son
+ * 1000 B/s, ~26 % de 38400 baud, mientras que RMC+GGA en texto a 10 Hz ya
+ * no caben en 9600 baud.
+ *
+ * NAV-PVT trae en un solo mensaje posición, velocidad, rumbo, fecha/hora,
+ * satélites, PDOP, precisiones y el iTOW (ms de la semana GPS) de la
+ * solución, con el que se integra la velocidad sobre el intervalo real
+ * entre soluciones. Requiere un receptor u-blox 7 o posterior (NEO-M8N,
+ * SAM-M8Q, etc.); la configuración usa los mensajes CFG-PRT/RATE/MSG, que
+ * las series 8 y 9 siguen aceptando.
+ *
+ * UbxParser tiene la misma interfaz que NmeaParser y llena el mismo GpsFix.
+ */
+
+#ifndef UBX_H
+#define UBX_H
+
+#include <stdint.h>
+#include "gps_fix.h"
+
+// ==================== MENSAJES ====================
+
+#define UBX_SYNC1      0xB5
+#define UBX_SYNC2      0x62
+
+#define UBX_CLASS_NAV  0x01
+#define UBX_CLASS_ACK  0x05
+#define UBX_CLASS_CFG  0x06
+#define UBX_CLASS_MGA  0x13
+
+#define UBX_NAV_PVT    0x07
+#define UBX_ACK_NAK    0x00
+#define UBX_ACK_ACK    0x01
+#define UBX_CFG_PRT    0x00
+#define UBX_CFG_MSG    0x01
+#define UBX_CFG_RATE   0x08
+#define UBX_MGA_INI    0x40
+#define UBX_MGA_DBD    0x80
+
+/** @brief Carga útil máxima de un MGA-DBD que se conserva (los más largos se descartan) */
+#define UBX_DBD_MAX    164
+
+/**
+ * @struct UbxNavPvt
+ * @brief Carga útil de NAV-PVT (92 B, little-endian)
+ */
+struct __attribute__((packed)) UbxNavPvt {
+  uint32_t iTOW;                         ///< Tiempo de la semana GPS de la solución (ms)
+  uint16_t year;
+  uint8_t month, day, hour, min, sec;
+  uint8_t valid;                         ///< bit0 fecha válida, bit1 hora válida
+  uint32_t tAcc;                         ///< Precisión de tiempo (ns)
+  int32_t nano;                          ///< Fracción de segundo (ns, -1e9..1e9)
+  uint8_t fixType;                       ///< 0 sin fix, 2 = 2D, 3 = 3D, 4 = GNSS+DR, 5 solo tiempo
+  uint8_t flags;                         ///< bit0 gnssFixOK
+  uint8_t flags2;
+  uint8_t numSV;                         ///< Satélites en la solución
+  int32_t lon;                           ///< 1e-7 grados
+  int32_t lat;                           ///< 1e-7 grados
+  int32_t height;                        ///< Altura sobre el elipsoide (mm)
+  int32_t hMSL;                          ///< Altura sobre el nivel del mar (mm)
+  uint32_t hAcc;                         ///< Precisión horizontal (mm)
+  uint32_t vAcc;                         ///< Precisión vertical (mm)
+  int32_t velN, velE, velD;              ///< Velocidad NED (mm/s)
+  int32_t gSpeed;                        ///< Velocidad sobre el suelo (mm/s)
+  int32_t headMot;                       ///< Rumbo del movimiento (1e-5 grados)
+  uint32_t sAcc;                         ///< Precisión de velocidad (mm/s)
+  uint32_t headAcc;                      ///< Precisión del rumbo (1e-5 grados)
+  uint16_t pDOP;                         ///< PDOP (0.01)
+  uint8_t flags3;
+  uint8_t reserved1[5];
+  int32_t headVeh;
+  int16_t magDec;
+  uint16_t magAcc;
+};
+
+static_assert(sizeof(UbxNavPvt) == 92, "NAV-PVT ocupa 92 bytes");
+
+// ==================== PARSER ====================
+
+/**
+ * @class UbxParser
+ * @brief Parser de tramas UBX byte por byte (NAV-PVT y ACK)
+ *
+ * Solo guarda la carga útil de los mensajes que interpreta (NAV-PVT, ACK y
+ * MGA-DBD de hasta UBX_DBD_MAX B); el resto se recorre para el checksum
+ * Fletcher-8 y se descarta. Cualquier byte
+ * fuera de una trama (NMEA residual) se ignora hasta la siguiente sincronía.
+ */
+class UbxParser {
+public:
+  UbxParser();
+
+  /**
+   * @brief Procesa un byte del receptor
+   *
+   * @param c Byte recibido
+   * @return true Si completó un NAV-PVT con checksum válido
+   */
+  bool encode(char c);
+
+  /** @brief Último fix (valores con checksum válido) */
+  const GpsFix &fix() const { return fix_; }
+
+  /** @brief Cada NAV-PVT es una época de navegación completa */
+  bool epoch() const { return true; }
+
+  uint32_t passedChecksum() const { return passed_; }  ///< Tramas con checksum válido
+  uint32_t failedChecksum() const { return failed_; }  ///< Tramas descartadas por checksum
+
+  /**
+   * @brief Última confirmación recibida (ACK-ACK o ACK-NAK)
+   *
+   * @param cls Clase del mensaje confirmado (salida)
+   * @param id Identificador del mensaje confirmado (salida)
+   * @return int 1 = ACK, 0 = NAK, -1 = ninguna desde la última llamada
+   */
+  int takeAck(uint8_t *cls, uint8_t *id);
+
+  /**
+   * @brief Último MGA-DBD recibido (volcado de la base de navegación, ver gps_aid.h)
+   *
+   * La carga útil es válida hasta que empieza la siguiente trama.
+   *
+   * @param payload Carga útil (salida)
+   * @param len Bytes de la carga útil (salida)
+   * @return true Si llegó un MGA-DBD desde la última llamada
+   */
+  bool takeDbd(const uint8_t **payload, uint16_t *len);
+
+private:
+  enum State : uint8_t { SYNC1, SYNC2, CLASS, ID, LEN1, LEN2, PAYLOAD, CK_A, CK_B };
+
+  void checksum(uint8_t b);
+  void handle();
+
+  State state_;
+  uint8_t cls_, id_;
+  uint16_t len_, pos_;
+  uint8_t ckA_, ckB_;
+  union {
+    uint8_t buf_[UBX_DBD_MAX];
+    UbxNavPvt pvt_;
+  };
+  int8_t ack_;
+  bool dbd_;
+  uint8_t ackCls_, ackId_;
+
+  GpsFix fix_;
+  uint32_t passed_;
+  uint32_t failed_;
+};
+
+// ==================== CONFIGURACIÓN (FIRMWARE) ====================
+
+class HardwareSerial;
+
+/**
+ * @brief Envía una trama UBX con su checksum
+ *
+ * @param port Puerto serie del GPS
+ * @param cls Clase
+ * @param id Identificador
+ * @param payload Carga útil
+ * @param len Bytes de la carga útil
+ */
+void ubxSend(HardwareSerial &port, uint8_t cls, uint8_t id, const uint8_t *payload, uint16_t len);
+
+/**
+ * @brief Configura el receptor: baudios, tasa de navegación y salida NAV-PVT
+ *
+ * Envía CFG-PRT a BAUD_GPS y a GPS_UBX_BAUD (el receptor puede seguir a la
+ * velocidad alta tras un reinicio del microcontrolador), pasa el puerto a
+ * GPS_UBX_BAUD y espera la confirmación de CFG-RATE y CFG-MSG. Bloquea
+ * hasta ~1 s; solo se llama desde setup().
+ *
+ * @param port Puerto serie del GPS (Serial1)
+ * @return true Si el receptor confirmó la tasa y el mensaje
+ */
+bool ubxConfigure(HardwareSerial &port);
+
+#endif // UBX_H
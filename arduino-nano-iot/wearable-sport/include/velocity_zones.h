@@ -20,8 +20,12 @@ enum VelZone {
   VZ_SPR = 3   ///< Sprint
 };
 
-extern float secInVZ[4];                 ///< Segundos acumulados por zona de velocidad
-extern float distInVZ[4];                ///< Distancia acumulada por zona de velocidad (m)
+/**
+ * @brief Fija los bordes de las zonas (perfil del atleta, ver athlete_profile.h)
+ * 
+ * @param bins Bordes ascendentes en km/h; se guardan como enteros en 0.01 km/h
+ */
+void velZonesConfigure(const float bins[3]);
 
 /**
  * @brief Determina la zona de velocidad según la velocidad actual
@@ -0,0 +1,77 @@
+/**
+ * @file zone_table.h
+ * @brief Clasificador genérico de zonas con umbrales enteros y búsqueda sin saltos
+ * @authors Juan Perez, Ana Gomez
+ * @date 2025
+ *
+ * @details Las zonas de velocidad y de FC son el mismo problema: N bordes
+ * ascendentes que separan N+1 zonas. ZoneTable convierte los bordes a
+ * enteros una sola vez (al cargar el perfil del atleta) y clasifica un
+ * valor entero en la misma escala.
+ *
+ * La zona es el número de bordes menores o iguales al valor. Cada
+ * comparación se hace con el bit de signo de la resta, así que el bucle
+ * (desenrollado: N es constante de compilación) no tiene saltos
+ * condicionales: el M0+ no tiene ejecución condicional y un if por borde
+ * cuesta un vaciado del pipeline por cada predicción que falla. Para
+ * N = 3 o 5 esto es más rápido que una búsqueda binaria.
+ *
+ * Requisito: |valor - borde| < 2^31 (se cumple de sobra con km/h × 100 y
+ * bpm × 10).
+ */
+
+#ifndef ZONE_TABLE_H
+#define ZONE_TABLE_H
+
+#include <stdint.h>
+
+/**
+ * @class ZoneTable
+ * @brief N bordes enteros ascendentes, N+1 zonas
+ */
+template <int N>
+class ZoneTable {
+public:
+  static const int ZONES = N + 1;        ///< Número de zonas
+
+  /**
+   * @brief Convierte bordes reales a enteros: borde = ceil(edges[i] × scale)
+   *
+   * Con el valor truncado a la misma escala, valor >= borde equivale a
+   * comparar en float con la resolución de la escala.
+   *
+   * @param edges Bordes ascendentes
+   * @param scale Unidades enteras por unidad de los bordes
+   */
+  void set(const float *edges, float scale) {
+    for (int i = 0; i < N; i++) {
+      float x = edges[i] * scale;
+      int32_t e = (int32_t)x;
+      if ((float)e < x) e++;
+      edges_[i] = e;
+    }
+  }
+
+  /**
+   * @brief Zona de un valor en la escala de los bordes
+   *
+   * @param x Valor entero
+   * @return int Zona (0 a N)
+   */
+  int index(int32_t x) const {
+    uint32_t n = N;
+    for (int i = 0; i < N; i++) {
+      // 1 si x < borde: bit de signo de x - borde
+      n -= ((uint32_t)x - (uint32_t)edges_[i]) >> 31;
+    }
+    return (int)n;
+  }
+
+  /** @brief Borde i en la escala entera */
+  int32_t edge(int i) const { return edges_[i]; }
+
+private:
+  int32_t edges_[N];
+};
+
+#endif // ZONE_TABLE_H
@@ -0,0 +1,152 @@
+/**
+ * @file Arduino.h
+ * @brief Sustituto mínimo del core Arduino para el entorno `native` (PC)
+ * @authors Juan Perez, Ana Gomez
+ * @date 2025
+ *
+ * @details Solo se compila en el entorno `native` de PlatformIO (el entorno
+ * del Nano 33 IoT lo ignora con lib_ignore). Ofrece lo que usan los módulos
+ * del proyecto (y TinyGPSPlus en tools/bench_nmea): Print/Stream, Serial y Serial1, reloj virtual
+ * (millis/micros), analogRead y macros matemáticas. El reloj y las fuentes
+ * de datos los controla el reproductor de host_shim.cpp.
+ */
+
+#ifndef ARDUINO_H
+#define ARDUINO_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <math.h>
+
+// ==================== TIPOS Y CONSTANTES ====================
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+#define HIGH 1
+#define LOW 0
+#define INPUT 0
+#define OUTPUT 1
+#define INPUT_PULLUP 2
+
+#define DEC 10
+#define HEX 16
+#define OCT 8
+#define BIN 2
+
+#define PIN_A0 14
+#define A0 PIN_A0
+
+#define PI 3.1415926535897932384626433832795
+#define HALF_PI 1.5707963267948966192313216916398
+#define TWO_PI 6.283185307179586476925286766559
+#define DEG_TO_RAD 0.017453292519943295769236907684886
+#define RAD_TO_DEG 57.295779513082320876798154814105
+
+#define radians(deg) ((deg) * DEG_TO_RAD)
+#define degrees(rad) ((rad) * RAD_TO_DEG)
+#define sq(x) ((x) * (x))
+
+#define noInterrupts() do {} while (0)
+#define interrupts() do {} while (0)
+
+/** @brief En el PC las cadenas F() quedan en RAM; se conserva el tipo distinto */
+class __FlashStringHelper;
+#define F(s) (reinterpret_cast<const __FlashStringHelper *>(s))
+
+// ==================== TIEMPO Y E/S ====================
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+
+void pinMode(uint32_t pin, uint32_t mode);
+void digitalWrite(uint32_t pin, uint32_t val);
+int digitalRead(uint32_t pin);
+
+/**
+ * @brief Siguiente lectura del archivo de ECG reproducido
+ *
+ * Cada llamada consume una muestra; sin archivo (o al agotarse) devuelve
+ * el punto medio del ADC.
+ */
+int analogRead(uint32_t pin);
+void analogReadResolution(int bits);
+
+// ==================== PRINT / STREAM ====================
+
+/**
+ * @class Print
+ * @brief Salida con formato compatible con Print de Arduino
+ */
+class Print {
+public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t c) = 0;
+  virtual size_t write(const uint8_t *buf, size_t n);
+  size_t write(const char *s) { return s ? write((const uint8_t *)s, strlen(s)) : 0; }
+  size_t write(const char *buf, size_t n) { return write((const uint8_t *)buf, n); }
+
+  size_t print(const __FlashStringHelper *s) { return write(reinterpret_cast<const char *>(s)); }
+  size_t print(const char *s) { return write(s); }
+  size_t print(char c) { return write((uint8_t)c); }
+  size_t print(unsigned char v, int base = DEC) { return print((unsigned long)v, base); }
+  size_t print(int v, int base = DEC) { return print((long)v, base); }
+  size_t print(unsigned int v, int base = DEC) { return print((unsigned long)v, base); }
+  size_t print(long v, int base = DEC);
+  size_t print(unsigned long v, int base = DEC);
+  size_t print(double v, int digits = 2);
+
+  size_t println() { return write("\r\n"); }
+  template <class T>
+  size_t println(T v) { size_t n = print(v); return n + println(); }
+  template <class T>
+  size_t println(T v, int fmt) { size_t n = print(v, fmt); return n + println(); }
+
+  virtual void flush() {}
+};
+
+class Stream : public Print {
+public:
+  virtual int available() = 0;
+  virtual int read() = 0;
+  virtual int peek() = 0;
+};
+
+/**
+ * @class HardwareSerial
+ * @brief Puerto serie: Serial escribe en stdout, Serial1 entrega el NMEA reproducido
+ */
+class HardwareSerial : public Stream {
+public:
+  explicit HardwareSerial(int port) : port_(port) {}
+  void begin(unsigned long baud) { baud_ = baud; }
+  void end() {}
+  operator bool() const { return true; }
+
+  int available();
+  int read();
+  int peek();
+  size_t write(uint8_t c);
+  size_t write(const uint8_t *buf, size_t n);
+  using Print::write;
+  void flush();
+
+private:
+  int port_;
+  unsigned long baud_ = 0;
+};
+
+extern HardwareSerial Serial;            ///< Monitor serie (stdout)
+extern HardwareSerial Serial1;           ///< GPS (archivo NMEA)
+
+// ==================== PUNTOS DE ENTRADA DEL SKETCH ====================
+
+void setup();
+void loop();
+
+#endif // ARDUINO_H
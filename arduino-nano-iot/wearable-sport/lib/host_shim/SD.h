@@ -0,0 +1,114 @@
+/**
+ * @file SD.h
+ * @brief Sustituto de la biblioteca SD para el entorno `native`
+ * @authors Juan Perez, Ana Gomez
+ * @date 2025
+ *
+ * @details Los archivos de la "tarjeta" son archivos del PC dentro del
+ * directorio elegido con --sd (por defecto el directorio actual). Igual
+ * que en la biblioteca de Arduino, FILE_WRITE abre para lectura/escritura
+ * y agrega al final.
+ *
+ * Sd2Card, SdVolume y SdFile cubren solo lo que usa la captura de ECG:
+ * createContiguous() crea el archivo con su tamaño final y le asigna un
+ * rango ficticio de bloques; Sd2Card::writeBlock() escribe en el archivo
+ * al que pertenece el bloque.
+ */
+
+#ifndef SD_H
+#define SD_H
+
+#include <stdio.h>
+#include <string>
+#include <Arduino.h>
+
+#define FILE_READ  0x01
+#define FILE_WRITE 0x13
+
+/**
+ * @class File
+ * @brief Archivo abierto; las copias comparten el mismo descriptor
+ */
+class File : public Stream {
+public:
+  File() : f_(nullptr) {}
+  explicit File(FILE *f) : f_(f) {}
+
+  size_t write(uint8_t c);
+  size_t write(const uint8_t *buf, size_t n);
+  using Print::write;
+  int available();
+  int read();
+  int read(void *buf, size_t n);
+  int peek();
+  void flush();
+  bool seek(uint32_t pos);
+  uint32_t position();
+  uint32_t size();
+  void close();
+  operator bool() const { return f_ != nullptr; }
+
+private:
+  FILE *f_;
+};
+
+/**
+ * @class SDClass
+ * @brief Sistema de archivos de la tarjeta sobre un directorio del PC
+ */
+class SDClass {
+public:
+  bool begin(uint8_t csPin);
+  bool exists(const char *path);
+  bool remove(const char *path);
+  bool mkdir(const char *path);
+  File open(const char *path, uint8_t mode = FILE_READ);
+};
+
+extern SDClass SD;
+
+// ==================== ACCESO DE BAJO NIVEL ====================
+
+#define SPI_FULL_SPEED    0
+#define SPI_HALF_SPEED    1
+#define SPI_QUARTER_SPEED 2
+#define O_READ            0x01
+
+/**
+ * @class Sd2Card
+ * @brief Tarjeta por bloques de 512 B
+ */
+class Sd2Card {
+public:
+  uint8_t init(uint8_t sckRateID = SPI_FULL_SPEED, uint8_t chipSelectPin = 4);
+  uint8_t writeBlock(uint32_t blockNumber, const uint8_t *src, uint8_t blocking = 1);
+  uint8_t erase(uint32_t firstBlock, uint32_t lastBlock);
+};
+
+/**
+ * @class SdVolume
+ * @brief Volumen FAT de la tarjeta
+ */
+class SdVolume {
+public:
+  uint8_t init(Sd2Card *dev);
+};
+
+/**
+ * @class SdFile
+ * @brief Archivo o directorio del volumen
+ */
+class SdFile {
+public:
+  uint8_t openRoot(SdVolume *vol);
+  uint8_t open(SdFile *dirFile, const char *fileName, uint8_t oflag);
+  uint8_t createContiguous(SdFile *dirFile, const char *fileName, uint32_t size);
+  uint8_t contiguousRange(uint32_t *bgnBlock, uint32_t *endBlock);
+  uint8_t close();
+
+private:
+  std::string path_;
+  bool open_ = false;
+};
+
+#endif // SD_H
@@ -0,0 +1,13 @@
+/**
+ * @file SPI.h
+ * @brief Sustituto vacío de la biblioteca SPI para el entorno `native`
+ * @authors Juan Perez, Ana Gomez
+ * @date 2025
+ */
+
+#ifndef SPI_H
+#define SPI_H
+
+#include <Arduino.h>
+
+#endif // SPI_H
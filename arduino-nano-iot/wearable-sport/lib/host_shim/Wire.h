@@ -0,0 +1,49 @@
+/**
+ * @file Wire.h
+ * @brief Sustituto de la biblioteca Wire (I2C) para el entorno `native`
+ * @authors Juan Perez, Ana Gomez
+ * @date 2025
+ *
+ * @details Solo responde el LSM6DS3 (dirección 0x6A) y solo si se indicó
+ * --imu al reproductor: las muestras del archivo entran a su FIFO al ritmo
+ * de IMU_RATE_HZ del reloj virtual. Cualquier otra
+ * dirección responde NACK.
+ */
+
+#ifndef WIRE_H
+#define WIRE_H
+
+#include <Arduino.h>
+
+/**
+ * @class TwoWire
+ * @brief Maestro I2C con la interfaz de Arduino
+ */
+class TwoWire : public Stream {
+public:
+  void begin() {}
+  void end() {}
+  void setClock(uint32_t) {}
+
+  void beginTransmission(uint8_t address);
+  uint8_t endTransmission(bool stopBit = true);
+  size_t requestFrom(uint8_t address, size_t quantity, bool stopBit = true);
+
+  size_t write(uint8_t c);
+  using Print::write;
+  int available();
+  int read();
+  int peek();
+
+private:
+  uint8_t addr_ = 0;
+  uint8_t tx_[8];
+  uint8_t txLen_ = 0;
+  uint8_t rx_[256];                      ///< Mismo tamaño que el buffer de Wire en SAMD
+  uint16_t rxLen_ = 0;
+  uint16_t rxPos_ = 0;
+};
+
+extern TwoWire Wire;
+
+#endif // WIRE_H
@@ -0,0 +1,648 @@
+/**
+ * @file host_shim.cpp
+ * @brief Reproductor en PC: reloj virtual, ECG y NMEA desde archivos
+ * @authors Juan Perez, Ana Gomez
+ * @date 2025
+ *
+ * @details Ejecuta setup() y loop() del firmware sobre un reloj virtual que
+ * avanza un paso fijo por cada llamada a loop(), así que la reproducción
+ * corre tan rápido como lo permita el PC y da los mismos resultados en cada
+ * ejecución.
+ *
+ * - ECG: una lectura del ADC por línea (líneas vacías o con '#' se ignoran),
+ *   a SAMPLE_RATE. Alimenta analogRead() y los bloques de ecgAdcNextBlock().
+ * - NMEA: registro crudo del GPS. Cada oración se entrega por Serial1 cuando
+ *   el reloj virtual alcanza su hora UTC (relativa a la primera oración con
+ *   hora); las oraciones sin hora siguen a la anterior.
+ * - IMU: una muestra cruda del acelerómetro por línea ("ax ay az" en LSB a
+ *   ±16 g), a IMU_RATE_HZ desde el inicio. Entran a la FIFO del LSM6DS3
+ *   emulado en Wire (con su capacidad y desbordamiento).
+ * - SD: archivos del directorio indicado con --sd.
+ *
+ * Uso:
+ *   program --ecg ecg.txt --nmea gps.nmea [--imu imu.txt] [--sd dir] [--seconds s] [--tick-us us] [-q]
+ *
+ * Al terminar imprime en stderr el tiempo simulado, el tiempo real y el
+ * rendimiento en muestras de ECG por segundo.
+ */
+
+#include <Arduino.h>
+#include <SD.h>
+#include <Wire.h>
+#include <stdio.h>
+#include <sys/stat.h>
+#include <chrono>
+#include <string>
+#include <vector>
+#include "config.h"
+#include "ecg_adc.h"
+#include "ecg_decim.h"
+#include "imu.h"
+
+// ==================== ESTADO DEL REPRODUCTOR ====================
+
+static uint64_t clockUs = 0;             ///< Reloj virtual
+static uint32_t tickUs = 1000;           ///< Avance del reloj por llamada a loop()
+static bool quiet = false;               ///< Suprime la salida de Serial
+static std::string sdDir = ".";
+
+static std::vector<uint16_t> ecg;        ///< Lecturas del ADC
+static size_t ecgPos = 0;                ///< Siguiente lectura para analogRead()
+
+static std::string nmea;                 ///< Registro NMEA completo
+static std::vector<size_t> nmeaEnd;      ///< Fin (exclusivo) de cada oración
+static std::vector<uint64_t> nmeaAtUs;   ///< Momento de entrega de cada oración
+static size_t nmeaReleased = 0;          ///< Bytes ya disponibles en Serial1
+static size_t nmeaLine = 0;              ///< Siguiente oración por liberar
+static size_t nmeaPos = 0;               ///< Siguiente byte por leer
+
+static std::vector<ImuSample> imu;      ///< Muestras del acelerómetro
+static bool imuPresent = false;          ///< Sin --imu el LSM6DS3 no responde
+static bool fifoOn = false;              ///< FIFO en modo continuo
+static uint64_t fifoRead = 0;            ///< Siguiente muestra por leer de la FIFO
+static uint8_t fifoWord = 0;             ///< Siguiente eje (0 = X) de esa muestra
+static bool fifoOverrun = false;
+
+static const int ADC_MID = 1 << (ADC_RESOLUTION - 1);
+
+// ==================== CARGA DE ARCHIVOS ====================
+
+static bool loadEcg(const char *path) {
+  FILE *f = fopen(path, "r");
+  if (!f) {
+    perror(path);
+    return false;
+  }
+  char line[64];
+  while (fgets(line, sizeof(line), f)) {
+    char *p = line;
+    while (*p == ' ' || *p == '\t') p++;
+    if (*p == '#' || *p == '\n' || *p == '\r' || *p == '\0') continue;
+    ecg.push_back((uint16_t)atoi(p));
+  }
+  fclose(f);
+  return true;
+}
+
+static bool loadImu(const char *path) {
+  FILE *f = fopen(path, "r");
+  if (!f) {
+    perror(path);
+    return false;
+  }
+  char line[96];
+  while (fgets(line, sizeof(line), f)) {
+    int ax, ay, az;
+    if (line[0] == '#' || sscanf(line, "%d %d %d", &ax, &ay, &az) != 3) continue;
+    imu.push_back(ImuSample{(int16_t)ax, (int16_t)ay, (int16_t)az});
+  }
+  fclose(f);
+  imuPresent = true;
+  return true;
+}
+
+/**
+ * @brief Hora UTC (ms del día) del campo 1 de una oración, o -1 si no tiene
+ */
+static long sentenceTimeMs(const char *s, size_t len) {
+  const char *comma = (const char *)memchr(s, ',', len);
+  if (s[0] != '$' || !comma || (size_t)(comma - s) + 7 > len) return -1;
+  const char *t = comma + 1;
+  for (int i = 0; i < 6; i++) {
+    if (!isdigit((unsigned char)t[i])) return -1;
+  }
+  long h = (t[0] - '0') * 10 + (t[1] - '0');
+  long m = (t[2] - '0') * 10 + (t[3] - '0');
+  long sec = (t[4] - '0') * 10 + (t[5] - '0');
+  long ms = 0;
+  if (t[6] == '.') {
+    long scale = 100;
+    for (int i = 7; isdigit((unsigned char)t[i]) && scale > 0; i++, scale /= 10) {
+      ms += (t[i] - '0') * scale;
+    }
+  }
+  return ((h * 60 + m) * 60 + sec) * 1000 + ms;
+}
+
+static bool loadNmea(const char *path) {
+  FILE *f = fopen(path, "rb");
+  if (!f) {
+    perror(path);
+    return false;
+  }
+  char buf[4096];
+  size_t n;
+  while ((n = fread(buf, 1, sizeof(buf), f)) > 0) nmea.append(buf, n);
+  fclose(f);
+
+  long firstMs = -1;
+  long lastMs = 0;
+  long dayOffsetMs = 0;
+  uint64_t atUs = 0;
+  size_t start = 0;
+  while (start < nmea.size()) {
+    size_t end = nmea.find('\n', start);
+    end = (end == std::string::npos) ? nmea.size() : end + 1;
+    long t = sentenceTimeMs(nmea.data() + start, end - start);
+    if (t >= 0) {
+      if (firstMs < 0) firstMs = t;
+      if (t + 12L * 3600 * 1000 < lastMs) dayOffsetMs += 24L * 3600 * 1000;  // Cambio de día
+      lastMs = t;
+      long rel = t + dayOffsetMs - firstMs;
+      if (rel > 0 && (uint64_t)rel * 1000 > atUs) atUs = (uint64_t)rel * 1000;
+    }
+    nmeaEnd.push_back(end);
+    nmeaAtUs.push_back(atUs);
+    start = end;
+  }
+  return true;
+}
+
+// ==================== TIEMPO Y E/S ====================
+
+unsigned long millis() { return (unsigned long)(uint32_t)(clockUs / 1000); }
+unsigned long micros() { return (unsigned long)(uint32_t)clockUs; }
+void delay(unsigned long ms) { clockUs += (uint64_t)ms * 1000; }
+void delayMicroseconds(unsigned int us) { clockUs += us; }
+
+void pinMode(uint32_t, uint32_t) {}
+void digitalWrite(uint32_t, uint32_t) {}
+int digitalRead(uint32_t) { return LOW; }
+
+int analogRead(uint32_t) {
+  return ecgPos < ecg.size() ? ecg[ecgPos++] : ADC_MID;
+}
+
+void analogReadResolution(int) {}
+
+// ==================== ADQUISICIÓN ECG POR BLOQUES ====================
+
+static uint32_t blocksRead = 0;
+static uint32_t blocksDone = 0;
+static uint16_t block[ECG_BLOCK_LEN];
+static EcgBlockCallback blockCb = nullptr;
+
+#if ECG_OVS_ON
+static EcgDecimator decim;
+static uint16_t rawBlock[ECG_DECIM_TAPS + ECG_BLOCK_LEN * ECG_DECIM];
+#endif
+
+void ecgAdcBegin(EcgBlockCallback onBlock) {
+  blocksRead = 0;
+  blocksDone = (uint32_t)(clockUs * SAMPLE_RATE / 1000000ULL / ECG_BLOCK_LEN);
+  blockCb = onBlock;
+}
+
+/**
+ * @brief Avisa los bloques que el reloj virtual completó (como la interrupción del DMA)
+ */
+static void ecgAdcTick() {
+  if (!blockCb) return;
+  uint32_t done = (uint32_t)(clockUs * SAMPLE_RATE / 1000000ULL / ECG_BLOCK_LEN);
+  while (blocksDone < done) {
+    blocksDone++;
+    blockCb();
+  }
+}
+
+/**
+ * @brief Entrega un bloque cuando el reloj virtual pasó su última muestra
+ */
+const uint16_t *ecgAdcNextBlock(uint32_t *firstSample) {
+  uint64_t first = (uint64_t)blocksRead * ECG_BLOCK_LEN;
+  if (clockUs * SAMPLE_RATE < (first + ECG_BLOCK_LEN) * 1000000ULL) {
+    return nullptr;
+  }
+  ecgPos = (size_t)first;
+#if ECG_OVS_ON
+  // Cada lectura del archivo se mantiene durante ECG_DECIM disparos, como la suma de ECG_ADC_AVG conversiones
+  for (int i = 0; i < ECG_BLOCK_LEN; i++) {
+    uint16_t acc = (uint16_t)((analogRead(EMG_INPUT_PIN) << (ECG_OVS_ADC_BITS - ADC_RESOLUTION)) * ECG_ADC_AVG);
+    for (int j = 0; j < ECG_DECIM; j++) rawBlock[ECG_DECIM_TAPS + i * ECG_DECIM + j] = acc;
+  }
+  decim.process(rawBlock + ECG_DECIM_TAPS, block, ECG_BLOCK_LEN);
+#else
+  for (int i = 0; i < ECG_BLOCK_LEN; i++) {
+    block[i] = (uint16_t)analogRead(EMG_INPUT_PIN);
+  }
+#endif
+  *firstSample = (uint32_t)first;
+  blocksRead++;
+  return block;
+}
+
+// ==================== PRINT ====================
+
+size_t Print::write(const uint8_t *buf, size_t n) {
+  size_t k = 0;
+  while (n--) k += write(*buf++);
+  return k;
+}
+
+size_t Print::print(long v, int base) {
+  if (base == DEC) {
+    char b[24];
+    snprintf(b, sizeof(b), "%ld", v);
+    return write(b);
+  }
+  return print((unsigned long)v, base);
+}
+
+size_t Print::print(unsigned long v, int base) {
+  char b[8 * sizeof(long) + 1];
+  char *p = &b[sizeof(b) - 1];
+  *p = '\0';
+  if (base < 2) base = 10;
+  do {
+    int d = (int)(v % base);
+    *--p = (char)(d < 10 ? '0' + d : 'A' + d - 10);
+    v /= base;
+  } while (v);
+  return write(p);
+}
+
+size_t Print::print(double v, int digits) {
+  // Mismos casos especiales que Print::printFloat de Arduino
+  if (isnan(v)) return write("nan");
+  if (isinf(v)) return write("inf");
+  if (v > 4294967040.0 || v < -4294967040.0) return write("ovf");
+  char b[48];
+  snprintf(b, sizeof(b), "%.*f", digits, v);
+  return write(b);
+}
+
+// ==================== PUERTOS SERIE ====================
+
+HardwareSerial Serial(0);
+HardwareSerial Serial1(1);
+
+/** @brief Libera las oraciones NMEA cuya hora ya alcanzó el reloj virtual */
+static void releaseNmea() {
+  while (nmeaLine < nmeaEnd.size() && nmeaAtUs[nmeaLine] <= clockUs) {
+    nmeaReleased = nmeaEnd[nmeaLine++];
+  }
+}
+
+int HardwareSerial::available() {
+  if (port_ != 1) return 0;
+  releaseNmea();
+  return (int)(nmeaReleased - nmeaPos);
+}
+
+int HardwareSerial::read() {
+  if (available() <= 0) return -1;
+  return (uint8_t)nmea[nmeaPos++];
+}
+
+int HardwareSerial::peek() {
+  if (available() <= 0) return -1;
+  return (uint8_t)nmea[nmeaPos];
+}
+
+size_t HardwareSerial::write(uint8_t c) {
+  if (port_ == 0 && !quiet) putchar(c);
+  return 1;
+}
+
+size_t HardwareSerial::write(const uint8_t *buf, size_t n) {
+  if (port_ == 0 && !quiet) fwrite(buf, 1, n, stdout);
+  return n;
+}
+
+void HardwareSerial::flush() {
+  if (port_ == 0) fflush(stdout);
+}
+
+// ==================== I2C (LSM6DS3 EMULADO) ====================
+
+TwoWire Wire;
+
+/** @brief Muestras del acelerómetro producidas hasta el reloj virtual */
+static uint64_t imuProduced() {
+  uint64_t n = clockUs * IMU_RATE_HZ / 1000000ULL;
+  return n < imu.size() ? n : imu.size();
+}
+
+/** @brief Palabras sin leer en la FIFO; si se llenó descarta las más antiguas */
+static uint32_t fifoWords() {
+  if (!fifoOn) return 0;
+  uint64_t n = imuProduced();
+  if (n - fifoRead > LSM6_FIFO_SAMPLES) {
+    fifoRead = n - LSM6_FIFO_SAMPLES;
+    fifoWord = 0;
+    fifoOverrun = true;
+  }
+  return (uint32_t)((n - fifoRead) * 3 - fifoWord);
+}
+
+/** @brief Siguiente byte de FIFO_DATA_OUT (el puntero vuelve de _H a _L) */
+static uint8_t fifoByte(bool high) {
+  if (fifoWords() == 0) return 0;
+  const ImuSample &m = imu[fifoRead];
+  int16_t v = fifoWord == 0 ? m.ax : (fifoWord == 1 ? m.ay : m.az);
+  if (!high) return (uint8_t)(v & 0xFF);
+  if (++fifoWord == 3) {
+    fifoWord = 0;
+    fifoRead++;
+  }
+  return (uint8_t)((uint16_t)v >> 8);
+}
+
+/** @brief Lee un registro del LSM6DS3 */
+static uint8_t imuRegister(uint8_t reg) {
+  if (reg == LSM6_WHO_AM_I) return LSM6_ID_DS3;
+  if (reg == LSM6_FIFO_STATUS1) return (uint8_t)fifoWords();
+  if (reg == LSM6_FIFO_STATUS1 + 1) {
+    uint32_t w = fifoWords();
+    uint8_t v = (uint8_t)(((w >> 8) & 0x0F) | (w == 0 ? 0x10 : 0) | (fifoOverrun ? 0x40 : 0));
+    fifoOverrun = false;
+    return v;
+  }
+  if (reg == LSM6_FIFO_STATUS1 + 2) return fifoWord;
+  return 0;
+}
+
+void TwoWire::beginTransmission(uint8_t address) {
+  addr_ = address;
+  txLen_ = 0;
+}
+
+size_t TwoWire::write(uint8_t c) {
+  if (txLen_ >= sizeof(tx_)) return 0;
+  tx_[txLen_++] = c;
+  return 1;
+}
+
+uint8_t TwoWire::endTransmission(bool) {
+  if (addr_ != IMU_I2C_ADDR || !imuPresent) return 2;
+  if (txLen_ >= 2 && tx_[0] == LSM6_FIFO_CTRL5) {
+    fifoOn = (tx_[1] & 0x07) != 0;
+    fifoRead = imuProduced();
+    fifoWord = 0;
+  }
+  return 0;
+}
+
+size_t TwoWire::requestFrom(uint8_t address, size_t quantity, bool) {
+  rxLen_ = rxPos_ = 0;
+  if (address != IMU_I2C_ADDR || !imuPresent || txLen_ == 0) return 0;
+  if (quantity > sizeof(rx_)) quantity = sizeof(rx_);
+  for (size_t i = 0; i < quantity; i++) {
+    rx_[rxLen_++] = tx_[0] == LSM6_FIFO_DATA_OUT_L ? fifoByte(i & 1)
+                                                   : imuRegister((uint8_t)(tx_[0] + i));
+  }
+  return rxLen_;
+}
+
+int TwoWire::available() {
+  return rxLen_ - rxPos_;
+}
+
+int TwoWire::read() {
+  return rxPos_ < rxLen_ ? rx_[rxPos_++] : -1;
+}
+
+int TwoWire::peek() {
+  return rxPos_ < rxLen_ ? rx_[rxPos_] : -1;
+}
+
+// ==================== SD ====================
+
+SDClass SD;
+
+static std::string sdPath(const char *path) {
+  return sdDir + "/" + path;
+}
+
+bool SDClass::begin(uint8_t) {
+  struct stat st;
+  return stat(sdDir.c_str(), &st) == 0 && S_ISDIR(st.st_mode);
+}
+
+bool SDClass::exists(const char *path) {
+  struct stat st;
+  return stat(sdPath(path).c_str(), &st) == 0;
+}
+
+bool SDClass::remove(const char *path) {
+  return ::remove(sdPath(path).c_str()) == 0;
+}
+
+bool SDClass::mkdir(const char *path) {
+  return ::mkdir(sdPath(path).c_str(), 0755) == 0;
+}
+
+File SDClass::open(const char *path, uint8_t mode) {
+  return File(fopen(sdPath(path).c_str(), mode == FILE_READ ? "rb" : "a+b"));
+}
+
+size_t File::write(uint8_t c) {
+  return (f_ && fputc(c, f_) != EOF) ? 1 : 0;
+}
+
+size_t File::write(const uint8_t *buf, size_t n) {
+  return f_ ? fwrite(buf, 1, n, f_) : 0;
+}
+
+int File::available() {
+  if (!f_) return 0;
+  return (int)(size() - position());
+}
+
+int File::read() {
+  return f_ ? fgetc(f_) : -1;
+}
+
+int File::read(void *buf, size_t n) {
+  return f_ ? (int)fread(buf, 1, n, f_) : -1;
+}
+
+int File::peek() {
+  if (!f_) return -1;
+  int c = fgetc(f_);
+  if (c != EOF) ungetc(c, f_);
+  return c;
+}
+
+void File::flush() {
+  if (f_) fflush(f_);
+}
+
+bool File::seek(uint32_t pos) {
+  return f_ && fseek(f_, (long)pos, SEEK_SET) == 0;
+}
+
+uint32_t File::position() {
+  return f_ ? (uint32_t)ftell(f_) : 0;
+}
+
+uint32_t File::size() {
+  if (!f_) return 0;
+  long here = ftell(f_);
+  fseek(f_, 0, SEEK_END);
+  long end = ftell(f_);
+  fseek(f_, here, SEEK_SET);
+  return (uint32_t)end;
+}
+
+void File::close() {
+  if (f_) fclose(f_);
+  f_ = nullptr;
+}
+
+/**
+ * @struct HostExtent
+ * @brief Rango de bloques asignado a un archivo contiguo
+ */
+struct HostExtent {
+  uint32_t bgn;
+  uint32_t end;                          ///< Último bloque (inclusivo)
+  std::string path;
+};
+
+static std::vector<HostExtent> extents;
+static uint32_t nextFreeBlock = 0x1000;  ///< Los bloques bajos simulan FAT y directorio
+
+uint8_t Sd2Card::init(uint8_t, uint8_t) {
+  return SD.begin(0);
+}
+
+uint8_t Sd2Card::writeBlock(uint32_t blockNumber, const uint8_t *src, uint8_t) {
+  for (const HostExtent &e : extents) {
+    if (blockNumber < e.bgn || blockNumber > e.end) continue;
+    FILE *f = fopen(e.path.c_str(), "r+b");
+    if (!f) return 0;
+    bool ok = fseek(f, (long)(blockNumber - e.bgn) * 512, SEEK_SET) == 0 &&
+              fwrite(src, 1, 512, f) == 512;
+    fclose(f);
+    return ok;
+  }
+  return 0;
+}
+
+uint8_t Sd2Card::erase(uint32_t firstBlock, uint32_t lastBlock) {
+  static const uint8_t zero[512] = {0};
+  for (uint32_t b = firstBlock; b <= lastBlock; b++) {
+    if (!writeBlock(b, zero)) return 0;
+  }
+  return 1;
+}
+
+uint8_t SdVolume::init(Sd2Card *) {
+  return 1;
+}
+
+uint8_t SdFile::openRoot(SdVolume *) {
+  path_ = sdDir;
+  open_ = true;
+  return 1;
+}
+
+uint8_t SdFile::open(SdFile *dirFile, const char *fileName, uint8_t) {
+  struct stat st;
+  path_ = dirFile->path_ + "/" + fileName;
+  open_ = stat(path_.c_str(), &st) == 0;
+  return open_;
+}
+
+uint8_t SdFile::createContiguous(SdFile *dirFile, const char *fileName, uint32_t size) {
+  path_ = dirFile->path_ + "/" + fileName;
+  FILE *f = fopen(path_.c_str(), "wb");
+  if (!f) return 0;
+  bool ok = size == 0 || (fseek(f, (long)size - 1, SEEK_SET) == 0 && fputc(0, f) != EOF);
+  fclose(f);
+  if (!ok) return 0;
+  uint32_t blocks = (size + 511) / 512;
+  extents.push_back(HostExtent{nextFreeBlock, nextFreeBlock + blocks - 1, path_});
+  nextFreeBlock += blocks;
+  open_ = true;
+  return 1;
+}
+
+uint8_t SdFile::contiguousRange(uint32_t *bgnBlock, uint32_t *endBlock) {
+  for (const HostExtent &e : extents) {
+    if (e.path != path_) continue;
+    *bgnBlock = e.bgn;
+    *endBlock = e.end;
+    return 1;
+  }
+  return 0;
+}
+
+uint8_t SdFile::close() {
+  open_ = false;
+  return 1;
+}
+
+// ==================== PROGRAMA PRINCIPAL ====================
+
+static void usage(const char *prog) {
+  fprintf(stderr,
+          "Uso: %s [--ecg archivo] [--nmea archivo] [--imu archivo] [--sd dir] [--seconds s] "
+          "[--tick-us us] [-q]\n",
+          prog);
+}
+
+int main(int argc, char **argv) {
+  double seconds = -1;
+  bool haveInput = false;
+  for (int i = 1; i < argc; i++) {
+    std::string a = argv[i];
+    bool hasArg = i + 1 < argc;
+    if (a == "--ecg" && hasArg) {
+      if (!loadEcg(argv[++i])) return 1;
+      haveInput = true;
+    } else if (a == "--nmea" && hasArg) {
+      if (!loadNmea(argv[++i])) return 1;
+      haveInput = true;
+    } else if (a == "--imu" && hasArg) {
+      if (!loadImu(argv[++i])) return 1;
+      haveInput = true;
+    } else if (a == "--sd" && hasArg) {
+      sdDir = argv[++i];
+    } else if (a == "--seconds" && hasArg) {
+      seconds = atof(argv[++i]);
+    } else if (a == "--tick-us" && hasArg) {
+      tickUs = (uint32_t)atol(argv[++i]);
+      if (tickUs == 0) tickUs = 1;
+    } else if (a == "-q") {
+      quiet = true;
+    } else {
+      usage(argv[0]);
+      return 1;
+    }
+  }
+  if (!haveInput && seconds < 0) {
+    usage(argv[0]);
+    return 1;
+  }
+
+  // Duración: la de los archivos, salvo que se indique --seconds
+  uint64_t endUs = 0;
+  if (seconds >= 0) {
+    endUs = (uint64_t)(seconds * 1e6);
+  } else {
+    endUs = (uint64_t)ecg.size() * 1000000ULL / SAMPLE_RATE;
+    if (!nmeaAtUs.empty() && nmeaAtUs.back() + 1000000ULL > endUs) {
+      endUs = nmeaAtUs.back() + 1000000ULL;
+    }
+  }
+
+  auto t0 = std::chrono::steady_clock::now();
+  setup();
+  while (clockUs <= endUs) {
+    loop();
+    clockUs += tickUs;
+    ecgAdcTick();
+  }
+  fflush(stdout);
+  double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+  double sim = clockUs / 1e6;
+  double samples = sim * SAMPLE_RATE;
+  fprintf(stderr, "Reproducción: %.1f s simulados en %.3f s (%.0fx tiempo real)\n",
+          sim, wall, wall > 0 ? sim / wall : 0.0);
+  fprintf(stderr, "ECG: %.0f muestras a %d Hz, %.0f muestras/s\n",
+          samples, SAMPLE_RATE, wall > 0 ? samples / wall : 0.0);
+  return 0;
+}
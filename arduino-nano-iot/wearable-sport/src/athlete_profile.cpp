@@ -0,0 +1,159 @@
+/**
+ * @file athlete_profile.cpp
+ * @brief Lectura del perfil del atleta desde la SD
+ * @authors Juan Perez, Ana Gomez
+ * @date 2025
+ */
+
+#include <Arduino.h>
+#include <SD.h>
+#include <stdlib.h>
+#include <string.h>
+#include "athlete_profile.h"
+#include "config.h"
+#include "velocity_zones.h"
+#include "heart_rate_zones.h"
+
+/** @brief Longitud máxima de una línea del archivo (el resto se ignora) */
+static const int PROFILE_LINE_MAX = 96;
+
+/** @brief Perfil por omisión: las constantes de config.h */
+AthleteProfile athlete = {
+  "",
+  FCMAX,
+  {Z_EDGES[0], Z_EDGES[1], Z_EDGES[2], Z_EDGES[3], Z_EDGES[4]},
+  {V_BINS[0], V_BINS[1], V_BINS[2]},
+  {TRIMP_W[0], TRIMP_W[1], TRIMP_W[2], TRIMP_W[3], TRIMP_W[4], TRIMP_W[5]}
+};
+
+// ==================== FUNCIONES INTERNAS ====================
+
+/**
+ * @brief Lee exactamente n números separados por comas
+ *
+ * @return true Si hay n números y nada más que espacios después
+ */
+static bool parseList(const char *s, float *out, int n) {
+  for (int i = 0; i < n; i++) {
+    char *end;
+    out[i] = (float)strtod(s, &end);
+    if (end == s) return false;
+    s = end;
+    while (*s == ' ') s++;
+    if (i < n - 1) {
+      if (*s != ',') return false;
+      s++;
+    }
+  }
+  return *s == '\0';
+}
+
+/** @brief Bordes estrictamente ascendentes y positivos */
+static bool ascending(const float *v, int n) {
+  if (!(v[0] > 0)) return false;
+  for (int i = 1; i < n; i++) {
+    if (!(v[i] > v[i - 1])) return false;
+  }
+  return true;
+}
+
+/** @brief Quita espacios al inicio y al final (en el mismo buffer) */
+static char *trim(char *s) {
+  while (*s == ' ' || *s == '\t') s++;
+  char *e = s + strlen(s);
+  while (e > s && (e[-1] == ' ' || e[-1] == '\t' || e[-1] == '\r')) e--;
+  *e = '\0';
+  return s;
+}
+
+/**
+ * @brief Aplica una línea clave=valores al perfil
+ *
+ * @return true Si la clave es conocida y el valor válido
+ */
+static bool parseLine(char *line) {
+  char *hash = strchr(line, '#');
+  if (hash) *hash = '\0';
+  char *eq = strchr(line, '=');
+  if (!eq) return trim(line)[0] == '\0';  // Línea vacía o solo comentario
+  *eq = '\0';
+  const char *key = trim(line);
+  const char *val = trim(eq + 1);
+
+  if (strcmp(key, "nombre") == 0) {
+    strncpy(athlete.name, val, sizeof(athlete.name) - 1);
+    athlete.name[sizeof(athlete.name) - 1] = '\0';
+    return true;
+  }
+  if (strcmp(key, "fcmax") == 0) {
+    float fc;
+    if (!parseList(val, &fc, 1) || fc < 100 || fc > 250) return false;
+    athlete.fcMax = (int)(fc + 0.5f);
+    return true;
+  }
+  if (strcmp(key, "zonas_fc") == 0) {
+    float pct[5];
+    if (!parseList(val, pct, 5) || !ascending(pct, 5) || pct[4] > 100) return false;
+    for (int i = 0; i < 5; i++) athlete.zEdges[i] = pct[i] * 0.01f;
+    return true;
+  }
+  if (strcmp(key, "zonas_vel") == 0) {
+    float v[3];
+    if (!parseList(val, v, 3) || !ascending(v, 3)) return false;
+    memcpy(athlete.vBins, v, sizeof(v));
+    return true;
+  }
+  if (strcmp(key, "trimp") == 0) {
+    float w[6];
+    if (!parseList(val, w, 6)) return false;
+    for (int i = 0; i < 6; i++) {
+      if (w[i] < 0) return false;
+    }
+    memcpy(athlete.trimpW, w, sizeof(w));
+    return true;
+  }
+  return false;
+}
+
+// ==================== INTERFAZ ====================
+
+/**
+ * @brief Lee el perfil de la tarjeta SD (ya inicializada)
+ *
+ * @param path Nombre del archivo
+ * @return true Si el archivo existía
+ */
+bool profileLoad(const char *path) {
+  File f = SD.open(path, FILE_READ);
+  if (!f) return false;
+
+  char line[PROFILE_LINE_MAX + 1];
+  int len = 0;
+  int lineNo = 0;
+  for (;;) {
+    int c = f.read();
+    if (c < 0 || c == '\n') {
+      line[len] = '\0';
+      lineNo++;
+      if (!parseLine(line)) {
+        Serial.print(F("Perfil: línea "));
+        Serial.print(lineNo);
+        Serial.println(F(" inválida, se ignora"));
+      }
+      len = 0;
+      if (c < 0) break;
+    } else if (len < PROFILE_LINE_MAX) {
+      line[len++] = (char)c;
+    }
+  }
+  f.close();
+  return true;
+}
+
+/**
+ * @brief Convierte el perfil a los umbrales enteros de las tablas de zonas
+ */
+void profileApply() {
+  velZonesConfigure(athlete.vBins);
+  hrZonesConfigure(athlete.fcMax, athlete.zEdges);
+}
@@ -0,0 +1,119 @@
+/**
+ * @file dmac.cpp
+ * @brief Implementación del controlador DMA compartido
+ * @authors Juan Perez, Ana Gomez
+ * @date 2025
+ */
+
+#include "dmac.h"
+
+#if defined(ARDUINO_ARCH_SAMD)
+
+// ==================== TABLAS DE DESCRIPTORES ====================
+
+/** @brief Descriptores base (el DMAC exige alineación de 128 bits) */
+static DmacDescriptor dmacBase[DMAC_CH_COUNT] __attribute__((aligned(16)));
+
+/** @brief Área de write-back del estado de cada canal */
+static DmacDescriptor dmacWriteback[DMAC_CH_COUNT] __attribute__((aligned(16)));
+
+/** @brief Callbacks por canal */
+static DmacCallback dmacCallbacks[DMAC_CH_COUNT] = {0};
+
+static bool dmacReady = false;
+
+/**
+ * @brief Habilita el reloj del DMAC e instala las tablas de descriptores
+ */
+void dmacBegin() {
+  if (dmacReady) return;
+
+  PM->AHBMASK.reg |= PM_AHBMASK_DMAC;
+  PM->APBBMASK.reg |= PM_APBBMASK_DMAC;
+
+  DMAC->CTRL.reg &= ~DMAC_CTRL_DMAENABLE;
+  DMAC->CTRL.reg = DMAC_CTRL_SWRST;
+  while (DMAC->CTRL.reg & DMAC_CTRL_SWRST);
+
+  memset(dmacBase, 0, sizeof(dmacBase));
+  memset(dmacWriteback, 0, sizeof(dmacWriteback));
+  DMAC->BASEADDR.reg = (uint32_t)dmacBase;
+  DMAC->WRBADDR.reg = (uint32_t)dmacWriteback;
+  DMAC->CTRL.reg = DMAC_CTRL_DMAENABLE | DMAC_CTRL_LVLEN(0xf);
+
+  NVIC_SetPriority(DMAC_IRQn, 1);
+  NVIC_EnableIRQ(DMAC_IRQn);
+  dmacReady = true;
+}
+
+/**
+ * @brief Devuelve el descriptor base de un canal
+ *
+ * @param ch Canal DMA
+ * @return DmacDescriptor* Descriptor en la tabla base
+ */
+DmacDescriptor *dmacDescriptor(uint8_t ch) {
+  return &dmacBase[ch];
+}
+
+/**
+ * @brief Devuelve el estado de un canal (área de write-back)
+ *
+ * @param ch Canal DMA
+ * @return volatile DmacDescriptor* Descriptor en la tabla de write-back
+ */
+volatile DmacDescriptor *dmacStatus(uint8_t ch) {
+  return &dmacWriteback[ch];
+}
+
+/**
+ * @brief Configura un canal: disparo, prioridad y callback de fin de bloque
+ *
+ * @param ch Canal DMA
+ * @param trigSrc Fuente de disparo
+ * @param cb Callback de interrupción
+ */
+void dmacConfigChannel(uint8_t ch, uint8_t trigSrc, DmacCallback cb) {
+  dmacCallbacks[ch] = cb;
+
+  noInterrupts();
+  DMAC->CHID.reg = DMAC_CHID_ID(ch);
+  DMAC->CHCTRLA.reg &= ~DMAC_CHCTRLA_ENABLE;
+  DMAC->CHCTRLA.reg = DMAC_CHCTRLA_SWRST;
+  while (DMAC->CHCTRLA.reg & DMAC_CHCTRLA_SWRST);
+  DMAC->CHCTRLB.reg = DMAC_CHCTRLB_LVL(0) |
+                      DMAC_CHCTRLB_TRIGSRC(trigSrc) |
+                      DMAC_CHCTRLB_TRIGACT_BEAT;
+  DMAC->CHINTENSET.reg = DMAC_CHINTENSET_TCMPL | DMAC_CHINTENSET_TERR;
+  interrupts();
+}
+
+/**
+ * @brief Habilita el canal
+ *
+ * @param ch Canal DMA
+ */
+void dmacEnableChannel(uint8_t ch) {
+  noInterrupts();
+  DMAC->CHID.reg = DMAC_CHID_ID(ch);
+  DMAC->CHCTRLA.reg |= DMAC_CHCTRLA_ENABLE;
+  interrupts();
+}
+
+/**
+ * @brief Vector de interrupción del DMAC: despacha a los callbacks de canal
+ */
+extern "C" void DMAC_Handler(void) {
+  uint8_t savedCh = DMAC->CHID.reg;
+  uint32_t pending = DMAC->INTSTATUS.reg;
+  for (uint8_t ch = 0; ch < DMAC_CH_COUNT; ++ch) {
+    if (!(pending & (1UL << ch))) continue;
+    DMAC->CHID.reg = DMAC_CHID_ID(ch);
+    uint8_t flags = DMAC->CHINTFLAG.reg;
+    DMAC->CHINTFLAG.reg = flags;
+    if (dmacCallbacks[ch]) dmacCallbacks[ch](flags);
+  }
+  DMAC->CHID.reg = savedCh;
+}
+
+#endif // ARDUINO_ARCH_SAMD
@@ -0,0 +1,203 @@
+/**
+ * @file ecg_adc.cpp
+ * @brief Implementación de la adquisición de ECG por temporizador y DMA
+ * @authors Juan Perez, Ana Gomez
+ * @date 2025
+ */
+
+#include "ecg_adc.h"
+#include "ecg_decim.h"
+
+EcgAdcStats ecgAdcStats = {0, 0};
+
+#if defined(ARDUINO_ARCH_SAMD)
+
+#include <Arduino.h>
+#include "wiring_private.h"
+#include "dmac.h"
+
+// ==================== CONSTANTES ====================
+
+/** @brief Reloj de TC3: GCLK0 (48 MHz) / 64 */
+static const uint32_t ECG_TC_HZ = 48000000UL / 64;
+
+#if ECG_OVS_ON
+/** @brief Disparos del ADC por segundo */
+#define ECG_TRIG_RATE ECG_OVS_RATE
+/** @brief Lecturas del ADC por bloque */
+#define ECG_RAW_LEN (ECG_BLOCK_LEN * ECG_DECIM)
+/** @brief Posiciones libres antes de cada bloque para la cola del anterior */
+#define ECG_RAW_HEAD ECG_DECIM_TAPS
+#else
+#define ECG_TRIG_RATE SAMPLE_RATE
+#define ECG_RAW_LEN ECG_BLOCK_LEN
+#define ECG_RAW_HEAD 0
+#endif
+
+/** @brief Valor de tope de TC3 para desbordar a ECG_TRIG_RATE */
+static const uint32_t ECG_TC_TOP = ECG_TC_HZ / ECG_TRIG_RATE - 1;
+
+static_assert(ECG_TC_HZ / ECG_TRIG_RATE - 1 <= 0xFFFF, "SAMPLE_RATE demasiado bajo para TC3");
+
+#if ECG_OVS_ON
+/** @brief Reloj del ADC: GCLK0 (48 MHz) / 128 */
+static const uint32_t ECG_ADC_HZ = 48000000UL / 128;
+
+/** @brief Ciclos del ADC por conversión: muestreo (SAMPLEN + 1) / 2 y 12 bits a 2 por ciclo */
+static const uint32_t ECG_ADC_CONV_CLK = (15 + 1) / 2 + 12 / 2;
+
+static_assert(ECG_OVS_RATE * ECG_ADC_AVG * ECG_ADC_CONV_CLK < ECG_ADC_HZ,
+              "El ADC no alcanza ECG_ADC_AVG conversiones por disparo a SAMPLE_RATE * ECG_DECIM");
+#endif
+
+/** @brief Canal del sistema de eventos TC3 -> ADC */
+static const uint8_t ECG_EVSYS_CH = 0;
+
+// ==================== BUFFERS PING-PONG ====================
+
+static uint16_t ecgBuf[2][ECG_RAW_HEAD + ECG_RAW_LEN];
+
+#if ECG_OVS_ON
+static EcgDecimator decim;               ///< Estado del diezmado entre bloques
+static uint16_t ecgOut[ECG_BLOCK_LEN];   ///< Último bloque diezmado
+#endif
+
+/** @brief Descriptor del segundo buffer (el primero está en la tabla base) */
+static DmacDescriptor ecgPongDesc __attribute__((aligned(16)));
+
+static volatile uint32_t blocksDone = 0;  ///< Bloques completados por el DMA
+static uint32_t blocksRead = 0;           ///< Bloques entregados al consumidor
+static EcgBlockCallback blockCb = nullptr;
+
+/**
+ * @brief Fin de bloque del DMA (contexto de interrupción)
+ */
+static void onEcgBlock(uint8_t flags) {
+  if (flags & DMAC_CHINTFLAG_TCMPL) {
+    blocksDone++;
+    if (blockCb) blockCb();
+  }
+}
+
+/**
+ * @brief Llena un descriptor que copia ECG_RAW_LEN resultados del ADC
+ */
+static void fillDescriptor(DmacDescriptor *d, uint16_t *buf, DmacDescriptor *next) {
+  d->BTCTRL.reg = DMAC_BTCTRL_VALID |
+                  DMAC_BTCTRL_BLOCKACT_INT |
+                  DMAC_BTCTRL_BEATSIZE_HWORD |
+                  DMAC_BTCTRL_DSTINC;
+  d->BTCNT.reg = ECG_RAW_LEN;
+  d->SRCADDR.reg = (uint32_t)&ADC->RESULT.reg;
+  d->DSTADDR.reg = (uint32_t)(buf + ECG_RAW_LEN);    // dirección final con DSTINC
+  d->DESCADDR.reg = (uint32_t)next;
+}
+
+static inline void syncAdc() {
+  while (ADC->STATUS.bit.SYNCBUSY);
+}
+
+static inline void syncTc3() {
+  while (TC3->COUNT16.STATUS.bit.SYNCBUSY);
+}
+
+/**
+ * @brief Configura TC3, el sistema de eventos, el ADC y el DMA e inicia el muestreo
+ *
+ * @param onBlock Función llamada al completarse cada bloque (opcional)
+ */
+void ecgAdcBegin(EcgBlockCallback onBlock) {
+  blockCb = onBlock;
+
+  // Pin analógico
+  pinPeripheral(EMG_INPUT_PIN, PIO_ANALOG);
+
+  // DMA: ping (tabla base) -> pong -> ping ...
+  dmacBegin();
+  dmacConfigChannel(DMAC_CH_ECG_ADC, ADC_DMAC_ID_RESRDY, onEcgBlock);
+  DmacDescriptor *ping = dmacDescriptor(DMAC_CH_ECG_ADC);
+  fillDescriptor(ping, ecgBuf[0] + ECG_RAW_HEAD, &ecgPongDesc);
+  fillDescriptor(&ecgPongDesc, ecgBuf[1] + ECG_RAW_HEAD, ping);
+  dmacEnableChannel(DMAC_CH_ECG_ADC);
+
+  // ADC: misma referencia y ganancia que analogRead(), inicio por evento
+  ADC->CTRLA.bit.ENABLE = 0;
+  syncAdc();
+  ADC->CTRLB.reg = ADC_CTRLB_PRESCALER_DIV128 |
+#if ECG_OVS_ON
+                   ADC_CTRLB_RESSEL_16BIT;       // acumulación: RESULT es la suma
+#elif ADC_RESOLUTION == 12
+                   ADC_CTRLB_RESSEL_12BIT;
+#elif ADC_RESOLUTION == 10
+                   ADC_CTRLB_RESSEL_10BIT;
+#else
+                   ADC_CTRLB_RESSEL_8BIT;
+#endif
+  syncAdc();
+  ADC->SAMPCTRL.reg = ADC_SAMPCTRL_SAMPLEN(15);
+#if ECG_OVS_ON
+  // ECG_ADC_AVG conversiones por disparo y un solo RESRDY; ADJRES 0 deja la suma sin dividir
+  ADC->AVGCTRL.reg = ADC_AVGCTRL_SAMPLENUM((uint8_t)__builtin_ctz(ECG_ADC_AVG)) | ADC_AVGCTRL_ADJRES(0);
+#else
+  ADC->AVGCTRL.reg = ADC_AVGCTRL_SAMPLENUM_1;
+#endif
+  ADC->REFCTRL.reg = ADC_REFCTRL_REFSEL_INTVCC1;
+  ADC->INPUTCTRL.reg = ADC_INPUTCTRL_MUXNEG_GND |
+                       ADC_INPUTCTRL_GAIN_DIV2 |
+                       ADC_INPUTCTRL_MUXPOS(g_APinDescription[EMG_INPUT_PIN].ulADCChannelNumber);
+  syncAdc();
+  ADC->EVCTRL.reg = ADC_EVCTRL_STARTEI;
+  ADC->INTFLAG.reg = ADC_INTFLAG_RESRDY;
+  ADC->CTRLA.bit.ENABLE = 1;
+  syncAdc();
+
+  // Sistema de eventos: desborde de TC3 -> inicio de conversión
+  PM->APBCMASK.reg |= PM_APBCMASK_EVSYS | PM_APBCMASK_TC3;
+  EVSYS->USER.reg = EVSYS_USER_USER(EVSYS_ID_USER_ADC_START) |
+                    EVSYS_USER_CHANNEL(ECG_EVSYS_CH + 1);
+  EVSYS->CHANNEL.reg = EVSYS_CHANNEL_CHANNEL(ECG_EVSYS_CH) |
+                       EVSYS_CHANNEL_EVGEN(EVSYS_ID_GEN_TC3_OVF) |
+                       EVSYS_CHANNEL_PATH_ASYNCHRONOUS;
+
+  // TC3 a ECG_TRIG_RATE en modo MFRQ (tope en CC0)
+  GCLK->CLKCTRL.reg = GCLK_CLKCTRL_ID_TCC2_TC3 | GCLK_CLKCTRL_GEN_GCLK0 | GCLK_CLKCTRL_CLKEN;
+  while (GCLK->STATUS.bit.SYNCBUSY);
+  TC3->COUNT16.CTRLA.reg &= ~TC_CTRLA_ENABLE;
+  syncTc3();
+  TC3->COUNT16.CTRLA.reg = TC_CTRLA_SWRST;
+  while (TC3->COUNT16.CTRLA.reg & TC_CTRLA_SWRST);
+  TC3->COUNT16.CTRLA.reg = TC_CTRLA_MODE_COUNT16 |
+                           TC_CTRLA_WAVEGEN_MFRQ |
+                           TC_CTRLA_PRESCALER_DIV64;
+  TC3->COUNT16.CC[0].reg = (uint16_t)ECG_TC_TOP;
+  syncTc3();
+  TC3->COUNT16.EVCTRL.reg = TC_EVCTRL_OVFEO;
+  TC3->COUNT16.CTRLA.reg |= TC_CTRLA_ENABLE;
+  syncTc3();
+}
+
+/**
+ * @brief Devuelve el siguiente bloque completo, si existe
+ * 
+ * @param firstSample Índice absoluto de la primera muestra del bloque
+ * @return const uint16_t* Bloque de ECG_BLOCK_LEN muestras, o nullptr
+ */
+const uint16_t *ecgAdcNextBlock(uint32_t *firstSample) {
+  uint32_t done = blocksDone;
+  if (done == blocksRead) return nullptr;
+
+  // El DMA ya está llenando el buffer de blocksRead: esos bloques se perdieron
+  if (done - blocksRead > 1) {
+    ecgAdcStats.overruns += done - blocksRead - 1;
+    blocksRead = done - 1;
+  }
+  *firstSample = blocksRead * (uint32_t)ECG_BLOCK_LEN;
+#if ECG_OVS_ON
+  decim.process(ecgBuf[blocksRead++ & 1] + ECG_RAW_HEAD, ecgOut, ECG_BLOCK_LEN);
+  return ecgOut;
+#else
+  return ecgBuf[blocksRead++ & 1];
+#endif
+}
+
+#endif // ARDUINO_ARCH_SAMD
@@ -0,0 +1,195 @@
+/**
+ * @file ecg_capture.cpp
+ * @brief Captura de la forma de onda ECG en un archivo contiguo de la SD
+ * @authors Juan Perez, Ana Gomez
+ * @date 2025
+ */
+
+#include <Arduino.h>
+#include <SD.h>
+#include <string.h>
+#include "ecg_capture.h"
+#include "config.h"
+
+#if ECG_CAPTURE
+
+static_assert(CAPTURE_SECTORS >= 2, "La captura necesita al menos dos sectores (doble buffer)");
+
+static Sd2Card card;                     ///< Acceso por bloques, independiente de SD
+static SdVolume volume;
+
+static uint32_t dataBlock = 0;           ///< Primer bloque de datos en la tarjeta
+static uint32_t dataSectors = 0;         ///< Sectores de datos preasignados
+static uint32_t nextSector = 0;          ///< Siguiente sector de datos por escribir
+static volatile bool active = false;
+
+static CaptureSector ring[CAPTURE_SECTORS];  ///< ring[filled % CAPTURE_SECTORS] es el que se llena
+static volatile uint32_t filled = 0;     ///< Sectores cerrados por la tarea ECG
+static volatile uint32_t written = 0;    ///< Sectores liberados por la tarea diferida
+static CaptureStats st;
+
+// ==================== FUNCIONES INTERNAS ====================
+
+/** @brief Redondea y satura a 16 bits con signo */
+static int16_t toI16(float v) {
+  if (v >= 32767.0f) return 32767;
+  if (v <= -32768.0f) return -32768;
+  return (int16_t)(v < 0 ? v - 0.5f : v + 0.5f);
+}
+
+/**
+ * @brief Cierra el sector en curso y pasa al siguiente buffer
+ *
+ * Si todos los demás buffers esperan a la tarjeta, el sector se descarta y
+ * se vuelve a llenar el mismo buffer.
+ */
+static void closeSector() {
+  if (filled - written >= CAPTURE_SECTORS - 1) {
+    st.dropped++;
+  } else {
+    filled++;
+  }
+  ring[filled % CAPTURE_SECTORS].count = 0;
+}
+
+/**
+ * @brief Busca el primer nombre ECGnn.BIN libre
+ */
+static bool freeName(SdFile &root, char *name) {
+  for (int n = 0; n < 100; n++) {
+    name[3] = (char)('0' + n / 10);
+    name[4] = (char)('0' + n % 10);
+    SdFile f;
+    if (!f.open(&root, name, O_READ)) return true;
+    f.close();
+  }
+  return false;
+}
+
+// ==================== INTERFAZ ====================
+
+/**
+ * @brief Crea y preasigna el archivo de captura
+ *
+ * @param csPin Pin CS de la tarjeta
+ * @return true Si la captura quedó activa
+ */
+bool captureBegin(uint8_t csPin) {
+  Serial.print(F("Captura ECG... "));
+  if (!card.init(SPI_HALF_SPEED, csPin) || !volume.init(&card)) {
+    Serial.println(F("ERROR: tarjeta"));
+    return false;
+  }
+  SdFile root;
+  if (!root.openRoot(&volume)) {
+    Serial.println(F("ERROR: directorio raiz"));
+    return false;
+  }
+
+  char name[] = "ECG00.BIN";
+  uint32_t sectors = (uint32_t)CAPTURE_MINUTES * 60UL * SAMPLE_RATE / CAPTURE_PER_SECTOR + 1;
+  SdFile file;
+  uint32_t bgn = 0, end = 0;
+  bool ok = freeName(root, name) &&
+            file.createContiguous(&root, name, (sectors + 1) * 512UL) &&
+            file.contiguousRange(&bgn, &end);
+  file.close();
+  root.close();
+  if (!ok) {
+    Serial.println(F("ERROR: sin espacio contiguo"));
+    return false;
+  }
+
+  // Borrar la región para que el lector no confunda datos de otra captura
+  // (queda en 0x00 o en 0xFF según la tarjeta; captureSectorErased() acepta ambos)
+  card.erase(bgn + 1, bgn + sectors);
+
+  CaptureFileHeader h;
+  memset(&h, 0, sizeof(h));
+  memcpy(h.magic, "WECG", 4);
+  h.version = CAPTURE_VERSION;
+  h.sampleRate = SAMPLE_RATE;
+  h.adcBits = ECG_SAMPLE_BITS;
+  h.perSector = CAPTURE_PER_SECTOR;
+  h.startMs = millis();
+  h.dataSectors = sectors;
+  h.crc = crc16Ccitt(&h, offsetof(CaptureFileHeader, crc));
+  if (!card.writeBlock(bgn, (const uint8_t *)&h)) {
+    Serial.println(F("ERROR: escritura"));
+    return false;
+  }
+
+  dataBlock = bgn + 1;
+  dataSectors = sectors;
+  nextSector = 0;
+  filled = written = 0;
+  ring[0].count = 0;
+  active = true;
+  Serial.print(name);
+  Serial.print(F(" ("));
+  Serial.print(sectors / 2048);
+  Serial.println(F(" MB)"));
+  return true;
+}
+
+/**
+ * @brief Agrega una muestra (contexto de la tarea ECG; no accede a la tarjeta)
+ *
+ * Un salto en el índice (bloque del ADC perdido) cierra el sector, así que
+ * las muestras de un sector son siempre consecutivas.
+ */
+void capturePush(uint32_t index, uint16_t raw, float filt) {
+  if (!active) return;
+  CaptureSector *s = &ring[filled % CAPTURE_SECTORS];
+  if (s->count > 0 && index != s->firstSample + s->count) {
+    closeSector();
+    s = &ring[filled % CAPTURE_SECTORS];
+  }
+  if (s->count == 0) s->firstSample = index;
+  s->s[s->count].raw = raw;
+  s->s[s->count].filt = toI16(filt);
+  if (++s->count == CAPTURE_PER_SECTOR) closeSector();
+}
+
+/**
+ * @brief Escribe los sectores llenos pendientes (tarea diferida)
+ *
+ * El buffer se libera solo después de escribirlo; mientras tanto la tarea
+ * ECG sigue llenando los demás.
+ */
+void captureService() {
+  while (active && written != filled) {
+    if (nextSector >= dataSectors) {
+      active = false;
+      Serial.println(F("Captura ECG: archivo lleno"));
+      break;
+    }
+    CaptureSector &s = ring[written % CAPTURE_SECTORS];
+    s.crc = captureSectorCrc(s);
+    uint32_t t0 = micros();
+    bool ok = card.writeBlock(dataBlock + nextSector, (const uint8_t *)&s);
+    uint32_t dt = micros() - t0;
+    if (dt > st.writeMaxUs) st.writeMaxUs = dt;
+    if (ok) st.sectors++;
+    else st.errors++;
+    nextSector++;
+    written++;
+  }
+}
+
+bool captureActive() {
+  return active;
+}
+
+/**
+ * @brief Copia las estadísticas y reinicia la latencia máxima
+ */
+CaptureStats captureTakeStats() {
+  noInterrupts();
+  CaptureStats s = st;
+  st.writeMaxUs = 0;
+  interrupts();
+  return s;
+}
+
+#endif // ECG_CAPTURE
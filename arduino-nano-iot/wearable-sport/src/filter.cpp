@@ -5,29 +5,106 @@
  * @date 2025
  */
 
+#include "config.h"
 #include "filter.h"
+#include "biquad_fixed.h"
+#include "filter_design.h"
+
+// ==================== DISEÑO DE LA CASCADA ====================
+
+/**
+ * @brief Etapa k de la cascada ECG, calculada en compilación
+ * 
+ * Etapas 0-1: pasa-bajas Butterworth de 4o orden en ECG_LP_HZ.
+ * Etapas 2-3: pasa-altas Butterworth de 4o orden en ECG_HP_HZ.
+ * Etapa 4: notch en ECG_NOTCH_HZ (si ECG_NOTCH_ON).
+ */
+static constexpr Biquad ecgStage(int k) {
+  return k < 4 ? fdesign::butterBandpass(ECG_HP_HZ, ECG_LP_HZ, SAMPLE_RATE, 4, k)
+               : fdesign::notch(ECG_NOTCH_HZ, SAMPLE_RATE, ECG_NOTCH_Q);
+}
+
+/** @brief Verifica en compilación que todas las etapas sean estables */
+static constexpr bool ecgStagesStable(int k) {
+  return k >= SOS_STAGES || (fdesign::isStable(ecgStage(k)) && ecgStagesStable(k + 1));
+}
+
+static_assert(ECG_LP_HZ * 2 < SAMPLE_RATE, "ECG_LP_HZ debe ser menor que SAMPLE_RATE / 2");
+static_assert(ECG_HP_HZ < ECG_LP_HZ, "ECG_HP_HZ debe ser menor que ECG_LP_HZ");
+static_assert(ecgStagesStable(0), "Cascada ECG inestable");
+
+/** @brief Lista de inicialización de las etapas, aplicando F a cada índice */
+#if ECG_NOTCH_ON
+#define ECG_SOS_INIT(F) F(0), F(1), F(2), F(3), F(4)
+#else
+#define ECG_SOS_INIT(F) F(0), F(1), F(2), F(3)
+#endif
 
 /**
  * @brief Banco de filtros biquad en cascada para filtrado de señal ECG
  * 
- * Configuración de 4 etapas de filtros para eliminar ruido y artefactos
- * de la señal cardíaca
+ * Los coeficientes se generan en compilación a partir de SAMPLE_RATE y de
+ * las frecuencias de corte de config.h.
+ */
+Biquad sos[SOS_STAGES] = { ECG_SOS_INIT(ecgStage) };
+
+// ==================== MOTOR DE PUNTO FIJO ====================
+
+#if FILTER_ENGINE == FILTER_Q15
+typedef BiquadCascade<Q15, SOS_STAGES> EcgCascade;
+/** @brief Bits de la entrada en Q15 (deja 1 bit de margen) */
+#define FILTER_Q_BITS 14
+
+/**
+ * @brief Menor ECG_HP_HZ / SAMPLE_RATE con el que Q15 sigue a la versión float
+ *
+ * Con polos del pasa-altas más cerca de 1 la cuantización a Q2.13 cambia la
+ * respuesta en baja frecuencia. Medido con bench_biquad a 250 Hz: 2 Hz da
+ * error máximo de 2.7 cuentas, 1 Hz de 14 y 0.5 Hz de 144.
  */
-Biquad sos[] = {
-  {0.37373487f,  0.74746975f,  0.37373487f,   1.02830960f,  0.28774614f, 0, 0},
-  {1.00000000f,  2.00000000f,  1.00000000f,   1.32440218f,  0.64037407f, 0, 0},
-  {1.00000000f, -2.00000000f,  1.00000000f,  -1.80939660f,  0.81997336f, 0, 0},
-  {1.00000000f, -2.00000000f,  1.00000000f,  -1.91424301f,  0.92488759f, 0, 0}
-};
+static constexpr double FILTER_Q15_MIN_HP = 0.008;
+static_assert((double)ECG_HP_HZ / SAMPLE_RATE >= FILTER_Q15_MIN_HP,
+              "FILTER_Q15 no alcanza la tolerancia con ECG_HP_HZ / SAMPLE_RATE < 0.008: usar FILTER_Q31");
+#elif FILTER_ENGINE == FILTER_Q31
+typedef BiquadCascade<Q31, SOS_STAGES> EcgCascade;
+/** @brief Bits de la entrada en Q31 (deja 3 bits de margen) */
+#define FILTER_Q_BITS 28
+#endif
+
+#if FILTER_ENGINE != FILTER_FLOAT
+/** @brief Mitad de escala de la muestra (nivel de DC de la entrada) */
+static const int ADC_MID = 1 << (ECG_SAMPLE_BITS - 1);
+
+/** @brief Muestra centrada al formato Q (Q15 descarta los bits que no caben) */
+#if FILTER_Q_BITS >= ECG_SAMPLE_BITS
+#define FILTER_TO_Q(v) ((EcgCascade::sample_t)(((v) - ADC_MID) * (1L << (FILTER_Q_BITS - ECG_SAMPLE_BITS))))
+#else
+#define FILTER_TO_Q(v) ((EcgCascade::sample_t)(((v) - ADC_MID) >> (ECG_SAMPLE_BITS - FILTER_Q_BITS)))
+#endif
+
+/** @brief Factor para regresar la salida a cuentas del ADC (ADC_RESOLUTION bits) */
+static const float FILTER_OUT_SCALE = 1.0f / (float)(1L << (FILTER_Q_BITS - ADC_RESOLUTION));
+
+#define ECG_STAGE_Q(k) EcgCascade::Stage::from(ecgStage(k))
+
+/** @brief Coeficientes en punto fijo, convertidos en compilación (flash) */
+static constexpr EcgCascade::Stage SOS_FIXED[] = { ECG_SOS_INIT(ECG_STAGE_Q) };
+
+/** @brief Cascada en punto fijo con los mismos coeficientes que sos[] */
+static EcgCascade ecgCascade(SOS_FIXED);
+#else
+/** @brief Factor de las muestras de la adquisición a cuentas del ADC */
+static const float FILTER_IN_SCALE = 1.0f / (float)(1L << (ECG_SAMPLE_BITS - ADC_RESOLUTION));
+#endif
 
 /**
- * @brief Aplica el banco de filtros biquad a una muestra
+ * @brief Aplica la cascada float de referencia (sos) a una muestra
  * 
  * @param x Muestra de entrada sin filtrar
  * @return float Muestra filtrada
  */
-float filterSample(float x) {
-  for (int i = 0; i < (int)(sizeof(sos) / sizeof(sos[0])); ++i) {
+float filterSampleFloat(float x) {
+  for (int i = 0; i < SOS_STAGES; ++i) {
     Biquad &s = sos[i];
     float y = s.b0 * x + s.z1;
     s.z1    = s.b1 * x - s.a1 * y + s.z2;
@@ -36,3 +113,48 @@ float filterSample(float x) {
   }
   return x;
 }
+
+/**
+ * @brief Filtra una lectura cruda del ADC sin pasar por float en la entrada
+ * 
+ * @param adc Muestra de la adquisición (0 a 2^ECG_SAMPLE_BITS - 1)
+ * @return float Muestra filtrada en cuentas del ADC
+ */
+float filterAdcSample(int adc) {
+#if FILTER_ENGINE == FILTER_FLOAT
+  return filterSampleFloat((float)adc * FILTER_IN_SCALE);
+#else
+  return (float)ecgCascade.process(FILTER_TO_Q(adc)) * FILTER_OUT_SCALE;
+#endif
+}
+
+/**
+ * @brief Filtra un bloque completo de lecturas del ADC
+ * 
+ * @param in Muestras de la adquisición (ECG_SAMPLE_BITS bits)
+ * @param out Muestras filtradas en cuentas del ADC
+ * @param n Número de muestras
+ */
+void filterAdcBlock(const uint16_t *in, float *out, int n) {
+  for (int i = 0; i < n; ++i) {
+#if FILTER_ENGINE == FILTER_FLOAT
+    out[i] = filterSampleFloat((float)in[i] * FILTER_IN_SCALE);
+#else
+    out[i] = (float)ecgCascade.process(FILTER_TO_Q(in[i])) * FILTER_OUT_SCALE;
+#endif
+  }
+}
+
+/**
+ * @brief Aplica el banco de filtros biquad a una muestra
+ * 
+ * @param x Muestra de entrada sin filtrar
+ * @return float Muestra filtrada
+ */
+float filterSample(float x) {
+#if FILTER_ENGINE == FILTER_FLOAT
+  return filterSampleFloat(x);
+#else
+  return filterAdcSample((int)x);
+#endif
+}
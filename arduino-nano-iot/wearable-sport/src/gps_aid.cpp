@@ -0,0 +1,159 @@
+/**
+ * @file gps_aid.cpp
+ * @brief Arranque en caliente del GPS: guardado y envío de la ayuda
+ * @authors Juan Perez, Ana Gomez
+ * @date 2025
+ */
+
+#include <Arduino.h>
+#include <SD.h>
+#include <string.h>
+#include "gps_aid.h"
+#include "config.h"
+#include "gps_fix.h"
+#include "session_log.h"
+#include "ubx.h"
+
+#if GPS_AID
+
+static GpsAidHeader aid;                 ///< Última posición (la del archivo hasta el primer fix)
+static bool havePos = false;             ///< aid contiene una posición
+static uint8_t dbd[GPS_AID_DBD_BYTES];   ///< Entradas [longitud][carga útil] de MGA-DBD
+static uint16_t dbdLen = 0;              ///< Bytes usados de dbd
+static bool dbdPolled = false;           ///< Volcado pedido y aún no guardado: se aceptan tramas
+static bool dbdPending = false;          ///< Volcado pedido: la primera trama reemplaza el anterior
+static uint32_t minutes = 0;             ///< Llamadas a gpsAidMinute()
+
+static const char AID_MAGIC[4] = {'W', 'S', 'G', 'A'};
+
+// ==================== FUNCIONES INTERNAS ====================
+
+/**
+ * @brief Escribe GPS_AID_FILENAME completo (encabezado y volcado)
+ */
+static bool aidSave() {
+  memcpy(aid.magic, AID_MAGIC, 4);
+  aid.version = GPS_AID_VERSION;
+  aid.dbdBytes = dbdLen;
+  aid.dbdCrc = crc16Ccitt(dbd, dbdLen);
+  aid.crc = crc16Ccitt(&aid, offsetof(GpsAidHeader, crc));
+
+  SD.remove(GPS_AID_FILENAME);           // FILE_WRITE agrega al final
+  File f = SD.open(GPS_AID_FILENAME, FILE_WRITE);
+  if (!f) return false;
+  bool ok = f.write((const uint8_t *)&aid, sizeof(aid)) == sizeof(aid) &&
+            f.write(dbd, dbdLen) == dbdLen;
+  f.close();
+  return ok;
+}
+
+// ==================== INTERFAZ ====================
+
+/**
+ * @brief Lee GPS_AID_FILENAME de la SD
+ */
+bool gpsAidLoad() {
+  File f = SD.open(GPS_AID_FILENAME, FILE_READ);
+  if (!f) return false;
+  GpsAidHeader h;
+  bool ok = f.read(&h, sizeof(h)) == (int)sizeof(h) &&
+            memcmp(h.magic, AID_MAGIC, 4) == 0 &&
+            h.version == GPS_AID_VERSION &&
+            h.crc == crc16Ccitt(&h, offsetof(GpsAidHeader, crc));
+  if (ok) {
+    aid = h;
+    havePos = true;
+    // El volcado se descarta entero si no cabe o está dañado
+    if (h.dbdBytes <= sizeof(dbd) && f.read(dbd, h.dbdBytes) == (int)h.dbdBytes &&
+        crc16Ccitt(dbd, h.dbdBytes) == h.dbdCrc) {
+      dbdLen = h.dbdBytes;
+    }
+  }
+  f.close();
+  return ok;
+}
+
+/**
+ * @brief Envía al receptor la posición y la base de navegación leídas
+ */
+void gpsAidPush(HardwareSerial &port) {
+  if (!havePos) return;
+
+  // MGA-INI-POS_LLH: tipo 1, versión 0, reservado, lat, lon, alt (cm), precisión (cm)
+  uint32_t accCm = aid.hAccMm / 10;
+  if (accCm < GPS_AID_POS_ACC_M * 100UL) accCm = GPS_AID_POS_ACC_M * 100UL;
+  uint8_t pos[20];
+  memset(pos, 0, sizeof(pos));
+  pos[0] = 0x01;
+  memcpy(pos + 4, &aid.latE7, 4);
+  memcpy(pos + 8, &aid.lonE7, 4);
+  memcpy(pos + 12, &aid.altCm, 4);
+  memcpy(pos + 16, &accCm, 4);
+  ubxSend(port, UBX_CLASS_MGA, UBX_MGA_INI, pos, sizeof(pos));
+
+  // MGA-DBD en el orden en que llegaron; flush() evita saturar el buffer RX del receptor
+  uint16_t i = 0;
+  while (i + 2 <= dbdLen) {
+    uint16_t len = dbd[i] | (uint16_t)dbd[i + 1] << 8;
+    if (i + 2 + len > dbdLen) break;
+    port.flush();
+    ubxSend(port, UBX_CLASS_MGA, UBX_MGA_DBD, dbd + i + 2, len);
+    i += 2 + len;
+  }
+  port.flush();
+}
+
+/**
+ * @brief Guarda un MGA-DBD recibido
+ */
+void gpsAidDbd(const uint8_t *payload, uint16_t len) {
+  if (!dbdPolled) return;                // Tardía o sin pedir: no se mezcla con el volcado guardado
+  if (dbdPending) {
+    dbdLen = 0;
+    dbdPending = false;
+  }
+  if (dbdLen + 2U + len > sizeof(dbd)) return;  // Lo que no cabe se pierde; el resto sigue siendo útil
+  dbd[dbdLen] = (uint8_t)len;
+  dbd[dbdLen + 1] = (uint8_t)(len >> 8);
+  memcpy(dbd + dbdLen + 2, payload, len);
+  dbdLen += 2 + len;
+}
+
+/**
+ * @brief Actualiza la última posición; pide el volcado y guarda el archivo según GPS_AID_SAVE_MIN
+ */
+void gpsAidMinute(HardwareSerial &port, const GpsFix &fix) {
+  if (fix.has(GPS_LOCATION)) {
+    aid.latE7 = fix.latE7;
+    aid.lonE7 = fix.lonE7;
+    aid.altCm = fix.has(GPS_ALTITUDE) ? fix.altCm : 0;
+    aid.hAccMm = fix.hAccMm;
+    if (fix.has(GPS_DATE | GPS_TIME)) {
+      aid.utcDate = fix.utcDate();
+      aid.utcTimeMs = fix.utcMs();
+    } else {
+      aid.utcDate = 0;
+      aid.utcTimeMs = 0;
+    }
+    havePos = true;
+  }
+
+  minutes++;
+  uint32_t phase = minutes % GPS_AID_SAVE_MIN;
+#if GPS_PROTOCOL == GPS_UBX
+  // Un MGA-DBD sin carga útil pide el volcado completo
+  if (phase == GPS_AID_SAVE_MIN - 1) {
+    dbdPolled = dbdPending = true;
+    ubxSend(port, UBX_CLASS_MGA, UBX_MGA_DBD, nullptr, 0);
+  }
+#else
+  (void)port;
+#endif
+  if (phase == 0) {
+    // Sin respuesta se conserva el volcado anterior; lo que llegue después se descarta
+    dbdPolled = dbdPending = false;
+    if (havePos && !aidSave()) Serial.println(F("Error al guardar " GPS_AID_FILENAME));
+  }
+}
+
+#endif // GPS_AID
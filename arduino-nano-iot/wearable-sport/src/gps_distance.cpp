@@ -0,0 +1,189 @@
+/**
+ * @file gps_distance.cpp
+ * @brief Implementación de la distancia por fusión velocidad/posición
+ * @authors Juan Perez, Ana Gomez
+ * @date 2025
+ */
+
+#include <math.h>
+#include <stdlib.h>
+#include "gps_distance.h"
+#include "config.h"
+
+// ==================== GEODESIA ====================
+
+/** @brief Metros por 1e-7 grados de arco (radio medio de 6371008.8 m) */
+static const float M_PER_E7 = 0.0111319491f;
+
+/** @brief Radianes por 1e-7 grados */
+static const float RAD_PER_E7 = 1.74532925e-9f;
+
+static const float EARTH_R_M = 6371008.8f;
+
+/** @brief Cambio de latitud que obliga a recalcular cos(latitud) (0.01°) */
+static const int32_t COS_REFRESH_E7 = 100000;
+
+/** @brief Límites de la aproximación equirrectangular */
+static const float EQ_MAX_M = 1000.0f;
+static const int32_t EQ_MAX_LAT_E7 = 800000000;
+
+static bool cosValid = false;
+static int32_t cosLatE7 = 0;
+static float cosLat = 1.0f;
+
+/**
+ * @brief cos(latitud) en caché; error relativo < 0.03 % bajo 80°
+ */
+static float cosLatitude(int32_t latE7) {
+  int32_t d = latE7 - cosLatE7;
+  if (!cosValid || d > COS_REFRESH_E7 || d < -COS_REFRESH_E7) {
+    cosValid = true;
+    cosLatE7 = latE7;
+    cosLat = cosf(latE7 * RAD_PER_E7);
+  }
+  return cosLat;
+}
+
+/** @brief Diferencia de longitud en (-180°, 180°] */
+static int32_t lonDelta(int32_t lonA, int32_t lonB) {
+  int64_t d = (int64_t)lonB - lonA;
+  if (d > 1800000000LL) d -= 3600000000LL;
+  if (d <= -1800000000LL) d += 3600000000LL;
+  return (int32_t)d;
+}
+
+static float haversine(int32_t latA, int32_t latB, int32_t dLat, int32_t dLon) {
+  float sLat = sinf(dLat * (0.5f * RAD_PER_E7));
+  float sLon = sinf(dLon * (0.5f * RAD_PER_E7));
+  float a = sLat * sLat + cosf(latA * RAD_PER_E7) * cosf(latB * RAD_PER_E7) * sLon * sLon;
+  if (a > 1.0f) a = 1.0f;
+  return 2.0f * EARTH_R_M * asinf(sqrtf(a));
+}
+
+float gpsDistanceM(int32_t latE7A, int32_t lonE7A, int32_t latE7B, int32_t lonE7B) {
+  int32_t dLat = latE7B - latE7A;
+  int32_t dLon = lonDelta(lonE7A, lonE7B);
+  int32_t midLat = latE7A + dLat / 2;
+  if (abs(midLat) <= EQ_MAX_LAT_E7) {
+    float y = dLat * M_PER_E7;
+    float x = dLon * M_PER_E7 * cosLatitude(midLat);
+    float d = sqrtf(x * x + y * y);
+    if (d <= EQ_MAX_M) return d;
+  }
+  return haversine(latE7A, latE7B, dLat, dLon);
+}
+
+// ==================== FUSIÓN ====================
+
+static bool haveAnchor = false;
+static int32_t anchorLat = 0, anchorLon = 0;
+static float anchorVar = 0.0f;           ///< σ² de la posición del ancla (m²)
+static float segDopplerM = 0.0f;         ///< Distancia por velocidad desde el ancla
+static uint32_t segMs = 0;
+
+static int32_t lastLat = 0, lastLon = 0; ///< Última posición aceptada
+static uint32_t sinceLastMs = 0;
+
+static float pendingM = 0.0f;            ///< Corrección negativa aún no descontada
+static GpsDistanceStats stats = {0, 0, 0, 0, 0};
+
+void gpsDistanceReset() {
+  haveAnchor = false;
+  segDopplerM = 0.0f;
+  segMs = 0;
+}
+
+/** @brief σ² de una posición a partir de hAcc (UBX) o del HDOP (NMEA) */
+static float positionVar(const GpsFix &fix) {
+  float s = fix.hAccMm ? fix.hAccMm * 0.001f
+                       : (fix.has(GPS_HDOP) ? fix.hdop * 0.01f : 1.0f) * GPS_UERE_M;
+  return s * s;
+}
+
+/** @brief Mueve el ancla a la posición actual y abre un tramo nuevo */
+static void setAnchor(const GpsFix &fix, float var) {
+  haveAnchor = true;
+  anchorLat = fix.latE7;
+  anchorLon = fix.lonE7;
+  anchorVar = var;
+  segDopplerM = 0.0f;
+  segMs = 0;
+}
+
+/**
+ * @brief Procesa una posición nueva
+ *
+ * @return float Corrección de distancia al cerrar un tramo (m), 0 si no cierra
+ */
+static float positionUpdate(const GpsFix &fix) {
+  if (fix.has(GPS_HDOP) && fix.hdop > GPS_HDOP_MAX) {
+    stats.rejected++;
+    return 0.0f;
+  }
+  float var = positionVar(fix);
+  if (!haveAnchor) {
+    setAnchor(fix, var);
+    lastLat = fix.latE7;
+    lastLon = fix.lonE7;
+    sinceLastMs = 0;
+    return 0.0f;
+  }
+
+  // Salto imposible respecto a la última posición aceptada
+  float step = gpsDistanceM(lastLat, lastLon, fix.latE7, fix.lonE7);
+  if (step * 3600.0f > (float)GPS_MAX_KMH * sinceLastMs) {
+    stats.rejected++;
+    return 0.0f;
+  }
+  lastLat = fix.latE7;
+  lastLon = fix.lonE7;
+  sinceLastMs = 0;
+
+  float chord = gpsDistanceM(anchorLat, anchorLon, fix.latE7, fix.lonE7);
+  float varP = anchorVar + var;
+  float minM = 3.0f * sqrtf(varP);
+  if (minM < GPS_SEG_MIN_M) minM = GPS_SEG_MIN_M;
+  if (chord < minM) {
+    if (segMs >= GPS_SEG_MAX_MS) setAnchor(fix, var);
+    return 0.0f;
+  }
+
+  // Pesos inversos a las varianzas de la cuerda y de la distancia Doppler
+  float sigmaV = GPS_SPEED_SIGMA_KMH / 3.6f * segMs * 0.001f;
+  float varV = sigmaV * sigmaV;
+  float corr = varV / (varP + varV) * (chord - segDopplerM);
+  stats.positionM += chord;
+  stats.segments++;
+  setAnchor(fix, var);
+  return corr;
+}
+
+float gpsDistanceStep(const GpsFix &fix, float v_kmh, uint32_t dtMs) {
+  float d = v_kmh / 3.6f * dtMs * 0.001f;
+  stats.dopplerM += d;
+  segDopplerM += d;
+  segMs += dtMs;
+  sinceLastMs += dtMs;
+
+  if (fix.updated & GPS_LOCATION) {
+    float corr = positionUpdate(fix);
+    stats.correctionM += corr;
+    pendingM += corr;
+  }
+
+  // Una corrección negativa se descuenta de las épocas siguientes
+  d += pendingM;
+  if (d < 0.0f) {
+    pendingM = d;
+    return 0.0f;
+  }
+  pendingM = 0.0f;
+  return d;
+}
+
+GpsDistanceStats gpsDistanceTakeStats() {
+  GpsDistanceStats s = stats;
+  stats.dopplerM = stats.positionM = stats.correctionM = 0.0f;
+  stats.segments = stats.rejected = 0;
+  return s;
+}
@@ -14,7 +14,7 @@ const float V_THRESH_KMH = 0.7;
 
 // ==================== VARIABLES GPS ====================
 
-TinyGPSPlus gps;
+GpsParser gps;
 
 float vbuf[5] = {0};
 int vidx = 0;
@@ -0,0 +1,140 @@
+/**
+ * @file gps_uart.cpp
+ * @brief Implementación de la recepción del GPS por DMA
+ * @authors Juan Perez, Ana Gomez
+ * @date 2025
+ */
+
+#include <Arduino.h>
+#include <string.h>
+#include "gps_uart.h"
+
+static GpsUartStats stats = {0, 0, 0};
+
+#if defined(ARDUINO_ARCH_SAMD) && GPS_RX_MODE == GPS_RX_DMA
+
+#include "dmac.h"
+
+static_assert((GPS_RX_RING & (GPS_RX_RING - 1)) == 0, "GPS_RX_RING debe ser potencia de 2");
+
+// ==================== CONSTANTES ====================
+
+/** @brief SERCOM de Serial1 en el Nano 33 IoT (pines 0/1) */
+#define GPS_SERCOM        SERCOM5
+#define GPS_DMAC_TRIGGER  SERCOM5_DMAC_ID_RX
+
+// ==================== ANILLO ====================
+
+static uint8_t ring[GPS_RX_RING];
+
+static volatile uint32_t laps = 0;       ///< Vueltas completas del DMA
+static uint32_t head = 0;                ///< Bytes escritos por el DMA (última lectura)
+static uint32_t tail = 0;                ///< Bytes leídos por el consumidor
+
+/**
+ * @brief Fin de vuelta del DMA (contexto de interrupción)
+ */
+static void onLap(uint8_t flags) {
+  if (flags & DMAC_CHINTFLAG_TCMPL) laps++;
+}
+
+/**
+ * @brief Bytes escritos por el DMA desde gpsUartBegin()
+ */
+static uint32_t written() {
+  volatile DmacDescriptor *st = dmacStatus(DMAC_CH_GPS_RX);
+  uint32_t l, left;
+  do {
+    l = laps;
+    left = st->BTCNT.reg;
+  } while (l != laps);
+  uint32_t w = l * GPS_RX_RING + (GPS_RX_RING - left);
+  // El descriptor se recargó pero la interrupción de la vuelta aún no corre
+  if (w < head) w += GPS_RX_RING;
+  head = w;
+  return w;
+}
+
+// ==================== INTERFAZ ====================
+
+/**
+ * @brief Inicia la recepción por DMA
+ */
+void gpsUartBegin() {
+  // El core ya no lee DATA en su interrupción de RX; la de TX sigue activa
+  GPS_SERCOM->USART.INTENCLR.reg = SERCOM_USART_INTENCLR_RXC;
+  while (Serial1.available()) Serial1.read();
+
+  dmacBegin();
+  dmacConfigChannel(DMAC_CH_GPS_RX, GPS_DMAC_TRIGGER, onLap);
+  DmacDescriptor *d = dmacDescriptor(DMAC_CH_GPS_RX);
+  d->BTCTRL.reg = DMAC_BTCTRL_VALID |
+                  DMAC_BTCTRL_BLOCKACT_INT |
+                  DMAC_BTCTRL_BEATSIZE_BYTE |
+                  DMAC_BTCTRL_DSTINC;
+  d->BTCNT.reg = GPS_RX_RING;
+  d->SRCADDR.reg = (uint32_t)&GPS_SERCOM->USART.DATA.reg;
+  d->DSTADDR.reg = (uint32_t)(ring + GPS_RX_RING);  // dirección final con DSTINC
+  d->DESCADDR.reg = (uint32_t)d;                    // el anillo: el descriptor se repite
+  dmacStatus(DMAC_CH_GPS_RX)->BTCNT.reg = GPS_RX_RING;
+  dmacEnableChannel(DMAC_CH_GPS_RX);
+}
+
+/**
+ * @brief Bytes recibidos contiguos en memoria
+ */
+size_t gpsUartPeek(const uint8_t **data) {
+  uint32_t n = written() - tail;
+  if (n > GPS_RX_RING) {
+    stats.overruns += n - GPS_RX_RING;
+    tail += n - GPS_RX_RING;
+    n = GPS_RX_RING;
+  }
+  if (n > stats.maxFill) stats.maxFill = n;
+  uint32_t at = tail & (GPS_RX_RING - 1);
+  if (n > GPS_RX_RING - at) n = GPS_RX_RING - at;
+  *data = ring + at;
+  return n;
+}
+
+/**
+ * @brief Marca como leídos los bytes entregados por gpsUartPeek()
+ */
+void gpsUartConsume(size_t n) {
+  tail += n;
+  stats.bytes += n;
+}
+
+#else
+
+// Sin DMA: lotes desde el buffer del core (sus pérdidas no se ven)
+static uint8_t batch[64];
+static size_t batchLen = 0;
+
+void gpsUartBegin() {}
+
+size_t gpsUartPeek(const uint8_t **data) {
+  while (batchLen < sizeof(batch) && Serial1.available()) batch[batchLen++] = (uint8_t)Serial1.read();
+  if (batchLen > stats.maxFill) stats.maxFill = batchLen;
+  *data = batch;
+  return batchLen;
+}
+
+void gpsUartConsume(size_t n) {
+  memmove(batch, batch + n, batchLen - n);
+  batchLen -= n;
+  stats.bytes += n;
+}
+
+#endif
+
+/**
+ * @brief Devuelve y reinicia los contadores
+ */
+GpsUartStats gpsUartTakeStats() {
+  GpsUartStats s = stats;
+  stats.bytes = 0;
+  stats.overruns = 0;
+  stats.maxFill = 0;
+  return s;
+}
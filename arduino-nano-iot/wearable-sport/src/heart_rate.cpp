@@ -6,6 +6,7 @@
  */
 
 #include "heart_rate.h"
+#include "hrv.h"
 
 // ==================== CONSTANTES ====================
 
@@ -15,11 +16,6 @@ const int MAX_RR = 2000;
 
 // ==================== VARIABLES DE DETECCIÓN CARDÍACA ====================
 
-float s0 = 0, s1 = 0, s2 = 0;
-float signalLevel = 0;
-float noiseLevel = 0;
-float thresh = 0;
-unsigned long lastBeatMs = 0;
 unsigned long lastPrintBpmMs = 0;
 float bpmAvg = 0;
 
@@ -27,24 +23,28 @@ unsigned int rrBuf[RR_BUF];
 int rrIdx = 0;
 bool rrFilled = false;
 
+static unsigned long rrSum = 0;          ///< Suma corriente de rrBuf
+
 /**
  * @brief Agrega un intervalo RR al buffer y recalcula BPM promedio
  * 
+ * También alimenta la ventana de HRV.
+ * 
  * @param rr Intervalo RR en milisegundos
  */
 void pushRR(unsigned int rr) {
+  // Suma corriente: sale el RR sobrescrito, entra el nuevo
+  if (rrFilled) rrSum -= rrBuf[rrIdx];
   rrBuf[rrIdx++] = rr;
+  rrSum += rr;
   if (rrIdx >= RR_BUF) {
     rrIdx = 0;
     rrFilled = true;
   }
   
-  long sum = 0;
   int n = rrFilled ? RR_BUF : rrIdx;
-  for (int i = 0; i < n; i++) {
-    sum += rrBuf[i];
-  }
-  
-  float rrMean = (n > 0) ? (float)sum / n : rr;
+  float rrMean = (n > 0) ? (float)rrSum / n : rr;
   bpmAvg = 60000.0f / rrMean;
+  
+  hrvPush(rr);
 }
@@ -6,6 +6,7 @@
  */
 
 #include "heart_rate_zones.h"
+#include "zone_table.h"
 
 // ==================== CONSTANTES ====================
 
@@ -14,9 +15,17 @@ const float Z_EDGES[] = {0.50, 0.60, 0.70, 0.80, 0.90};
 
 // ==================== VARIABLES ====================
 
-float secInHZ[6] = {0};
-float bpmSumSec = 0;
-int bpmSecCount = 0;
+static ZoneTable<5> hzTable;             ///< Bordes en 0.1 bpm
+
+/**
+ * @brief Fija la FC máxima y los bordes de las zonas
+ * 
+ * @param fcMax Frecuencia cardíaca máxima (bpm)
+ * @param edges Bordes ascendentes como fracción de fcMax
+ */
+void hrZonesConfigure(int fcMax, const float edges[5]) {
+  hzTable.set(edges, fcMax * 10.0f);
+}
 
 /**
  * @brief Determina la zona de frecuencia cardíaca según BPM actual
@@ -25,12 +34,6 @@ int bpmSecCount = 0;
  * @return int Índice de zona (0-5)
  */
 int hrZoneIndex(float bpm) {
-  if (bpm <= 0) return HZ1;
-  float r = bpm / FCMAX;
-  if (r < Z_EDGES[0]) return HZ1;
-  if (r < Z_EDGES[1]) return HZ2;
-  if (r < Z_EDGES[2]) return HZ3;
-  if (r < Z_EDGES[3]) return HZ4;
-  if (r < Z_EDGES[4]) return HZ5;
-  return HZ6;
+  // bpm <= 0 (sin latidos) queda bajo el primer borde: HZ1
+  return hzTable.index((int32_t)(bpm * 10.0f));
 }
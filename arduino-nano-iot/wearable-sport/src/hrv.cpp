@@ -0,0 +1,139 @@
+/**
+ * @file hrv.cpp
+ * @brief Implementación de la variabilidad de la frecuencia cardíaca
+ * @authors Juan Perez, Ana Gomez
+ * @date 2025
+ */
+
+#include <math.h>
+#include "hrv.h"
+
+/** @brief RR más largo que entra a la ventana (ms; el mismo límite que MAX_RR) */
+static const uint32_t HRV_RR_MAX_MS = 2000;
+
+static_assert(HRV_WIN >= 3, "HRV_WIN debe ser al menos 3");
+static_assert((uint64_t)HRV_WIN * HRV_RR_MAX_MS * HRV_RR_MAX_MS < (1ULL << 32),
+              "HRV_WIN demasiado grande: sumRR2 no cabe en 32 bits");
+
+// ==================== VARIABLES ====================
+
+static uint16_t win[HRV_WIN];            ///< Intervalos RR de la ventana
+static bool linked[HRV_WIN];             ///< El RR es sucesivo del anterior en la ventana
+static int head = 0;                     ///< Posición del RR más antiguo
+static int count = 0;                    ///< RR en la ventana
+
+static uint32_t sumRR = 0;               ///< Suma de RR
+static uint32_t sumRR2 = 0;              ///< Suma de RR^2
+static uint32_t sumDiff2 = 0;            ///< Suma de (RR[i] - RR[i-1])^2
+static int nn50 = 0;                     ///< Diferencias sucesivas > 50 ms
+static int nDiff = 0;                    ///< Diferencias sucesivas en las sumas
+static int rejectRun = 0;                ///< Rechazos consecutivos
+static bool gap = false;                 ///< Hubo un RR descartado desde el último aceptado
+
+uint32_t hrvRejected = 0;
+
+/**
+ * @brief Aporta una diferencia sucesiva a (sign = 1) o la retira de (sign = -1) las sumas
+ */
+static inline void accountDiff(int a, int b, int sign) {
+  int d = b - a;
+  uint32_t d2 = (uint32_t)(d * d);
+  if (sign > 0) {
+    sumDiff2 += d2;
+    if (d > 50 || d < -50) nn50++;
+  } else {
+    sumDiff2 -= d2;
+    if (d > 50 || d < -50) nn50--;
+  }
+}
+
+/**
+ * @brief Agrega un intervalo RR a la ventana de HRV
+ * 
+ * @param rr Intervalo RR en milisegundos
+ */
+void hrvPush(unsigned int rr) {
+  if (rr > HRV_RR_MAX_MS) {
+    hrvRejected++;
+    gap = true;
+    return;
+  }
+
+  // Rechazo de artefactos respecto al último RR aceptado; tras varios
+  // rechazos seguidos se acepta para seguir cambios reales de ritmo
+  if (count > 0 && rejectRun < 3) {
+    unsigned int last = win[(head + count - 1) % HRV_WIN];
+    unsigned int tol = last * HRV_ARTIFACT_PCT / 100;
+    if (rr + tol < last || rr > last + tol) {
+      hrvRejected++;
+      rejectRun++;
+      gap = true;
+      return;
+    }
+  }
+  rejectRun = 0;
+
+  // Sale el más antiguo (y su diferencia con el siguiente, si la había)
+  if (count == HRV_WIN) {
+    int oldest = win[head];
+    int nextIdx = (head + 1) % HRV_WIN;
+    sumRR -= oldest;
+    sumRR2 -= (uint32_t)oldest * oldest;
+    if (linked[nextIdx]) {
+      accountDiff(oldest, win[nextIdx], -1);
+      linked[nextIdx] = false;
+      nDiff--;
+    }
+    head = nextIdx;
+    count--;
+  }
+
+  // Entra el nuevo; su diferencia con el anterior solo cuenta si no hubo
+  // un RR descartado entre ambos (no serían latidos sucesivos)
+  int tail = (head + count) % HRV_WIN;
+  linked[tail] = count > 0 && !gap;
+  if (linked[tail]) {
+    accountDiff(win[(tail + HRV_WIN - 1) % HRV_WIN], rr, 1);
+    nDiff++;
+  }
+  gap = false;
+  win[tail] = (uint16_t)rr;
+  sumRR += rr;
+  sumRR2 += (uint32_t)rr * rr;
+  count++;
+}
+
+/**
+ * @brief Calcula RMSSD, SDNN y pNN50 a partir de las sumas corrientes
+ * 
+ * @return HrvMetrics Métricas de la ventana
+ */
+HrvMetrics hrvCompute() {
+  HrvMetrics m = {0, 0, 0, count};
+  if (count < 3) return m;
+
+  // Varianza muestral exacta en enteros: (n*S2 - S^2) / (n*(n-1))
+  int64_t num = (int64_t)count * sumRR2 - (int64_t)sumRR * sumRR;
+  if (num < 0) num = 0;
+  m.sdnn = sqrtf((float)num / ((float)count * (count - 1)));
+  if (nDiff > 0) {
+    m.rmssd = sqrtf((float)sumDiff2 / nDiff);
+    m.pnn50 = 100.0f * nn50 / nDiff;
+  }
+  return m;
+}
+
+/**
+ * @brief Vacía la ventana de HRV
+ */
+void hrvReset() {
+  head = 0;
+  count = 0;
+  sumRR = 0;
+  sumRR2 = 0;
+  sumDiff2 = 0;
+  nn50 = 0;
+  nDiff = 0;
+  rejectRun = 0;
+  gap = false;
+}
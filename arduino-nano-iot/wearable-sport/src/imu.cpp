@@ -0,0 +1,122 @@
+/**
+ * @file imu.cpp
+ * @brief Driver mínimo del acelerómetro LSM6DS3 por I2C con FIFO
+ * @authors Juan Perez, Ana Gomez
+ * @date 2025
+ */
+
+#include <Arduino.h>
+#include <Wire.h>
+#include "imu.h"
+#include "config.h"
+
+/** @brief Código de ODR (CTRL1_XL[7:4] y FIFO_CTRL5[6:3]) según IMU_RATE_HZ */
+#if IMU_RATE_HZ == 52
+#define LSM6_ODR_CODE     0x3
+#elif IMU_RATE_HZ == 104
+#define LSM6_ODR_CODE     0x4
+#elif IMU_RATE_HZ == 208
+#define LSM6_ODR_CODE     0x5
+#else
+#error "IMU_RATE_HZ debe ser 52, 104 o 208"
+#endif
+
+/** @brief Escala ±16 g (CTRL1_XL[3:2] = 01) */
+static const uint8_t LSM6_FS_XL_16G = 0x04;
+
+/** @brief BDU (bit 6) e incremento automático de dirección (bit 2) */
+static const uint8_t LSM6_CTRL3_BDU_INC = 0x44;
+
+/** @brief Acelerómetro en la FIFO sin decimación, giróscopo fuera */
+static const uint8_t LSM6_FIFO_XL_ONLY = 0x01;
+
+/** @brief FIFO_CTRL5[2:0]: 000 bypass (la vacía), 110 continuo */
+static const uint8_t LSM6_FIFO_BYPASS = 0x00;
+static const uint8_t LSM6_FIFO_CONTINUOUS = 0x06;
+
+/** @brief Bits de FIFO_STATUS2 */
+static const uint8_t LSM6_FIFO_OVER_RUN = 0x40;
+
+static uint16_t overruns = 0;
+
+static bool writeReg(uint8_t reg, uint8_t value) {
+  Wire.beginTransmission(IMU_I2C_ADDR);
+  Wire.write(reg);
+  Wire.write(value);
+  return Wire.endTransmission() == 0;
+}
+
+static bool readRegs(uint8_t reg, uint8_t *buf, uint8_t n) {
+  Wire.beginTransmission(IMU_I2C_ADDR);
+  Wire.write(reg);
+  if (Wire.endTransmission(false) != 0) return false;
+  if (Wire.requestFrom((uint8_t)IMU_I2C_ADDR, n) != n) return false;
+  for (uint8_t i = 0; i < n; i++) buf[i] = (uint8_t)Wire.read();
+  return true;
+}
+
+bool imuBegin() {
+  Wire.begin();
+  Wire.setClock(400000);
+  uint8_t id = 0;
+  if (!readRegs(LSM6_WHO_AM_I, &id, 1)) return false;
+  if (id != LSM6_ID_DS3 && id != LSM6_ID_DS3TRC) return false;
+  overruns = 0;
+  return writeReg(LSM6_CTRL3_C, LSM6_CTRL3_BDU_INC) &&
+         writeReg(LSM6_FIFO_CTRL5, LSM6_FIFO_BYPASS) &&
+         writeReg(LSM6_FIFO_CTRL3, LSM6_FIFO_XL_ONLY) &&
+         writeReg(LSM6_CTRL1_XL, (LSM6_ODR_CODE << 4) | LSM6_FS_XL_16G) &&
+         writeReg(LSM6_FIFO_CTRL5, (LSM6_ODR_CODE << 3) | LSM6_FIFO_CONTINUOUS);
+}
+
+int imuReadFifo(ImuSample *buf, int maxSamples) {
+  // FIFO_STATUS1..4: palabras sin leer, banderas y posición en el patrón X/Y/Z
+  uint8_t st[4];
+  if (!readRegs(LSM6_FIFO_STATUS1, st, sizeof(st))) return 0;
+  uint16_t words = st[0] | ((st[1] & 0x0F) << 8);
+  uint16_t pattern = st[2] | ((st[3] & 0x03) << 8);
+  if (st[1] & LSM6_FIFO_OVER_RUN) overruns++;
+
+  // Tras un desbordamiento la siguiente palabra puede no ser X: se descartan hasta alinear
+  uint8_t tmp[6];
+  if (pattern != 0) {
+    uint8_t skip = (uint8_t)(3 - pattern);
+    if (words < skip || !readRegs(LSM6_FIFO_DATA_OUT_L, tmp, 2 * skip)) return 0;
+    words -= skip;
+  }
+
+  int n = words / 3;
+  if (n > maxSamples) n = maxSamples;
+  if (n > IMU_BURST_SAMPLES) n = IMU_BURST_SAMPLES;
+  if (n == 0) return 0;
+  uint8_t *b = (uint8_t *)buf;
+  if (!readRegs(LSM6_FIFO_DATA_OUT_L, b, (uint8_t)(6 * n))) return 0;
+
+  // Palabras little-endian X, Y, Z decodificadas sobre el mismo buffer
+  for (int i = 0; i < n; i++) {
+    const uint8_t *p = b + 6 * i;
+    ImuSample s;
+    s.ax = (int16_t)(p[0] | (p[1] << 8));
+    s.ay = (int16_t)(p[2] | (p[3] << 8));
+    s.az = (int16_t)(p[4] | (p[5] << 8));
+    buf[i] = s;
+  }
+  return n;
+}
+
+uint16_t imuTakeOverruns() {
+  uint16_t n = overruns;
+  overruns = 0;
+  return n;
+}
+
+float imuForwardAccel(const ImuSample &s) {
+#if IMU_FWD_AXIS == 0
+  int16_t raw = s.ax;
+#elif IMU_FWD_AXIS == 1
+  int16_t raw = s.ay;
+#else
+  int16_t raw = s.az;
+#endif
+  return (IMU_FWD_SIGN) * raw * IMU_MS2_PER_LSB;
+}
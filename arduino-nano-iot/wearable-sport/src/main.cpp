@@ -18,47 +18,847 @@
 #include "filter.h"
 #include "heart_rate.h"
 #include "gps_processing.h"
+#include "gps_distance.h"
 #include "velocity_zones.h"
 #include "heart_rate_zones.h"
 #include "metrics.h"
 #include "sd_card.h"
+#include "ecg_adc.h"
+#include "qrs_detector.h"
+#include "hrv.h"
+#include "scheduler.h"
+#include "sd_logger.h"
+#include "session_log.h"
+#include "ecg_capture.h"
+#include "imu.h"
+#include "motion.h"
+#include "speed_kalman.h"
+#include "sprint.h"
+#include "athlete_profile.h"
+#include "rolling.h"
+#include "telemetry.h"
+#include "gps_aid.h"
+#include "gps_uart.h"
+
+// ==================== TAREAS ====================
+
+/** @brief Periodos de las tareas (us) */
+static const uint32_t GPS_PERIOD_US = 5000;        ///< Vacía el buffer de Serial1 (64 B = 66 ms a 9600 baud)
+static const uint32_t BPM_PERIOD_US = 100000;
+static const uint32_t SEC_PERIOD_US = 1000000;
+static const uint32_t MIN_PERIOD_US = 60000000;
+static const uint32_t SD_PERIOD_US = 100000;
+static const uint32_t CAPTURE_PERIOD_US = 50000;   ///< Un sector de captura cada ~0.5 s a 250 Hz
+
+static int taskEcg = -1;                 ///< Tarea ECG (la libera el DMA en modo ECG_ACQ_DMA)
+static volatile bool beatNew = false;    ///< Latido nuevo pendiente de imprimir
+
+/**
+ * @brief Detección de latidos sobre una muestra ya filtrada
+ * 
+ * @param yf Muestra filtrada
+ */
+static void processEcgSample(float yf) {
+  // Detección de QRS (Pan-Tompkins) y registro del intervalo RR
+  QrsBeat beat;
+  if (qrsProcess(yf, &beat) && beat.rrMs >= (uint32_t)MIN_RR && beat.rrMs <= (uint32_t)MAX_RR) {
+    pushRR(beat.rrMs);
+    beatNew = true;
+  }
+}
+
+/**
+ * @brief Tarea ECG (contexto de interrupción): filtrado y detección de latidos
+ */
+static void tareaEcg() {
+#if ECG_ACQ_MODE == ECG_ACQ_DMA
+  // Bloques completos llenados por DMA a intervalo fijo
+  uint32_t firstSample;
+  const uint16_t *blk;
+  while ((blk = ecgAdcNextBlock(&firstSample)) != nullptr) {
+    static float yf[ECG_BLOCK_LEN];
+    filterAdcBlock(blk, yf, ECG_BLOCK_LEN);
+    for (int i = 0; i < ECG_BLOCK_LEN; i++) {
+#if ECG_CAPTURE
+      capturePush(firstSample + i, blk[i], yf[i]);
+#endif
+      processEcgSample(yf[i]);
+    }
+    ecgAdcStats.blocks++;
+  }
+#else
+  // Lectura y filtrado de señal
+  int raw = analogRead(EMG_INPUT_PIN);
+  float yf = filterAdcSample(raw);
+#if ECG_CAPTURE
+  static uint32_t sampleIndex = 0;
+  capturePush(sampleIndex++, (uint16_t)raw, yf);
+#endif
+  processEcgSample(yf);
+#endif
+}
+
+#if ECG_ACQ_MODE == ECG_ACQ_DMA
+/**
+ * @brief Aviso de bloque del DMA: libera la tarea ECG
+ */
+static void onEcgBlock() {
+  schedRelease(taskEcg);
+}
+#endif
+
+/** @brief Vaciado de la FIFO del acelerómetro: ~10 muestras por ráfaga a 104 Hz */
+static const uint32_t IMU_PERIOD_US = 100000;
+static const uint32_t IMU_DT_US = 1000000UL / IMU_RATE_HZ;
+
+static bool imuOk = false;               ///< LSM6DS3 detectado
+
+#if SPEED_SOURCE == SPEED_KALMAN
+static const float KF_GPS_VAR = (KF_GPS_SIGMA_KMH / 3.6f) * (KF_GPS_SIGMA_KMH / 3.6f);
+
+static SpeedKalman kf(KF_ACC_SIGMA, KF_BIAS_SIGMA);
+static bool kfActive = false;            ///< Hay velocidad GPS reciente: el filtro alimenta las métricas
+static float accFwd = 0.0f;              ///< Última aceleración de avance (m/s²)
+static float kfEpochM = 0.0f;            ///< Distancia del filtro desde la última época GPS
+static uint32_t kfUs = 0;                ///< Fracción de ms aún no entregada a integrateSpeed()
+static uint32_t lastGpsSpeedMs = 0;      ///< millis() de la última velocidad GPS
+
+/**
+ * @brief Predicción del filtro con una muestra y métricas de velocidad
+ * 
+ * Sin velocidad GPS durante más de GPS_MAX_GAP_MS el filtro se detiene (la
+ * integración sola deriva) y se reinicia con la siguiente medición.
+ */
+static void kalmanImuSample(const ImuSample &s) {
+  accFwd = imuForwardAccel(s);
+  if (kfActive && millis() - lastGpsSpeedMs > GPS_MAX_GAP_MS) kfActive = false;
+  if (!kfActive) return;
+  
+  kf.predict(accFwd, IMU_DT_US * 1e-6f);
+  float v_kmh = kf.speed() * 3.6f;
+  if (v_kmh < V_THRESH_KMH) v_kmh = 0.0f;
+  kfEpochM += v_kmh * (IMU_DT_US / 3.6e6f);
+  kfUs += IMU_DT_US;
+  integrateSpeed(v_kmh, kfUs / 1000);
+  kfUs %= 1000;
+}
+
+/**
+ * @brief Medición de velocidad GPS para el filtro (lo inicia si estaba detenido)
+ */
+static void kalmanGpsSpeed(const GpsFix &fix) {
+  float v = fix.speed * (0.01f / 3.6f);
+  if (kfActive) {
+    kf.update(v, KF_GPS_VAR);
+  } else {
+    kf.reset(v, accFwd);
+    kfActive = true;
+    kfEpochM = 0.0f;
+  }
+  lastGpsSpeedMs = millis();
+}
+#endif
+
+/**
+ * @brief Tarea diferida: vacía la FIFO del acelerómetro en ráfagas
+ * 
+ * Los impactos se detectan sobre cada muestra cruda; la filtrada pasa por
+ * la detección de pasos y, con SPEED_KALMAN, por el filtro de velocidad.
+ */
+static void tareaImu() {
+  static ImuSample buf[IMU_BURST_SAMPLES];
+  int n;
+  while ((n = imuReadFifo(buf, IMU_BURST_SAMPLES)) > 0) {
+    for (int i = 0; i < n; i++) {
+      ImuSample filt = buf[i];
+      motionFilter(filt);
+      motionProcess(buf[i], filt);
+#if SPEED_SOURCE == SPEED_KALMAN
+      kalmanImuSample(filt);
+#endif
+    }
+  }
+}
+
+/**
+ * @brief Integra la velocidad de una época GPS sobre el intervalo real desde la anterior
+ * 
+ * La época la cierra RMC (NMEA, 1 Hz) o cada NAV-PVT (UBX, GPS_RATE_HZ). Sin
+ * velocidad en la época (sin fix) se integra 0 km/h; tras un hueco mayor
+ * que GPS_MAX_GAP_MS solo se toma la nueva referencia de tiempo. Con el
+ * filtro de Kalman activo la velocidad GPS solo corrige el filtro, y la
+ * distancia de la época es la que integró el filtro.
+ */
+static void onGpsEpoch() {
+  static bool haveTow = false;
+  static uint32_t lastTowMs = 0;
+  
+  const GpsFix &fix = gps.fix();
+  static bool firstFix = false;
+  if (!firstFix && fix.has(GPS_LOCATION)) {
+    firstFix = true;
+    Serial.print(F("GPS: primer fix a los "));
+    Serial.print(millis() / 1000);
+    Serial.println(F(" s del arranque"));
+  }
+#if SPEED_SOURCE == SPEED_KALMAN
+  if (imuOk && (fix.updated & GPS_SPEED)) kalmanGpsSpeed(fix);
+#endif
+  if (!(fix.updated & GPS_TIME)) return;
+  lastGpsMs = millis();
+  uint32_t dtMs = fix.towMs - lastTowMs;
+  bool first = !haveTow;
+  haveTow = true;
+  lastTowMs = fix.towMs;
+  if (first || dtMs == 0 || dtMs > GPS_MAX_GAP_MS) {
+    gpsDistanceReset();
+#if SPEED_SOURCE == SPEED_KALMAN
+    kfEpochM = 0.0f;
+#endif
+    return;
+  }
+  
+#if SPEED_SOURCE == SPEED_KALMAN
+  if (imuOk) {
+    float vMean = kfEpochM / dtMs * 3600.0f;
+    kfEpochM = 0.0f;
+    integrateDistance(gpsDistanceStep(fix, vMean, dtMs), vMean);
+    return;
+  }
+#endif
+  
+  // Velocidad con filtrado
+  float v_kmh = 0.0f;
+  if (fix.updated & GPS_SPEED) {
+    v_kmh = movingAvg(fix.speed * 0.01f);
+    if (v_kmh < V_THRESH_KMH) v_kmh = 0.0f;
+  }
+  integrateSpeed(v_kmh, dtMs);
+  integrateDistance(gpsDistanceStep(fix, v_kmh, dtMs), v_kmh);
+}
+
+/**
+ * @brief Tarea diferida: lectura del GPS e integración por época
+ */
+static void tareaGps() {
+  const uint8_t *rx;
+  size_t n;
+  while ((n = gpsUartPeek(&rx)) > 0) {
+    for (size_t i = 0; i < n; i++) {
+      if (gps.encode((char)rx[i]) && gps.epoch()) {
+        onGpsEpoch();
+      }
+#if GPS_AID && GPS_PROTOCOL == GPS_UBX
+      const uint8_t *dbd;
+      uint16_t dbdLen;
+      if (gps.takeDbd(&dbd, &dbdLen)) gpsAidDbd(dbd, dbdLen);
+#endif
+    }
+    gpsUartConsume(n);
+  }
+}
+
+#if TELEMETRY == TELEM_TEXT
+/**
+ * @brief Tarea diferida: impresión de BPM en cada latido y recordatorio cada segundo
+ */
+static void tareaBpm() {
+  if (beatNew) {
+    beatNew = false;
+    Serial.print((int)(bpmAvg + 0.5f));
+    Serial.println(F(" bpm"));
+  }
+  
+  unsigned long ms = millis();
+  if (ms - lastPrintBpmMs >= 1000) {
+    lastPrintBpmMs = ms;
+    if (bpmAvg > 0) {
+      Serial.print((int)(bpmAvg + 0.5f));
+      Serial.println(F(" bpm"));
+    } else {
+      Serial.println(F("... bpm"));
+    }
+  }
+}
+#endif
+
+/**
+ * @brief Tarea diferida: zonas de FC y TRIMP cada segundo
+ * 
+ * Velocidad, distancia, zonas de velocidad y sprints se integran por época
+ * GPS en onGpsEpoch().
+ */
+static void tareaSegundo() {
+  // Acumulación en zona de frecuencia cardíaca
+  MinuteBank &m = minuteLive();
+  float thisBpm = bpmAvg;
+  int hz = hrZoneIndex(thisBpm);
+  m.secInHZ[hz] += 1.0f;
+  if (thisBpm > 0) {
+    m.bpmSum += thisBpm;
+    m.bpmCount++;
+  }
+  
+  // Cálculo de TRIMP (por minuto, dividido entre 60)
+  m.trimp += athlete.trimpW[hz] * (1.0f / 60.0f);
+  
+  // Ventanas deslizantes de 1/5/10 min
+  rollingSecond(hz);
+}
+
+// ==================== REPORTE DEL MINUTO ====================
+
+/** @brief Partes del reporte del minuto: tareaReporte() ejecuta una por liberación */
+enum ReportStep : uint8_t {
+  REP_IDLE = 0,                          ///< Nada pendiente
+  REP_TELEM,                             ///< Tramas del minuto (TELEM_BIN)
+  REP_TEXT_MAIN,                         ///< Texto: distancia, velocidad, FC, HRV y zonas (TELEM_TEXT)
+  REP_TEXT_LOAD,                         ///< Texto: ventanas, sprints y movimiento (TELEM_TEXT)
+  REP_TEXT_DIAG,                         ///< Texto: diagnóstico y tareas (TELEM_TEXT)
+  REP_LOG,                               ///< Registro en SD (binario o CSV, al buffer de sdLog)
+  REP_GPS_AID,                           ///< Ayuda del GPS (puede escribir un archivo en la SD)
+  REP_END
+};
+
+/**
+ * @struct MinuteReport
+ * @brief Minuto cerrado y contadores leídos al cierre, pendientes de reportar
+ */
+struct MinuteReport {
+  const MinuteBank *m;                   ///< Banco cerrado (ver minuteSwap())
+  HrvMetrics hrv;
+  GpsDistanceStats ds;
+  uint16_t sprintsLost;
+  MotionMinute motion;
+  SdLogStats sd;
+  GpsUartStats rx;
+#if ECG_CAPTURE
+  CaptureStats cap;
+#endif
+  MinuteRecord rec;
+  MotionRecord motionRec;
+  uint8_t step;                          ///< ReportStep siguiente
+};
+
+static MinuteReport report;
+static int taskReporte = -1;             ///< Tarea del reporte (la libera tareaMinuto)
+
+#if TELEMETRY == TELEM_TEXT
+/**
+ * @brief Resumen en texto: distancia, velocidad, FC, HRV y zonas
+ */
+static void printMinuteMain(const MinuteReport &r) {
+  const MinuteBank &m = *r.m;
+  Serial.println(F("\n===== RESUMEN (1 min) ====="));
+  Serial.print(F("Dist: "));
+  Serial.print(m.distM, 1);
+  Serial.print(F(" m  (Total: "));
+  Serial.print(m.distTotalM / 1000.0f, 3);
+  Serial.println(F(" km)"));
+  Serial.print(F("Dist vel/pos: "));
+  Serial.print(r.ds.dopplerM, 1);
+  Serial.print(F(" / "));
+  Serial.print(r.ds.positionM, 1);
+  Serial.print(F(" m  correccion: "));
+  Serial.print(r.ds.correctionM, 1);
+  Serial.print(F(" m  tramos: "));
+  Serial.print(r.ds.segments);
+  Serial.print(F("  descartes: "));
+  Serial.println(r.ds.rejected);
+  
+  Serial.print(F("Vel prom: "));
+  Serial.print(m.vMeanKmh(), 1);
+  Serial.print(F(" km/h  Vel pico: "));
+  Serial.print(m.vMaxKmh, 1);
+  Serial.println(F(" km/h"));
+  
+  Serial.print(F("BPM prom: "));
+  Serial.println(m.bpmMean(), 1);
+  
+  Serial.print(F("HRV RMSSD: "));
+  Serial.print(r.hrv.rmssd, 1);
+  Serial.print(F(" ms  SDNN: "));
+  Serial.print(r.hrv.sdnn, 1);
+  Serial.print(F(" ms  pNN50: "));
+  Serial.print(r.hrv.pnn50, 1);
+  Serial.print(F(" %  ("));
+  Serial.print(r.hrv.n);
+  Serial.println(F(" RR)"));
+  
+  Serial.println(F("Zonas vel [s | m]: CAM/TRO/CAR/SPR"));
+  Serial.print((int)m.secInVZ[VZ_CAM]);
+  Serial.print(F("s | "));
+  Serial.print((int)m.distInVZ[VZ_CAM]);
+  Serial.println(F("m"));
+  Serial.print((int)m.secInVZ[VZ_TRO]);
+  Serial.print(F("s | "));
+  Serial.print((int)m.distInVZ[VZ_TRO]);
+  Serial.println(F("m"));
+  Serial.print((int)m.secInVZ[VZ_CAR]);
+  Serial.print(F("s | "));
+  Serial.print((int)m.distInVZ[VZ_CAR]);
+  Serial.println(F("m"));
+  Serial.print((int)m.secInVZ[VZ_SPR]);
+  Serial.print(F("s | "));
+  Serial.print((int)m.distInVZ[VZ_SPR]);
+  Serial.println(F("m"));
+  
+  Serial.print(F("Zonas FC [s]: Z1..Z6, bordes"));
+  for (int i = 0; i < 5; i++) {
+    Serial.print(i ? '/' : ' ');
+    Serial.print((int)(athlete.zEdges[i] * 100.0f + 0.5f));
+  }
+  Serial.println(F(" % FCmax"));
+  Serial.print((int)m.secInHZ[HZ1]); Serial.print(' ');
+  Serial.print((int)m.secInHZ[HZ2]); Serial.print(' ');
+  Serial.print((int)m.secInHZ[HZ3]); Serial.print(' ');
+  Serial.print((int)m.secInHZ[HZ4]); Serial.print(' ');
+  Serial.print((int)m.secInHZ[HZ5]); Serial.print(' ');
+  Serial.println((int)m.secInHZ[HZ6]);
+  
+  Serial.print(F("TRIMP (min): "));
+  Serial.println(m.trimp, 2);
+}
+
+/**
+ * @brief Resumen en texto: ventanas deslizantes, sprints y movimiento
+ */
+static void printMinuteLoad(const MinuteReport &r) {
+  const MinuteBank &m = *r.m;
+  Serial.println(F("Ventanas 1/5/10 min [m | m alta vel | TRIMP]:"));
+  for (int w = ROLL_1MIN; w < ROLL_WINDOWS; w++) {
+    RollingTotals rt = rollingTotals((RollWindow)w);
+    Serial.print(rt.distM, 0);
+    Serial.print(F(" | "));
+    Serial.print(rt.hsDistM, 0);
+    Serial.print(F(" | "));
+    Serial.print(rt.trimp, 1);
+    Serial.print(F("  ("));
+    Serial.print(rt.seconds);
+    Serial.println(F(" s)"));
+  }
+  RollingPeaks rp = rollingPeaks();
+  Serial.print(F("Pico 5 min: "));
+  Serial.print(rp.dist5M, 0);
+  Serial.print(F(" m  alta vel "));
+  Serial.print(rp.hsDist5M, 0);
+  Serial.print(F(" m  TRIMP "));
+  Serial.print(rp.trimp5, 1);
+  Serial.print(F("  agudo:cronico "));
+  Serial.println(rollingAcuteChronic(), 2);
+  Serial.print(F("Sprints(min/total): "));
+  Serial.print(m.sprints);
+  Serial.print('/');
+  Serial.println(m.sprintsTotal);
+  if (r.sprintsLost) {
+    Serial.print(F("Sprints sin registrar (cola llena): "));
+    Serial.println(r.sprintsLost);
+  }
+  if (imuOk) {
+    Serial.print(F("Pasos: "));
+    Serial.print(r.motion.steps);
+    Serial.print(F("  cadencia: "));
+    Serial.print(r.motion.cadenceSpm, 1);
+    Serial.print(F(" ppm  impactos: "));
+    Serial.print(r.motion.impacts);
+    Serial.print(F("  pico: "));
+    Serial.print(r.motion.peakG, 2);
+    Serial.print(F(" g  FIFO desbordada: "));
+    Serial.println(r.motion.fifoOverruns);
+  }
+}
+
+/**
+ * @brief Resumen en texto: contadores de diagnóstico y tareas
+ */
+static void printMinuteDiag(const MinuteReport &r) {
+#if ECG_ACQ_MODE == ECG_ACQ_DMA
+  Serial.print(F("ECG bloques/overruns: "));
+  Serial.print(ecgAdcStats.blocks);
+  Serial.print('/');
+  Serial.print(ecgAdcStats.overruns);
+  Serial.print(F("  (presupuesto: "));
+  Serial.print(ECG_BLOCK_BUDGET_US);
+  Serial.println(F(" us por bloque)"));
+#endif
+  Serial.print(F("GPS RX: "));
+  Serial.print(r.rx.bytes);
+  Serial.print(F(" B, perdidos "));
+  Serial.print(r.rx.overruns);
+  Serial.print(F(" B, ocupacion max "));
+  Serial.print(r.rx.maxFill);
+  Serial.println(F(" B"));
+  Serial.print(F("SD: "));
+  Serial.print(r.sd.bytes);
+  Serial.print(F(" B en "));
+  Serial.print(r.sd.sectors);
+  Serial.print(F(" sectores, pendientes "));
+  Serial.print(sdLog.pending());
+  Serial.print(F(" B, descartados "));
+  Serial.print(r.sd.dropped);
+  Serial.print(F(" B  max escritura/sync: "));
+  Serial.print(r.sd.writeMaxUs);
+  Serial.print('/');
+  Serial.print(r.sd.flushMaxUs);
+  Serial.println(F(" us"));
+  if (r.sd.errors) Serial.println(F("SD: error de escritura, registro cerrado"));
+#if ECG_CAPTURE
+  Serial.print(F("Captura ECG: "));
+  Serial.print(r.cap.sectors);
+  Serial.print(F(" sectores, descartados "));
+  Serial.print(r.cap.dropped);
+  Serial.print(F(", errores "));
+  Serial.print(r.cap.errors);
+  Serial.print(F("  max escritura: "));
+  Serial.print(r.cap.writeMaxUs);
+  Serial.println(captureActive() ? F(" us") : F(" us (detenida)"));
+#endif
+  schedPrintStats(Serial);
+  Serial.println(F("===========================\n"));
+}
+#endif
+
+/**
+ * @brief Ejecuta la parte pendiente del reporte
+ *
+ * @return true Si quedan partes por ejecutar
+ */
+static bool reportStep() {
+  MinuteReport &r = report;
+  switch (r.step) {
+#if TELEMETRY == TELEM_BIN
+    case REP_TELEM:
+#if ECG_CAPTURE
+      telemetryMinute(r.rec, imuOk ? &r.motionRec : nullptr, r.ds, r.sprintsLost, r.rx, r.sd, &r.cap);
+#else
+      telemetryMinute(r.rec, imuOk ? &r.motionRec : nullptr, r.ds, r.sprintsLost, r.rx, r.sd, nullptr);
+#endif
+      break;
+#else
+    case REP_TEXT_MAIN:
+      printMinuteMain(r);
+      break;
+    case REP_TEXT_LOAD:
+      printMinuteLoad(r);
+      break;
+    case REP_TEXT_DIAG:
+      printMinuteDiag(r);
+      break;
+#endif
+    case REP_LOG:
+#if LOG_FORMAT == LOG_BIN
+      sessionLogMinute(r.rec, imuOk ? &r.motionRec : nullptr);
+#else
+      guardarDatosCSV(*r.m, r.hrv);
+#endif
+      break;
+#if GPS_AID
+    case REP_GPS_AID:
+      gpsAidMinute(Serial1, gps.fix());
+      break;
+#endif
+    default:
+      break;
+  }
+  if (r.step == REP_IDLE) return false;
+  if (++r.step == REP_END) r.step = REP_IDLE;
+  return r.step != REP_IDLE;
+}
+
+/**
+ * @brief Tarea diferida: una parte del reporte del minuto por liberación
+ *
+ * Entre parte y parte corren las tareas de mayor prioridad (GPS, IMU).
+ */
+static void tareaReporte() {
+  if (reportStep()) schedRelease(taskReporte);
+}
+
+/**
+ * @brief Tarea diferida: cierre del minuto
+ *
+ * Solo cambia de banco, lee los contadores y arma los registros; el
+ * formateo y la escritura los hace tareaReporte() por partes mientras la
+ * adquisición sigue en el banco nuevo.
+ */
+static void tareaMinuto() {
+  tMinuteStartMs = millis();
+  
+  // Un reporte sin terminar (no debería ocurrir) se completa antes de reutilizarlo
+  while (report.step != REP_IDLE) reportStep();
+  
+  MinuteReport &r = report;
+  r.m = &minuteSwap();
+  noInterrupts();                        // La tarea ECG actualiza la ventana de HRV
+  r.hrv = hrvCompute();
+  interrupts();
+  
+  // Contadores del minuto (se reinician al leerlos)
+  r.ds = gpsDistanceTakeStats();
+  r.sprintsLost = sprintTakeDropped();
+  if (imuOk) {
+    r.motion = motionTakeMinute();
+    r.motion.fifoOverruns = imuTakeOverruns();
+  }
+  r.sd = sdLog.takeStats();
+  r.rx = gpsUartTakeStats();
+#if ECG_CAPTURE
+  r.cap = captureTakeStats();
+#endif
+  
+  // Registros del minuto (SD y telemetría)
+  sessionMinuteRecord(*r.m, r.hrv, &r.rec);
+  if (imuOk) sessionMotionRecord(r.rec.seq, r.motion, &r.motionRec);
+  
+  r.step = REP_TELEM;                    // Primera parte
+  schedRelease(taskReporte);
+}
+
+/**
+ * @brief Tarea diferida: registro de sprints terminados y escritura de sectores completos en SD
+ */
+static void tareaSd() {
+  SprintEvent e;
+  while (sprintTakeEvent(&e)) {
+    SprintRecord r;
+    sessionSprintRecord(e, &r);
+    sessionLogSprint(r);
+#if TELEMETRY == TELEM_BIN
+    telemetrySend(&r, sizeof(r));
+#else
+    Serial.print(F("Sprint: "));
+    Serial.print(e.durationMs * 0.001f, 2);
+    Serial.print(F(" s  "));
+    Serial.print(e.distM, 1);
+    Serial.print(F(" m  pico "));
+    Serial.print(e.vPeakKmh, 1);
+    Serial.print(F(" km/h  "));
+    Serial.print(e.aPeakMs2, 1);
+    Serial.println(F(" m/s2"));
+#endif
+  }
+  uint32_t now = millis();
+  sdLog.service(now);
+  sprintLog.service(now);
+}
+
+#if ECG_CAPTURE
+/**
+ * @brief Tarea diferida: escritura de los sectores de captura llenos
+ */
+static void tareaCaptura() {
+  captureService();
+}
+#endif
+
+/**
+ * @brief Tarea diferida: reporte de posición, hora y velocidad cada segundo
+ * 
+ * Con TELEM_BIN envía un StateRecord (BPM incluido) a TELEM_STATE_HZ.
+ */
+static void tareaReporteGps() {
+#if TELEMETRY == TELEM_BIN
+  telemetryState();
+#else
+  const GpsFix &fix = gps.fix();
+  
+  // Posición
+  if (fix.has(GPS_LOCATION)) {
+    double lat = fix.latE7 * 1e-7;
+    double lon = fix.lonE7 * 1e-7;
+    Serial.print(F("Lat: "));
+    Serial.print(lat, 6);
+    Serial.print(F("  Lon: "));
+    Serial.println(lon, 6);
+  } else {
+    Serial.println(F("Posición: buscando fix..."));
+  }
+  
+  // Fecha y hora
+  if (fix.has(GPS_DATE | GPS_TIME)) {
+    int y = fix.year;
+    int m = fix.month;
+    int d = fix.day;
+    int uh = fix.hour;
+    int um = fix.minute;
+    int us = fix.second;
+    int lh = wrapLocalHour(uh, UTC_OFFSET_H);
+    
+    Serial.print(F("UTC: "));
+    Serial.print(y); Serial.print('-');
+    Serial.print(m); Serial.print('-');
+    Serial.print(d); Serial.print(' ');
+    Serial.print(uh); Serial.print(':');
+    Serial.print(um); Serial.print(':');
+    Serial.println(us);
+    
+    Serial.print(F("Local: "));
+    Serial.print(lh); Serial.print(':');
+    Serial.print(um); Serial.print(':');
+    Serial.println(us);
+  }
+  
+  // Satélites y precisión
+  if (fix.has(GPS_SATS)) {
+    Serial.print(F("Sats: "));
+    Serial.print(fix.sats);
+    Serial.print(F("  HDOP: "));
+    if (fix.has(GPS_HDOP)) {
+      Serial.println(fix.hdop * 0.01f);
+    } else {
+      Serial.println(F("N/D"));
+    }
+  }
+  
+  // Altitud
+  if (fix.has(GPS_ALTITUDE)) {
+    Serial.print(F("Altitud: "));
+    Serial.print(fix.altCm * 0.01f);
+    Serial.println(F(" m"));
+  }
+  
+  // Velocidad
+  if (fix.has(GPS_SPEED)) {
+    Serial.print(F("Vel (km/h): "));
+    Serial.println(v_kmh_last, 2);
+  } else {
+    Serial.println(F("Velocidad: N/D"));
+  }
+  
+  Serial.println();
+#endif
+}
 
 // ==================== CONFIGURACIÓN INICIAL ====================
 
 /**
  * @brief Configuración inicial del sistema
  * 
- * Inicializa comunicaciones seriales, ADC, tarjeta SD y GPS.
- * Crea el archivo CSV si no existe.
+ * Inicializa comunicaciones seriales, ADC, tarjeta SD y GPS, registra las
+ * tareas e inicia el planificador. Crea el archivo CSV si no existe.
  */
 void setup() {
   // Comunicación serial con PC
+  // Sin monitor (en el atleta) no se espera: lo escrito antes de conectar se pierde
   Serial.begin(BAUD_PC);
-  while (!Serial) {
+#if SERIAL_WAIT_MS > 0
+  uint32_t t0 = millis();
+  while (!Serial && millis() - t0 < SERIAL_WAIT_MS) {
     ; // Esperar conexión serial
   }
+#endif
   Serial.println(F("=== Sistema de Monitoreo Deportivo ==="));
   
   // Configuración ADC para lectura EMG
   analogReadResolution(ADC_RESOLUTION);
+  qrsReset();
+  
+  // Captura de ECG: preasigna su archivo antes de que SD use la FAT
+#if ECG_CAPTURE
+  captureBegin(SD_CS_PIN);
+#endif
   
   // Inicialización de tarjeta SD
   Serial.print(F("Inicializando SD... "));
-  if (!SD.begin(SD_CS_PIN)) {
+  bool sdOk = SD.begin(SD_CS_PIN);
+  if (!sdOk) {
     Serial.println(F("ERROR: No se pudo inicializar SD"));
     Serial.println(F("Verifique: 1) Tarjeta insertada 2) Conexiones 3) Pin CS correcto"));
   } else {
     Serial.println(F("OK"));
-    crearArchivoCSV();
   }
   
-  // Comunicación serial con GPS
+  // GPS antes que el resto de la SD: busca satélites mientras se abren los registros
+#if GPS_AID
+  bool aidOk = sdOk && gpsAidLoad();
+#endif
+#if GPS_PROTOCOL == GPS_UBX
+  if (ubxConfigure(Serial1)) {
+    Serial.println(F("GPS inicializado (UBX NAV-PVT)"));
+  } else {
+    Serial.println(F("GPS: el receptor no confirmó la configuración UBX"));
+  }
+#else
   Serial1.begin(BAUD_GPS);
   Serial.println(F("GPS inicializado"));
+#endif
+#if GPS_AID
+  if (aidOk) {
+    gpsAidPush(Serial1);
+    Serial.println(F("GPS: última posición enviada (arranque en caliente)"));
+  }
+#endif
+  gpsUartBegin();
+  
+  if (sdOk) {
+    if (!profileLoad(PROFILE_FILENAME)) {
+      Serial.println(F("Sin " PROFILE_FILENAME ": perfil por omisión"));
+    }
+#if LOG_FORMAT == LOG_BIN
+    sessionLogBegin();
+#else
+    crearArchivoCSV();
+#endif
+    sprintLogBegin();
+  }
+  
+  // Zonas del perfil (o por omisión sin SD)
+  profileApply();
+  rollingBegin(athlete.trimpW);
+  Serial.print(F("Perfil: "));
+  Serial.print(athlete.name[0] ? athlete.name : "(sin nombre)");
+  Serial.print(F("  FCmax "));
+  Serial.print(athlete.fcMax);
+  Serial.print(F("  zonas vel "));
+  Serial.print(athlete.vBins[0], 1);
+  Serial.print('/');
+  Serial.print(athlete.vBins[1], 1);
+  Serial.print('/');
+  Serial.print(athlete.vBins[2], 1);
+  Serial.println(F(" km/h"));
+  
+  // Acelerómetro: pasos, impactos y velocidad a alta tasa
+  imuOk = imuBegin();
+  if (imuOk) {
+    motionReset();
+    Serial.println(F("IMU LSM6DS3 inicializada (FIFO)"));
+  } else {
+    Serial.println(F("IMU no detectada: sin pasos ni impactos, velocidad solo por GPS"));
+  }
+  
+  // Tareas por prioridad (0 = la más alta)
+#if ECG_ACQ_MODE == ECG_ACQ_DMA
+  taskEcg = schedAdd("ECG", tareaEcg, 0, SCHED_ISR, 0);
+#else
+  taskEcg = schedAdd("ECG", tareaEcg, 1000000UL / SAMPLE_RATE, SCHED_ISR, 0);
+#endif
+  schedAdd("GPS", tareaGps, GPS_PERIOD_US, SCHED_DEFERRED, 1);
+  if (imuOk) schedAdd("IMU", tareaImu, IMU_PERIOD_US, SCHED_DEFERRED, 1);
+#if ECG_CAPTURE
+  schedAdd("Captura", tareaCaptura, CAPTURE_PERIOD_US, SCHED_DEFERRED, 1);
+#endif
+#if TELEMETRY == TELEM_TEXT
+  schedAdd("BPM", tareaBpm, BPM_PERIOD_US, SCHED_DEFERRED, 2);
+#endif
+  schedAdd("Segundo", tareaSegundo, SEC_PERIOD_US, SCHED_DEFERRED, 3);
+  schedAdd("Minuto", tareaMinuto, MIN_PERIOD_US, SCHED_DEFERRED, 4);
+  taskReporte = schedAdd("Reporte", tareaReporte, 0, SCHED_DEFERRED, 5);
+#if TELEMETRY == TELEM_TEXT
+  schedAdd("ReporteGPS", tareaReporteGps, SEC_PERIOD_US, SCHED_DEFERRED, 5);
+#else
+  if (TELEM_LEVEL >= 1) schedAdd("Estado", tareaReporteGps, 1000000UL / TELEM_STATE_HZ, SCHED_DEFERRED, 5);
+#endif
+  schedAdd("SD", tareaSd, SD_PERIOD_US, SCHED_DEFERRED, 6);
   
   // Inicializar temporizador de minuto
   tMinuteStartMs = millis();
   
+  // Arranque del muestreo ECG y del tick
+#if ECG_ACQ_MODE == ECG_ACQ_DMA
+  ecgAdcBegin(onEcgBlock);
+#endif
+  schedBegin();
+  
   Serial.println(F("Sistema listo\n"));
 }
 
@@ -67,259 +867,17 @@ void setup() {
 /**
  * @brief Bucle principal del programa
  * 
- * Ejecuta tres tareas principales:
- * 1. Muestreo y detección de latidos cardíacos a 30 Hz
- * 2. Lectura y procesamiento de datos GPS cada segundo
- * 3. Generación de resumen y guardado en SD cada minuto
+ * Las tareas las libera el planificador (scheduler.h):
+ * 1. ECG (interrupción): filtrado y detección de latidos a SAMPLE_RATE
+ * 2. GPS (diferida): lotes del anillo de recepción (gps_uart.h); velocidad, distancia y sprints por época
+ * 3. BPM (diferida, con TELEM_TEXT): impresión de la frecuencia cardíaca
+ * 4. Cada segundo (diferida): zonas de FC y TRIMP
+ * 5. Cada minuto (diferida): cambio de banco de acumuladores y registros del minuto
+ * 6. Reporte (diferida, por partes): resumen, guardado en SD y ayuda del GPS (gps_aid.h)
+ * 7. Reporte GPS (diferida): posición y hora cada segundo (StateRecord con TELEM_BIN)
+ * 8. SD (diferida): registro de sprints y escritura por sectores en SD
+ * 9. Captura (diferida, si ECG_CAPTURE): sectores de la forma de onda ECG
  */
 void loop() {
-  // ==================== PROCESAMIENTO ECG (30 Hz) ====================
-  static uint32_t nextEcgUs = 0;
-  uint32_t nowUs = micros();
-  
-  if ((int32_t)(nowUs - nextEcgUs) >= 0) {
-    nextEcgUs += 1000000UL / SAMPLE_RATE;
-    
-    // Lectura y filtrado de señal
-    float raw = (float)analogRead(EMG_INPUT_PIN);
-    float yf = filterSample(raw);
-    
-    // Detección de pico local
-    s2 = s1;
-    s1 = s0;
-    s0 = yf;
-    bool isLocalMax = (s1 > s2) && (s1 >= s0);
-    unsigned long ms = millis();
-    
-    // Período de warm-up del umbral adaptativo
-    if (ms < 1500) {
-      noiseLevel = 0.99f * noiseLevel + 0.01f * fabsf(s1);
-      thresh = noiseLevel * 1.5f;
-    } else {
-      // Detección de latido
-      if (isLocalMax && (int)(ms - lastBeatMs) > REFRACT_MS) {
-        if (s1 > thresh) {
-          // Latido válido detectado
-          unsigned int rr = ms - lastBeatMs;
-          lastBeatMs = ms;
-          
-          if (rr >= MIN_RR && rr <= MAX_RR) {
-            pushRR(rr);
-            Serial.print((int)(bpmAvg + 0.5f));
-            Serial.println(F(" bpm"));
-          }
-          signalLevel = 0.875f * signalLevel + 0.125f * s1;
-        } else {
-          noiseLevel = 0.875f * noiseLevel + 0.125f * fabsf(s1);
-        }
-        
-        // Actualización de umbral adaptativo
-        float s = (signalLevel > noiseLevel) ? signalLevel : (noiseLevel + 1.0f);
-        thresh = noiseLevel + 0.25f * (s - noiseLevel);
-      }
-    }
-    
-    // Recordatorio de BPM cada segundo
-    if (ms - lastPrintBpmMs >= 1000) {
-      lastPrintBpmMs = ms;
-      if (bpmAvg > 0) {
-        Serial.print((int)(bpmAvg + 0.5f));
-        Serial.println(F(" bpm"));
-      } else {
-        Serial.println(F("... bpm"));
-      }
-    }
-  }
-  
-  // ==================== LECTURA GPS ====================
-  while (Serial1.available()) {
-    gps.encode(Serial1.read());
-  }
-  
-  // ==================== PROCESAMIENTO CADA SEGUNDO ====================
-  static uint32_t lastSecMs = 0;
-  if (millis() - lastSecMs >= 1000) {
-    lastSecMs += 1000;
-    
-    // Obtener velocidad con filtrado
-    float v_kmh = 0.0f;
-    if (gps.speed.isValid()) {
-      v_kmh = movingAvg(gps.speed.kmph());
-      if (v_kmh < V_THRESH_KMH) v_kmh = 0.0f;
-    }
-    v_kmh_last = v_kmh;
-    if (v_kmh > v_kmh_max_min) v_kmh_max_min = v_kmh;
-    
-    // Cálculo de distancia (v en m/s durante 1 segundo)
-    float d_m = v_kmh / 3.6f;
-    dist_m_total += d_m;
-    dist_m_minute += d_m;
-    
-    // Acumulación en zona de velocidad
-    int vz = velZoneIndex(v_kmh);
-    secInVZ[vz] += 1.0f;
-    distInVZ[vz] += d_m;
-    
-    // Acumulación en zona de frecuencia cardíaca
-    float thisBpm = bpmAvg;
-    int hz = hrZoneIndex(thisBpm);
-    secInHZ[hz] += 1.0f;
-    if (thisBpm > 0) {
-      bpmSumSec += thisBpm;
-      bpmSecCount++;
-    }
-    
-    // Cálculo de TRIMP (por minuto, dividido entre 60)
-    trimpMinute += TRIMP_W[hz] * (1.0f / 60.0f);
-    
-    // Detección de sprints (requiere 2 segundos consecutivos)
-    if (v_kmh >= SPRINT_KMH) {
-      sprintHold_s++;
-      if (!inSprint && sprintHold_s >= 2) {
-        inSprint = true;
-        sprints_min++;
-        sprints_total++;
-      }
-    } else {
-      sprintHold_s = 0;
-      inSprint = false;
-    }
-    
-    // ==================== RESUMEN CADA MINUTO ====================
-    if (millis() - tMinuteStartMs >= 60000) {
-      tMinuteStartMs += 60000;
-      
-      // Cálculo de promedios
-      float bpmMeanMin = (bpmSecCount > 0) ? bpmSumSec / bpmSecCount : 0.0f;
-      float vMeanMin = dist_m_minute / 60.0f * 3.6f;
-      
-      // Impresión en serial
-      Serial.println(F("\n===== RESUMEN (1 min) ====="));
-      Serial.print(F("Dist: "));
-      Serial.print(dist_m_minute, 1);
-      Serial.print(F(" m  (Total: "));
-      Serial.print(dist_m_total / 1000.0f, 3);
-      Serial.println(F(" km)"));
-      
-      Serial.print(F("Vel prom: "));
-      Serial.print(vMeanMin, 1);
-      Serial.print(F(" km/h  Vel pico: "));
-      Serial.print(v_kmh_max_min, 1);
-      Serial.println(F(" km/h"));
-      
-      Serial.print(F("BPM prom: "));
-      Serial.println(bpmMeanMin, 1);
-      
-      Serial.println(F("Zonas vel [s | m]: CAM/TRO/CAR/SPR"));
-      Serial.print((int)secInVZ[VZ_CAM]);
-      Serial.print(F("s | "));
-      Serial.print((int)distInVZ[VZ_CAM]);
-      Serial.println(F("m"));
-      Serial.print((int)secInVZ[VZ_TRO]);
-      Serial.print(F("s | "));
-      Serial.print((int)distInVZ[VZ_TRO]);
-      Serial.println(F("m"));
-      Serial.print((int)secInVZ[VZ_CAR]);
-      Serial.print(F("s | "));
-      Serial.print((int)distInVZ[VZ_CAR]);
-      Serial.println(F("m"));
-      Serial.print((int)secInVZ[VZ_SPR]);
-      Serial.print(F("s | "));
-      Serial.print((int)distInVZ[VZ_SPR]);
-      Serial.println(F("m"));
-      
-      Serial.println(F("Zonas FC [s]: Z1<50%, Z2<60, Z3<70, Z4<80, Z5<90, Z6>=90"));
-      Serial.print((int)secInHZ[HZ1]); Serial.print(' ');
-      Serial.print((int)secInHZ[HZ2]); Serial.print(' ');
-      Serial.print((int)secInHZ[HZ3]); Serial.print(' ');
-      Serial.print((int)secInHZ[HZ4]); Serial.print(' ');
-      Serial.print((int)secInHZ[HZ5]); Serial.print(' ');
-      Serial.println((int)secInHZ[HZ6]);
-      
-      Serial.print(F("TRIMP (min): "));
-      Serial.println(trimpMinute, 2);
-      Serial.print(F("Sprints(min/total): "));
-      Serial.print(sprints_min);
-      Serial.print('/');
-      Serial.println(sprints_total);
-      Serial.println(F("===========================\n"));
-      
-      // Guardar datos en tarjeta SD
-      guardarDatosCSV(bpmMeanMin, vMeanMin);
-      
-      // Reiniciar acumuladores
-      resetMinuteAccumulators();
-    }
-  }
-  
-  // ==================== REPORTE GPS PERIÓDICO ====================
-  static uint32_t tGps = 0;
-  if (millis() - tGps >= 1000) {
-    tGps = millis();
-    
-    // Posición
-    if (gps.location.isValid()) {
-      double lat = gps.location.lat();
-      double lon = gps.location.lng();
-      Serial.print(F("Lat: "));
-      Serial.print(lat, 6);
-      Serial.print(F("  Lon: "));
-      Serial.println(lon, 6);
-    } else {
-      Serial.println(F("Posición: buscando fix..."));
-    }
-    
-    // Fecha y hora
-    if (gps.date.isValid() && gps.time.isValid()) {
-      int y = gps.date.year();
-      int m = gps.date.month();
-      int d = gps.date.day();
-      int uh = gps.time.hour();
-      int um = gps.time.minute();
-      int us = gps.time.second();
-      int lh = wrapLocalHour(uh, UTC_OFFSET_H);
-      
-      Serial.print(F("UTC: "));
-      Serial.print(y); Serial.print('-');
-      Serial.print(m); Serial.print('-');
-      Serial.print(d); Serial.print(' ');
-      Serial.print(uh); Serial.print(':');
-      Serial.print(um); Serial.print(':');
-      Serial.println(us);
-      
-      Serial.print(F("Local: "));
-      Serial.print(lh); Serial.print(':');
-      Serial.print(um); Serial.print(':');
-      Serial.println(us);
-    }
-    
-    // Satélites y precisión
-    if (gps.satellites.isValid()) {
-      Serial.print(F("Sats: "));
-      Serial.print(gps.satellites.value());
-      Serial.print(F("  HDOP: "));
-      if (gps.hdop.isValid()) {
-        Serial.println(gps.hdop.hdop());
-      } else {
-        Serial.println(F("N/D"));
-      }
-    }
-    
-    // Altitud
-    if (gps.altitude.isValid()) {
-      Serial.print(F("Altitud: "));
-      Serial.print(gps.altitude.meters());
-      Serial.println(F(" m"));
-    }
-    
-    // Velocidad
-    if (gps.speed.isValid()) {
-      Serial.print(F("Vel (km/h): "));
-      Serial.println(v_kmh_last, 2);
-    } else {
-      Serial.println(F("Velocidad: N/D"));
-    }
-    
-    Serial.println();
-  }
-}
\ No newline at end of file
+  schedRun();
+}
@@ -5,26 +5,79 @@
  * @date 2025
  */
 
+#include <Arduino.h>
 #include <stdint.h>
+#include <string.h>
 #include "metrics.h"
+#include "velocity_zones.h"
+#include "sprint.h"
+#include "rolling.h"
 
 // ==================== CONSTANTES ====================
 
 const float TRIMP_W[] = {1, 2, 3, 4, 5, 6};
-const float SPRINT_KMH = 20.0;
 
 // ==================== VARIABLES ====================
 
-float trimpMinute = 0;
-float dist_m_total = 0;
-float dist_m_minute = 0;
+SessionState session;
 float v_kmh_last = 0;
-float v_kmh_max_min = 0;
-
-int sprints_min = 0;
-int sprints_total = 0;
-bool inSprint = false;
-int sprintHold_s = 0;
 
 uint32_t lastGpsMs = 0;
 uint32_t tMinuteStartMs = 0;
+
+// ==================== BANCOS DEL MINUTO ====================
+
+/**
+ * @brief Cierra el minuto: pasa al otro banco (vacío) y devuelve el cerrado
+ *
+ * Solo la llaman y acumulan tareas diferidas, que no se interrumpen entre
+ * sí: el cambio no necesita deshabilitar interrupciones.
+ *
+ * @return const MinuteBank& Minuto cerrado
+ */
+const MinuteBank &minuteSwap() {
+  MinuteBank &closed = session.bank[session.live];
+  closed.distTotalM = session.distTotalM;
+  closed.sprintsTotal = session.sprintsTotal;
+  session.live ^= 1;
+  memset(&session.bank[session.live], 0, sizeof(MinuteBank));
+  return closed;
+}
+
+// ==================== INTEGRACIÓN DE VELOCIDAD ====================
+
+/**
+ * @brief Integra una velocidad sobre el intervalo desde la anterior
+ * 
+ * @param v_kmh Velocidad filtrada (km/h)
+ * @param dtMs Intervalo desde la velocidad anterior (ms)
+ */
+void integrateSpeed(float v_kmh, uint32_t dtMs) {
+  MinuteBank &m = minuteLive();
+  v_kmh_last = v_kmh;
+  if (v_kmh > m.vMaxKmh) m.vMaxKmh = v_kmh;
+  
+  // Acumulación en zona de velocidad
+  m.secInVZ[velZoneIndex(v_kmh)] += dtMs * 0.001f;
+  
+  // Sprints: se cuentan una vez, al confirmarse (ver sprint.h)
+  if (sprintStep(v_kmh, dtMs, millis())) {
+    m.sprints++;
+    session.sprintsTotal++;
+  }
+}
+
+/**
+ * @brief Acumula la distancia de una época GPS
+ * 
+ * @param d_m Distancia del intervalo (m)
+ * @param v_kmh Velocidad media del intervalo (km/h)
+ */
+void integrateDistance(float d_m, float v_kmh) {
+  MinuteBank &m = minuteLive();
+  session.distTotalM += d_m;
+  m.distM += d_m;
+  int vz = velZoneIndex(v_kmh);
+  m.distInVZ[vz] += d_m;
+  rollingAddDistance(d_m, vz);
+}
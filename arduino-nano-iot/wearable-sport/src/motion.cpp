@@ -0,0 +1,159 @@
+/**
+ * @file motion.cpp
+ * @brief Implementación de la detección de pasos e impactos
+ * @authors Juan Perez, Ana Gomez
+ * @date 2025
+ */
+
+#include <math.h>
+#include "motion.h"
+#include "config.h"
+#include "filter_design.h"
+#include "biquad_fixed.h"
+
+// ==================== PARÁMETROS ====================
+
+/** @brief Coeficientes de los promedios exponenciales (τ ≈ 1 s y fc ≈ 4 Hz) */
+static const float BASE_ALPHA = 1.0f / IMU_RATE_HZ;
+static const float LP_ALPHA = 25.0f / IMU_RATE_HZ;
+
+/** @brief Dinámica mínima de un paso (g) */
+static const float STEP_MIN_G = 0.15f;
+
+/** @brief Intervalos entre pasos (muestras): mínimo 250 ms, máximo para la cadencia 2 s */
+static const uint32_t STEP_MIN_N = IMU_RATE_HZ / 4;
+static const uint32_t STEP_MAX_N = IMU_RATE_HZ * 2;
+
+/** @brief Separación mínima entre impactos (muestras, 300 ms) */
+static const uint32_t IMPACT_MIN_N = IMU_RATE_HZ * 3 / 10;
+
+/** @brief Bits de la entrada en Q31: 16 del sensor y 3 de margen */
+static const int IMU_Q_SHIFT = 12;
+
+static_assert(IMU_LP_HZ * 2 < IMU_RATE_HZ, "IMU_LP_HZ debe ser menor que IMU_RATE_HZ / 2");
+
+// ==================== PASA-BAJAS ====================
+
+/**
+ * @brief Los 3 ejes por la misma cascada de 2 etapas
+ *
+ * Dos pasa-bajas iguales con Q = 0.5 (cuatro polos reales): sin
+ * sobreimpulso, que en un escalón de Butterworth de 4o orden inflaría el
+ * pico de los impactos ~15 %. Cada etapa atenúa 6 dB en IMU_LP_HZ.
+ */
+typedef BiquadBank<Q31, 2, 3> ImuBank;
+
+/** @brief Etapa del pasa-bajas en punto fijo, convertida en compilación */
+#define IMU_STAGE_Q ImuBank::Stage::from(fdesign::lowpass(IMU_LP_HZ, IMU_RATE_HZ, 0.5))
+
+/** @brief Coeficientes en punto fijo (flash) */
+static constexpr ImuBank::Stage IMU_LP[] = { IMU_STAGE_Q, IMU_STAGE_Q };
+
+static ImuBank imuLp(IMU_LP);
+
+/** @brief Regresa un eje filtrado a LSB, saturado a 16 bits */
+static int16_t fromQ(ImuBank::sample_t v) {
+  v >>= IMU_Q_SHIFT;
+  return (int16_t)(v > 32767 ? 32767 : v < -32768 ? -32768 : v);
+}
+
+void motionFilter(ImuSample &s) {
+  ImuBank::sample_t x[3] = {
+      (ImuBank::sample_t)(s.ax * (1L << IMU_Q_SHIFT)),
+      (ImuBank::sample_t)(s.ay * (1L << IMU_Q_SHIFT)),
+      (ImuBank::sample_t)(s.az * (1L << IMU_Q_SHIFT))};
+  imuLp.process(x);
+  s.ax = fromQ(x[0]);
+  s.ay = fromQ(x[1]);
+  s.az = fromQ(x[2]);
+}
+
+// ==================== ESTADO ====================
+
+static float base = 1.0f;                ///< Promedio lento de |a| (g)
+static float lp = 0.0f;                  ///< Dinámica filtrada (g)
+static float peakAvg = 0.0f;             ///< Pico promedio de los últimos pasos (g)
+static float peak = 0.0f;                ///< Pico del paso en curso
+static bool above = false;               ///< Sobre el umbral (paso en curso)
+static uint32_t sinceStep = 0;           ///< Muestras desde el último paso
+static bool inImpact = false;
+static uint32_t sinceImpact = 0;
+
+static MotionMinute minute;
+static uint32_t cadenceSteps = 0;        ///< Pasos con intervalo < 2 s en el minuto
+static uint32_t cadenceN = 0;            ///< Suma de esos intervalos (muestras)
+
+void motionReset() {
+  base = 1.0f;
+  lp = peakAvg = peak = 0.0f;
+  above = inImpact = false;
+  sinceStep = sinceImpact = STEP_MAX_N;
+  motionTakeMinute();
+}
+
+/** @brief Umbral de paso: la mitad del pico promedio, con un mínimo */
+static float stepThreshold() {
+  float t = 0.5f * peakAvg;
+  return t > STEP_MIN_G ? t : STEP_MIN_G;
+}
+
+/** @brief Magnitud |a| de una muestra (g) */
+static float magnitudeG(const ImuSample &s) {
+  // Suma de cuadrados en 32 bits sin signo: 3 × 32768² cabe
+  uint32_t sq = (uint32_t)((int32_t)s.ax * s.ax) + (uint32_t)((int32_t)s.ay * s.ay) +
+                (uint32_t)((int32_t)s.az * s.az);
+  return sqrtf((float)sq) * IMU_G_PER_LSB;
+}
+
+void motionProcess(const ImuSample &raw, const ImuSample &filt) {
+  // Impactos y pico sobre la muestra cruda: el pasa-bajas recorta los picos cortos
+  float g = magnitudeG(raw);
+  if (g > minute.peakG) minute.peakG = g;
+
+  // Impactos
+  if (sinceImpact < IMPACT_MIN_N) sinceImpact++;
+  if (!inImpact && g > IMU_IMPACT_G && sinceImpact >= IMPACT_MIN_N) {
+    inImpact = true;
+    sinceImpact = 0;
+    if (minute.impacts < 0xFFFF) minute.impacts++;
+  } else if (inImpact && g < 0.5f * IMU_IMPACT_G) {
+    inImpact = false;
+  }
+
+  // Pasos
+  g = magnitudeG(filt);
+  base += (g - base) * BASE_ALPHA;
+  lp += ((g - base) - lp) * LP_ALPHA;
+  if (sinceStep < STEP_MAX_N) {
+    sinceStep++;
+  } else {
+    peakAvg = 0.0f;                      // Pausa: el siguiente paso puede ser más suave
+  }
+  float thr = stepThreshold();
+  if (!above) {
+    if (lp > thr && sinceStep >= STEP_MIN_N) {
+      above = true;
+      peak = lp;
+      if (sinceStep < STEP_MAX_N) {
+        cadenceSteps++;
+        cadenceN += sinceStep;
+      }
+      sinceStep = 0;
+      if (minute.steps < 0xFFFF) minute.steps++;
+    }
+  } else if (lp > peak) {
+    peak = lp;
+  } else if (lp < 0.5f * thr) {
+    above = false;
+    peakAvg += (peak - peakAvg) * 0.25f;
+  }
+}
+
+MotionMinute motionTakeMinute() {
+  MotionMinute m = minute;
+  m.cadenceSpm = cadenceN ? cadenceSteps * 60.0f * IMU_RATE_HZ / cadenceN : 0.0f;
+  minute.steps = minute.impacts = minute.fifoOverruns = 0;
+  minute.cadenceSpm = minute.peakG = 0.0f;
+  cadenceSteps = cadenceN = 0;
+  return m;
+}
@@ -0,0 +1,322 @@
+/**
+ * @file nmea_parser.cpp
+ * @brief Implementación del parser NMEA incremental
+ * @authors Juan Perez, Ana Gomez
+ * @date 2025
+ */
+
+#include <string.h>
+#include "nmea_parser.h"
+
+/** @brief Campos parciales (solo en pendSet_): la posición requiere ambos */
+static const uint16_t P_LAT = 1 << 8;
+static const uint16_t P_LON = 1 << 9;
+
+/** @brief Tipo de oración a partir de los 3 últimos caracteres de la dirección */
+static const uint32_t TAG_RMC = ('R' << 16) | ('M' << 8) | 'C';
+static const uint32_t TAG_GGA = ('G' << 16) | ('G' << 8) | 'A';
+static const uint32_t TAG_VTG = ('V' << 16) | ('T' << 8) | 'G';
+
+/** @brief Decimales que se conservan por campo (suficiente para minutos de arco con 5) */
+static const int8_t MAX_FRAC = 5;
+
+static int hexValue(char c) {
+  if (c >= '0' && c <= '9') return c - '0';
+  if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+  if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+  return -1;
+}
+
+NmeaParser::NmeaParser()
+    : inSentence_(false), inChecksum_(false), cs_(0), csRecv_(0), csDigits_(0),
+      field_(0), type_(S_OTHER), tag_(0), pendSet_(0), active_(false),
+      epoch_(false), passed_(0), failed_(0) {
+  memset(&pend_, 0, sizeof(pend_));
+  memset(&fix_, 0, sizeof(fix_));
+  beginField();
+}
+
+// ==================== CAMPOS ====================
+
+void NmeaParser::beginField() {
+  acc_ = 0;
+  frac_ = -1;
+  len_ = 0;
+  first_ = '\0';
+  neg_ = false;
+  bad_ = false;
+}
+
+/**
+ * @brief Valor acumulado con exactamente `decimals` decimales (trunca o completa)
+ */
+uint32_t NmeaParser::scaled(int decimals) const {
+  uint32_t v = acc_;
+  int f = frac_ < 0 ? 0 : frac_;
+  for (; f < decimals; f++) v *= 10;
+  for (; f > decimals; f--) v /= 10;
+  return v;
+}
+
+/**
+ * @brief Convierte (d)ddmm.mmmmm a 1e-7 grados, o -1 si los minutos no son válidos
+ */
+int32_t NmeaParser::coordE7() const {
+  uint32_t v = scaled(MAX_FRAC);
+  uint32_t deg = v / 10000000UL;
+  uint32_t minE5 = v % 10000000UL;
+  if (minE5 >= 6000000UL || deg > 180) return -1;
+  return (int32_t)(deg * 10000000UL + (minE5 * 5 + 1) / 3);
+}
+
+/**
+ * @brief Interpreta el campo que acaba de terminar según el tipo de oración
+ */
+void NmeaParser::endField() {
+  if (field_ == 0) {
+    type_ = len_ != 5 ? S_OTHER
+          : tag_ == TAG_RMC ? S_RMC
+          : tag_ == TAG_GGA ? S_GGA
+          : tag_ == TAG_VTG ? S_VTG
+          : S_OTHER;
+    active_ = type_ == S_VTG;            // VTG solo se invalida con el modo 'N'
+    return;
+  }
+  if (type_ == S_OTHER) return;
+
+  bool num = len_ > 0 && !bad_;
+  // Número de campo normalizado: RMC y GGA comparten hora, latitud y longitud
+  uint8_t f = field_;
+  if (type_ == S_RMC && f >= 3 && f <= 6) f--;   // RMC tiene el estado en el campo 2
+
+  if (type_ != S_VTG && f == 1 && num) {
+    uint32_t v = scaled(2);
+    uint32_t h = v / 1000000UL, m = v / 10000 % 100, s = v / 100 % 100;
+    if (h < 24 && m < 60 && s < 61) {
+      pend_.hour = (uint8_t)h;
+      pend_.minute = (uint8_t)m;
+      pend_.second = (uint8_t)s;
+      pend_.centis = (uint8_t)(v % 100);
+      pendSet_ |= GPS_TIME;
+    }
+    return;
+  }
+  if (type_ == S_RMC && field_ == 2) {
+    active_ = first_ == 'A';
+    return;
+  }
+  if (type_ != S_VTG && f >= 2 && f <= 5) {
+    int32_t e7 = (num && (f == 2 || f == 4)) ? coordE7() : -1;
+    switch (f) {
+      case 2:
+        if (e7 >= 0 && e7 <= 900000000L) {
+          pend_.latE7 = e7;
+          pendSet_ |= P_LAT;
+        }
+        break;
+      case 3:
+        if (first_ == 'S') pend_.latE7 = -pend_.latE7;
+        break;
+      case 4:
+        if (e7 >= 0) {
+          pend_.lonE7 = e7;
+          pendSet_ |= P_LON;
+        }
+        break;
+      case 5:
+        if (first_ == 'W') pend_.lonE7 = -pend_.lonE7;
+        break;
+    }
+    return;
+  }
+
+  switch (type_) {
+    case S_RMC:
+      if (field_ == 7 && num) {
+        // Nudos (0.001) a km/h (0.01): × 1.852 / 10
+        pend_.speed = (scaled(3) * 463UL + 1250) / 2500;
+        pendSet_ |= GPS_SPEED;
+      } else if (field_ == 8 && num) {
+        pend_.course = (uint16_t)scaled(2);
+        pendSet_ |= GPS_COURSE;
+      } else if (field_ == 9 && num) {
+        uint32_t v = scaled(0);
+        uint32_t d = v / 10000, m = v / 100 % 100;
+        if (d >= 1 && d <= 31 && m >= 1 && m <= 12) {
+          pend_.day = (uint8_t)d;
+          pend_.month = (uint8_t)m;
+          pend_.year = (uint16_t)(2000 + v % 100);
+          pendSet_ |= GPS_DATE;
+        }
+      }
+      break;
+
+    case S_GGA:
+      if (field_ == 6 && num) {
+        pend_.quality = (uint8_t)scaled(0);
+        active_ = pend_.quality > 0;
+      } else if (field_ == 7 && num) {
+        uint32_t n = scaled(0);
+        pend_.sats = n > 255 ? 255 : (uint8_t)n;
+        pendSet_ |= GPS_SATS;
+      } else if (field_ == 8 && num) {
+        uint32_t h = scaled(2);
+        pend_.hdop = h > 65535 ? 65535 : (uint16_t)h;
+        pendSet_ |= GPS_HDOP;
+      } else if (field_ == 9 && num) {
+        int32_t cm = (int32_t)scaled(2);
+        pend_.altCm = neg_ ? -cm : cm;
+        pendSet_ |= GPS_ALTITUDE;
+      }
+      break;
+
+    case S_VTG:
+      if (field_ == 1 && num) {
+        pend_.course = (uint16_t)scaled(2);
+        pendSet_ |= GPS_COURSE;
+      } else if (field_ == 7 && num) {
+        pend_.speed = scaled(2);
+        pendSet_ |= GPS_SPEED;
+      } else if (field_ == 9) {
+        active_ = first_ != 'N';
+      }
+      break;
+
+    default:
+      break;
+  }
+}
+
+/**
+ * @brief Copia al fix los campos de una oración con checksum válido
+ *
+ * Posición, velocidad, rumbo y altitud solo se aceptan con fix (RMC 'A',
+ * GGA con calidad > 0, VTG sin modo 'N'); hora, fecha, satélites y HDOP
+ * siempre, como en TinyGPSPlus.
+ */
+void NmeaParser::commit() {
+  uint16_t set = pendSet_;
+  if ((set & (P_LAT | P_LON)) == (P_LAT | P_LON)) set |= GPS_LOCATION;
+  set &= 0xFF;
+  if (!active_) set &= ~(GPS_LOCATION | GPS_SPEED | GPS_COURSE | GPS_ALTITUDE);
+
+  if (set & GPS_LOCATION) {
+    fix_.latE7 = pend_.latE7;
+    fix_.lonE7 = pend_.lonE7;
+  }
+  if (set & GPS_SPEED) fix_.speed = pend_.speed;
+  if (set & GPS_COURSE) fix_.course = pend_.course;
+  if (set & GPS_ALTITUDE) fix_.altCm = pend_.altCm;
+  if (set & GPS_SATS) fix_.sats = pend_.sats;
+  if (set & GPS_HDOP) fix_.hdop = pend_.hdop;
+  if (set & GPS_DATE) {
+    fix_.year = pend_.year;
+    fix_.month = pend_.month;
+    fix_.day = pend_.day;
+  }
+  if (set & GPS_TIME) {
+    fix_.hour = pend_.hour;
+    fix_.minute = pend_.minute;
+    fix_.second = pend_.second;
+    fix_.centis = pend_.centis;
+    fix_.towMs = pend_.utcMs();
+  }
+  if (type_ == S_GGA) fix_.quality = pend_.quality;
+  fix_.valid |= set;
+  fix_.updated = set;
+  epoch_ = type_ == S_RMC;
+}
+
+// ==================== TOKENIZADOR ====================
+
+/**
+ * @brief Procesa un carácter del receptor
+ *
+ * @param c Carácter recibido
+ * @return true Si completó una oración RMC/GGA/VTG con checksum válido
+ */
+bool NmeaParser::encode(char c) {
+  if (c == '$') {
+    inSentence_ = true;
+    inChecksum_ = false;
+    cs_ = 0;
+    csRecv_ = 0;
+    csDigits_ = 0;
+    field_ = 0;
+    type_ = S_OTHER;
+    tag_ = 0;
+    pendSet_ = 0;
+    beginField();
+    return false;
+  }
+  if (!inSentence_) return false;
+
+  if (inChecksum_) {
+    if (csDigits_ < 2) {
+      int h = hexValue(c);
+      if (h < 0) {
+        inSentence_ = false;
+        failed_++;
+        return false;
+      }
+      csRecv_ = (uint8_t)(csRecv_ << 4 | h);
+      csDigits_++;
+      return false;
+    }
+    // Fin de línea tras los dos dígitos del checksum
+    inSentence_ = false;
+    if ((c != '\r' && c != '\n') || csRecv_ != cs_) {
+      failed_++;
+      return false;
+    }
+    passed_++;
+    if (type_ == S_OTHER) return false;
+    commit();
+    return true;
+  }
+
+  if (c == '*') {
+    endField();
+    inChecksum_ = true;
+    return false;
+  }
+  if (c == '\r' || c == '\n') {
+    // Oración sin checksum: se descarta
+    inSentence_ = false;
+    failed_++;
+    return false;
+  }
+
+  cs_ ^= (uint8_t)c;
+  if (c == ',') {
+    endField();
+    if (field_ < 255) field_++;
+    beginField();
+    return false;
+  }
+  if (len_ < 255) len_++;
+  if (field_ == 0) {
+    tag_ = ((tag_ << 8) | (uint8_t)c) & 0xFFFFFFUL;
+    return false;
+  }
+  if (type_ == S_OTHER) return false;
+
+  if (len_ == 1) first_ = c;
+  if (c >= '0' && c <= '9') {
+    if (frac_ >= MAX_FRAC) {
+      // Decimales de más: se truncan
+    } else if (acc_ > 429496728UL) {
+      bad_ = true;
+    } else {
+      acc_ = acc_ * 10 + (uint32_t)(c - '0');
+      if (frac_ >= 0) frac_++;
+    }
+  } else if (c == '.' && frac_ < 0) {
+    frac_ = 0;
+  } else if (c == '-' && len_ == 1) {
+    neg_ = true;
+  } else {
+    bad_ = true;                         // Indicadores (N/S/E/W/A/V...) usan first_
+  }
+  return false;
+}
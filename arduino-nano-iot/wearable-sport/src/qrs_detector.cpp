@@ -0,0 +1,335 @@
+/**
+ * @file qrs_detector.cpp
+ * @brief Implementación del detector QRS Pan-Tompkins en línea
+ * @authors Juan Perez, Ana Gomez
+ * @date 2025
+ */
+
+#include "qrs_detector.h"
+
+// ==================== CONSTANTES ====================
+
+/** @brief Convierte milisegundos a muestras a SAMPLE_RATE (mínimo 1) */
+#define MS_TO_SAMPLES(ms) (((uint32_t)(ms) * SAMPLE_RATE + 500) / 1000 > 0 ? \
+                           ((uint32_t)(ms) * SAMPLE_RATE + 500) / 1000 : 1)
+
+/** @brief Ventana de integración de 150 ms */
+static const uint32_t MWI_LEN = MS_TO_SAMPLES(150);
+
+/** @brief Fase de aprendizaje de umbrales */
+static const uint32_t LEARN_LEN = MS_TO_SAMPLES(2000);
+
+/** @brief Ventana en la que un pico podría ser onda T */
+static const uint32_t T_WAVE_LEN = MS_TO_SAMPLES(360);
+
+/** @brief Sin latidos durante este tiempo se reaprenden los umbrales */
+static const uint32_t RELEARN_LEN = MS_TO_SAMPLES(5000);
+
+/** @brief Número de intervalos RR en los promedios */
+static const int RR_AVG_N = 8;
+
+/** @brief Límite de la derivada para que la integración quepa en 32 bits */
+static const int32_t SLOPE_MAX = 4095;
+
+static const uint32_t REFRACT_LEN = MS_TO_SAMPLES(REFRACT_MS);
+
+// ==================== ESTADO ====================
+
+QrsStats qrsStats = {0, 0, 0};
+
+/**
+ * @struct RrAverage
+ * @brief Promedio de los últimos RR_AVG_N intervalos con suma corriente
+ */
+struct RrAverage {
+  uint32_t buf[RR_AVG_N];
+  uint32_t sum;
+  int idx;
+
+  void reset(uint32_t rr) {
+    for (int i = 0; i < RR_AVG_N; i++) buf[i] = rr;
+    sum = rr * RR_AVG_N;
+    idx = 0;
+  }
+  void push(uint32_t rr) {
+    sum += rr - buf[idx];
+    buf[idx] = rr;
+    idx = (idx + 1) % RR_AVG_N;
+  }
+  uint32_t mean() const { return sum / RR_AVG_N; }
+};
+
+/**
+ * @struct PeakLevels
+ * @brief Niveles de señal y ruido con sus dos umbrales (Pan-Tompkins)
+ */
+struct PeakLevels {
+  float spk;                             ///< Nivel de pico de señal
+  float npk;                             ///< Nivel de pico de ruido
+  float thr1;                            ///< Umbral principal
+  float thr2;                            ///< Umbral de search-back (thr1 / 2)
+
+  void update() {
+    thr1 = npk + 0.25f * (spk - npk);
+    thr2 = 0.5f * thr1;
+  }
+};
+
+static uint32_t n;                       ///< Muestras procesadas
+static int32_t xh[4];                    ///< x[n-1] .. x[n-4] para la derivada
+
+static uint32_t mwiBuf[MWI_LEN];         ///< Cuadrados en la ventana de integración
+static uint32_t mwiSum;
+static uint32_t mwiIdx;
+
+// Pico en curso de la señal integrada
+static uint32_t pkVal;                   ///< Máximo de la señal integrada
+static int32_t fMax;                     ///< Máximo de |x| desde el último pico
+static uint32_t fMaxSample;              ///< Posición de fMax
+static int32_t slopeMax;                 ///< Máxima pendiente desde el último pico
+
+// Umbrales
+static PeakLevels lvI;                   ///< Señal integrada
+static PeakLevels lvF;                   ///< Señal filtrada
+static uint32_t learnStart;              ///< Inicio de la fase de aprendizaje
+static uint32_t learnMaxI, learnMaxF;
+static float learnSumI, learnSumF;
+
+// Historia de latidos
+static bool haveQrs;
+static uint32_t lastQrs;                 ///< Posición del último QRS
+static int32_t lastSlope;                ///< Pendiente del último QRS
+static RrAverage rrAll;                  ///< RR AVERAGE1: últimos 8 RR
+static RrAverage rrReg;                  ///< RR AVERAGE2: últimos 8 RR regulares
+static bool irregular;                   ///< El último RR cayó fuera de los límites
+
+// Candidato para search-back (mayor pico de ruido sobre thr2)
+static bool cand;
+static uint32_t candI;
+static int32_t candF;
+static uint32_t candSample;
+static int32_t candSlope;
+
+// ==================== FUNCIONES INTERNAS ====================
+
+/**
+ * @brief RR de referencia para los límites y el search-back
+ *
+ * Con ritmo regular es RR AVERAGE2; si el último RR no cumplió los límites
+ * se usa RR AVERAGE1, que sigue al ritmo nuevo (un cambio sostenido de la
+ * FC, p. ej. al acelerar, nunca volvería a caer dentro de AVERAGE2).
+ */
+static uint32_t rrReference() {
+  return irregular ? rrAll.mean() : rrReg.mean();
+}
+
+static void startLearning() {
+  learnStart = n;
+  learnMaxI = learnMaxF = 0;
+  learnSumI = learnSumF = 0;
+}
+
+static void finishLearning() {
+  float len = (float)LEARN_LEN;
+  lvI.spk = learnMaxI / 3.0f;
+  lvI.npk = 0.5f * learnSumI / len;
+  lvF.spk = learnMaxF / 3.0f;
+  lvF.npk = 0.5f * learnSumF / len;
+  lvI.update();
+  lvF.update();
+}
+
+/**
+ * @brief Registra un QRS y llena el latido de salida
+ */
+static void acceptQrs(uint32_t pos, int32_t slope, bool searchBack, QrsBeat *beat) {
+  beat->sample = pos;
+  beat->searchBack = searchBack;
+  beat->rrMs = 0;
+
+  if (haveQrs) {
+    uint32_t rr = pos - lastQrs;
+    beat->rrMs = (rr * 1000UL) / SAMPLE_RATE;
+
+    uint32_t ref = rrReference();
+    rrAll.push(rr);
+    if (rr * 100 >= ref * 92 && rr * 100 <= ref * 116) {
+      rrReg.push(rr);
+      irregular = false;
+    } else {
+      irregular = true;
+    }
+  }
+
+  haveQrs = true;
+  lastQrs = pos;
+  lastSlope = slope;
+  cand = false;
+  qrsStats.beats++;
+  if (searchBack) qrsStats.searchBacks++;
+}
+
+/**
+ * @brief Clasifica un pico de la señal integrada como QRS o ruido
+ *
+ * @return true Si el pico es un QRS
+ */
+static bool classifyPeak(uint32_t peakI, int32_t peakF, uint32_t pos, int32_t slope, QrsBeat *beat) {
+  if (haveQrs && pos - lastQrs < REFRACT_LEN) {
+    return false;
+  }
+
+  // Onda T: poco después del QRS anterior y con menos de la mitad de su pendiente
+  if (haveQrs && pos - lastQrs < T_WAVE_LEN && 2 * slope < lastSlope) {
+    qrsStats.tWaves++;
+    lvI.npk = 0.125f * peakI + 0.875f * lvI.npk;
+    lvF.npk = 0.125f * peakF + 0.875f * lvF.npk;
+    lvI.update();
+    lvF.update();
+    return false;
+  }
+
+  // Con ritmo irregular el umbral principal se reduce a la mitad
+  float k = irregular ? 0.5f : 1.0f;
+  if (peakI > k * lvI.thr1 && peakF > k * lvF.thr1) {
+    lvI.spk = 0.125f * peakI + 0.875f * lvI.spk;
+    lvF.spk = 0.125f * peakF + 0.875f * lvF.spk;
+    lvI.update();
+    lvF.update();
+    acceptQrs(pos, slope, false, beat);
+    return true;
+  }
+
+  lvI.npk = 0.125f * peakI + 0.875f * lvI.npk;
+  lvF.npk = 0.125f * peakF + 0.875f * lvF.npk;
+  lvI.update();
+  lvF.update();
+
+  if (peakI > lvI.thr2 && peakF > lvF.thr2 && (!cand || peakI > candI)) {
+    cand = true;
+    candI = peakI;
+    candF = peakF;
+    candSample = pos;
+    candSlope = slope;
+  }
+  return false;
+}
+
+// ==================== INTERFAZ ====================
+
+/**
+ * @brief Reinicia el detector (fase de aprendizaje de 2 s incluida)
+ */
+void qrsReset() {
+  n = 0;
+  for (int i = 0; i < 4; i++) xh[i] = 0;
+  for (uint32_t i = 0; i < MWI_LEN; i++) mwiBuf[i] = 0;
+  mwiSum = 0;
+  mwiIdx = 0;
+  pkVal = 0;
+  fMax = 0;
+  fMaxSample = 0;
+  slopeMax = 0;
+  haveQrs = false;
+  lastQrs = 0;
+  lastSlope = 0;
+  irregular = false;
+  cand = false;
+  rrAll.reset(SAMPLE_RATE);
+  rrReg.reset(SAMPLE_RATE);
+  lvI.spk = lvI.npk = 0;
+  lvF.spk = lvF.npk = 0;
+  lvI.update();
+  lvF.update();
+  startLearning();
+}
+
+/**
+ * @brief Procesa una muestra filtrada
+ *
+ * @param x Muestra filtrada (cuentas del ADC)
+ * @param beat Latido detectado (solo válido si retorna true)
+ * @return true Si se confirmó un latido en esta muestra
+ */
+bool qrsProcess(float x, QrsBeat *beat) {
+  int32_t xi = (int32_t)(x >= 0 ? x + 0.5f : x - 0.5f);
+  int32_t ax = xi >= 0 ? xi : -xi;
+  uint32_t pos = n;
+
+  // Derivada de 5 puntos: (2x[n] + x[n-1] - x[n-3] - 2x[n-4]) / 8
+  int32_t d = (2 * xi + xh[0] - xh[2] - 2 * xh[3]) / 8;
+  xh[3] = xh[2];
+  xh[2] = xh[1];
+  xh[1] = xh[0];
+  xh[0] = xi;
+  if (d > SLOPE_MAX) d = SLOPE_MAX;
+  if (d < -SLOPE_MAX) d = -SLOPE_MAX;
+  int32_t ad = d >= 0 ? d : -d;
+
+  // Cuadrado e integración en ventana móvil
+  uint32_t sq = (uint32_t)(d * d);
+  mwiSum += sq - mwiBuf[mwiIdx];
+  mwiBuf[mwiIdx] = sq;
+  if (++mwiIdx >= MWI_LEN) mwiIdx = 0;
+  uint32_t mwi = mwiSum / MWI_LEN;
+
+  n++;
+
+  // Máximos de la señal filtrada y de la pendiente desde el último pico
+  if (ax > fMax) {
+    fMax = ax;
+    fMaxSample = pos;
+  }
+  if (ad > slopeMax) slopeMax = ad;
+
+  // Fase de aprendizaje
+  if (n - learnStart <= LEARN_LEN) {
+    if (mwi > learnMaxI) learnMaxI = mwi;
+    if ((uint32_t)ax > learnMaxF) learnMaxF = ax;
+    learnSumI += mwi;
+    learnSumF += ax;
+    if (n - learnStart == LEARN_LEN) {
+      finishLearning();
+      pkVal = 0;
+      fMax = 0;
+      slopeMax = 0;
+    }
+    return false;
+  }
+
+  // Pico de la señal integrada: se confirma cuando cae a la mitad
+  bool found = false;
+  if (mwi > pkVal) {
+    pkVal = mwi;
+  } else if (pkVal > 0 && 2 * mwi < pkVal) {
+    found = classifyPeak(pkVal, fMax, fMaxSample, slopeMax, beat);
+    pkVal = 0;
+    fMax = 0;
+    slopeMax = 0;
+  }
+  if (found) return true;
+
+  if (haveQrs) {
+    uint32_t since = pos - lastQrs;
+
+    // Search-back: sin QRS en 166% del RR de referencia
+    if (cand && since * 100 > rrReference() * 166 && candSample - lastQrs >= REFRACT_LEN) {
+      lvI.spk = 0.25f * candI + 0.75f * lvI.spk;
+      lvF.spk = 0.25f * candF + 0.75f * lvF.spk;
+      lvI.update();
+      lvF.update();
+      acceptQrs(candSample, candSlope, true, beat);
+      return true;
+    }
+
+    // Señal perdida (electrodo suelto): reaprender umbrales
+    if (since > RELEARN_LEN) {
+      haveQrs = false;
+      cand = false;
+      startLearning();
+    }
+  } else if (n - learnStart > LEARN_LEN + RELEARN_LEN) {
+    startLearning();
+  }
+  return false;
+}
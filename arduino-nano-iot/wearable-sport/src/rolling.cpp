@@ -0,0 +1,125 @@
+/**
+ * @file rolling.cpp
+ * @brief Implementación de las ventanas deslizantes de carga
+ * @authors Juan Perez, Ana Gomez
+ * @date 2025
+ */
+
+#include "rolling.h"
+
+static_assert(ROLL_SECONDS >= 600, "La ventana de 10 min necesita ROLL_SECONDS >= 600");
+
+/** @brief Longitud de cada ventana (s) */
+static const uint16_t WIN_S[ROLL_WINDOWS] = {60, 300, 600};
+
+/** @brief Escala del TRIMP entero: peso × 1000 por segundo, TRIMP = suma / 60000 */
+static const float TRIMP_Q = 1000.0f;
+
+// ==================== ESTADO ====================
+
+/**
+ * @struct WinSum
+ * @brief Sumas enteras de una ventana
+ */
+struct WinSum {
+  int32_t distDm;
+  int32_t hsDm;
+  int32_t trimpQ;
+  uint16_t hz[6];
+};
+
+static uint16_t binDist[ROLL_SECONDS];   ///< Distancia de cada segundo (0.1 m)
+static uint16_t binHs[ROLL_SECONDS];     ///< Distancia a alta velocidad (0.1 m)
+static uint8_t binHz[ROLL_SECONDS];      ///< Zona de FC
+static uint16_t head = 0;                ///< Próximo bin a escribir
+static uint16_t filled = 0;              ///< Bins válidos (satura en ROLL_SECONDS)
+
+static WinSum sums[ROLL_WINDOWS];
+static int32_t peakDist5 = 0, peakHs5 = 0, peakTrimp5 = 0;
+static int32_t trimpW[6];                ///< Pesos escalados por TRIMP_Q
+
+static float secDistDm = 0.0f;           ///< Distancia del segundo en curso (0.1 m)
+static float secHsDm = 0.0f;
+
+// ==================== INTERFAZ ====================
+
+void rollingBegin(const float w[6]) {
+  for (int i = 0; i < 6; i++) trimpW[i] = (int32_t)(w[i] * TRIMP_Q + 0.5f);
+  for (int k = 0; k < ROLL_WINDOWS; k++) sums[k] = WinSum();
+  head = filled = 0;
+  peakDist5 = peakHs5 = peakTrimp5 = 0;
+  secDistDm = secHsDm = 0.0f;
+}
+
+void rollingAddDistance(float d_m, int vz) {
+  secDistDm += d_m * 10.0f;
+  if (vz >= ROLL_HS_ZONE) secHsDm += d_m * 10.0f;
+}
+
+void rollingSecond(int hz) {
+  // Redondeo del segundo; el resto pasa al siguiente para no perder distancia
+  uint16_t d = secDistDm >= 65535.0f ? 65535 : (uint16_t)(secDistDm + 0.5f);
+  uint16_t hs = secHsDm >= 65535.0f ? 65535 : (uint16_t)(secHsDm + 0.5f);
+  if (hs > d) hs = d;
+  secDistDm -= d;
+  secHsDm -= hs;
+
+  // Sale de cada ventana el bin de hace WIN_S segundos (para 10 min, el que se sobrescribe)
+  for (int k = 0; k < ROLL_WINDOWS; k++) {
+    WinSum &s = sums[k];
+    if (filled >= WIN_S[k]) {
+      uint16_t old = head >= WIN_S[k] ? head - WIN_S[k] : head + ROLL_SECONDS - WIN_S[k];
+      s.distDm -= binDist[old];
+      s.hsDm -= binHs[old];
+      s.trimpQ -= trimpW[binHz[old]];
+      s.hz[binHz[old]]--;
+    }
+    s.distDm += d;
+    s.hsDm += hs;
+    s.trimpQ += trimpW[hz];
+    s.hz[hz]++;
+  }
+
+  binDist[head] = d;
+  binHs[head] = hs;
+  binHz[head] = (uint8_t)hz;
+  if (++head == ROLL_SECONDS) head = 0;
+  if (filled < ROLL_SECONDS) filled++;
+
+  // Picos sobre ventanas de 5 min completas
+  if (filled >= WIN_S[ROLL_5MIN]) {
+    const WinSum &s = sums[ROLL_5MIN];
+    if (s.distDm > peakDist5) peakDist5 = s.distDm;
+    if (s.hsDm > peakHs5) peakHs5 = s.hsDm;
+    if (s.trimpQ > peakTrimp5) peakTrimp5 = s.trimpQ;
+  }
+}
+
+RollingTotals rollingTotals(RollWindow w) {
+  const WinSum &s = sums[w];
+  RollingTotals t;
+  t.distM = s.distDm * 0.1f;
+  t.hsDistM = s.hsDm * 0.1f;
+  t.trimp = s.trimpQ * (1.0f / (60.0f * TRIMP_Q));
+  for (int i = 0; i < 6; i++) t.secInHZ[i] = s.hz[i];
+  t.seconds = filled < WIN_S[w] ? filled : WIN_S[w];
+  return t;
+}
+
+RollingPeaks rollingPeaks() {
+  RollingPeaks p;
+  p.dist5M = peakDist5 * 0.1f;
+  p.hsDist5M = peakHs5 * 0.1f;
+  p.trimp5 = peakTrimp5 * (1.0f / (60.0f * TRIMP_Q));
+  return p;
+}
+
+float rollingAcuteChronic() {
+  const WinSum &a = sums[ROLL_1MIN];
+  const WinSum &c = sums[ROLL_10MIN];
+  uint16_t sa = filled < WIN_S[ROLL_1MIN] ? filled : WIN_S[ROLL_1MIN];
+  uint16_t sc = filled < WIN_S[ROLL_10MIN] ? filled : WIN_S[ROLL_10MIN];
+  if (c.trimpQ <= 0 || sa == 0) return 0.0f;
+  // (a / sa) / (c / sc)
+  return ((float)a.trimpQ * sc) / ((float)c.trimpQ * sa);
+}
@@ -0,0 +1,275 @@
+/**
+ * @file scheduler.cpp
+ * @brief Implementación del planificador de tareas
+ * @authors Juan Perez, Ana Gomez
+ * @date 2025
+ */
+
+#include "scheduler.h"
+
+#if defined(ARDUINO_ARCH_SAMD)
+/** @brief Reloj de TC4: GCLK0 (48 MHz) / 64 */
+static const uint32_t SCHED_TC_HZ = 48000000UL / 64;
+
+static_assert(SCHED_TC_HZ / 1000UL * SCHED_TICK_US / 1000UL - 1 <= 0xFFFF, "SCHED_TICK_US demasiado largo para TC4");
+#endif
+
+// ==================== ESTADO ====================
+
+/**
+ * @struct Task
+ * @brief Tarea registrada
+ */
+struct Task {
+  const char *name;
+  TaskFn fn;
+  uint32_t periodUs;                     ///< 0 = liberada por schedRelease()
+  uint32_t nextUs;                       ///< Próxima liberación nominal
+  volatile uint32_t releaseUs;           ///< Liberación nominal pendiente
+  volatile bool pending;
+  uint8_t mode;
+  uint8_t prio;
+  TaskStats st;
+};
+
+static Task tasks[SCHED_MAX_TASKS];
+static uint8_t order[SCHED_MAX_TASKS];   ///< Índices de tareas por prioridad
+static int nTasks = 0;
+
+// ==================== FUNCIONES INTERNAS ====================
+
+/**
+ * @brief Marca una tarea como pendiente (contexto de interrupción)
+ */
+static inline void release(Task &t, uint32_t atUs) {
+  if (t.pending) {
+    t.st.missed++;
+  } else {
+    t.releaseUs = atUs;
+    t.pending = true;
+  }
+}
+
+/**
+ * @brief Ejecuta una tarea ya retirada de pendientes y actualiza sus estadísticas
+ */
+static void execute(Task &t, uint32_t releaseUs) {
+  uint32_t start = micros();
+  t.fn();
+  uint32_t exec = micros() - start;
+  uint32_t jitter = start - releaseUs;
+
+  t.st.runs++;
+  t.st.jitterSumUs += jitter;
+  t.st.execSumUs += exec;
+  if (jitter > t.st.jitterMaxUs) t.st.jitterMaxUs = jitter;
+  if (exec > t.st.execMaxUs) t.st.execMaxUs = exec;
+}
+
+/**
+ * @brief Tick del planificador: libera las tareas vencidas y ejecuta las SCHED_ISR
+ */
+static void schedTick() {
+  uint32_t now = micros();
+  for (int k = 0; k < nTasks; k++) {
+    Task &t = tasks[order[k]];
+    if (t.periodUs && (int32_t)(now - t.nextUs) >= 0) {
+      release(t, t.nextUs);
+      t.nextUs += t.periodUs;
+      // Atraso mayor a un periodo: esas liberaciones se pierden
+      while ((int32_t)(now - t.nextUs) >= 0) {
+        t.nextUs += t.periodUs;
+        t.st.missed++;
+      }
+    }
+    if (t.mode == SCHED_ISR && t.pending) {
+      t.pending = false;
+      execute(t, t.releaseUs);
+    }
+  }
+}
+
+// ==================== TEMPORIZADOR ====================
+
+#if defined(ARDUINO_ARCH_SAMD)
+
+static inline void syncTc4() {
+  while (TC4->COUNT16.STATUS.bit.SYNCBUSY);
+}
+
+/**
+ * @brief TC4 en modo MFRQ a SCHED_TICK_US, con la menor prioridad del NVIC
+ */
+static void timerBegin() {
+  PM->APBCMASK.reg |= PM_APBCMASK_TC4;
+  GCLK->CLKCTRL.reg = GCLK_CLKCTRL_ID_TC4_TC5 | GCLK_CLKCTRL_GEN_GCLK0 | GCLK_CLKCTRL_CLKEN;
+  while (GCLK->STATUS.bit.SYNCBUSY);
+  TC4->COUNT16.CTRLA.reg &= ~TC_CTRLA_ENABLE;
+  syncTc4();
+  TC4->COUNT16.CTRLA.reg = TC_CTRLA_SWRST;
+  while (TC4->COUNT16.CTRLA.reg & TC_CTRLA_SWRST);
+  TC4->COUNT16.CTRLA.reg = TC_CTRLA_MODE_COUNT16 |
+                           TC_CTRLA_WAVEGEN_MFRQ |
+                           TC_CTRLA_PRESCALER_DIV64;
+  TC4->COUNT16.CC[0].reg = (uint16_t)(SCHED_TC_HZ / 1000UL * SCHED_TICK_US / 1000UL - 1);
+  syncTc4();
+  TC4->COUNT16.INTENSET.reg = TC_INTENSET_OVF;
+  NVIC_SetPriority(TC4_IRQn, (1 << __NVIC_PRIO_BITS) - 1);
+  NVIC_ClearPendingIRQ(TC4_IRQn);
+  NVIC_EnableIRQ(TC4_IRQn);
+  TC4->COUNT16.CTRLA.reg |= TC_CTRLA_ENABLE;
+  syncTc4();
+}
+
+/**
+ * @brief Tick de TC4, o despacho inmediato pedido por schedRelease()
+ */
+extern "C" void TC4_Handler(void) {
+  if (TC4->COUNT16.INTFLAG.reg & TC_INTFLAG_OVF) {
+    TC4->COUNT16.INTFLAG.reg = TC_INTFLAG_OVF;
+  }
+  schedTick();
+}
+
+#else
+
+static void timerBegin() {}
+
+#endif // ARDUINO_ARCH_SAMD
+
+// ==================== INTERFAZ ====================
+
+/**
+ * @brief Registra una tarea
+ *
+ * @param name Nombre para el reporte
+ * @param fn Función de la tarea
+ * @param periodUs Periodo (múltiplo de SCHED_TICK_US), o 0 si la libera schedRelease()
+ * @param mode SCHED_ISR o SCHED_DEFERRED
+ * @param prio Prioridad (0 = la más alta)
+ * @return int Identificador de la tarea, o -1 si no hay espacio
+ */
+int schedAdd(const char *name, TaskFn fn, uint32_t periodUs, SchedMode mode, uint8_t prio) {
+  if (nTasks >= SCHED_MAX_TASKS) return -1;
+  int id = nTasks;
+  Task &t = tasks[id];
+  t.name = name;
+  t.fn = fn;
+  t.periodUs = periodUs;
+  t.nextUs = 0;
+  t.releaseUs = 0;
+  t.pending = false;
+  t.mode = (uint8_t)mode;
+  t.prio = prio;
+  t.st = TaskStats{0, 0, 0, 0, 0, 0};
+
+  // Inserción ordenada por prioridad (estable entre iguales)
+  int k = nTasks;
+  while (k > 0 && tasks[order[k - 1]].prio > prio) {
+    order[k] = order[k - 1];
+    k--;
+  }
+  order[k] = (uint8_t)id;
+  nTasks++;
+  return id;
+}
+
+/**
+ * @brief Inicia el tick; la primera liberación de cada tarea es un periodo después
+ */
+void schedBegin() {
+  uint32_t now = micros();
+  for (int i = 0; i < nTasks; i++) {
+    tasks[i].nextUs = now + tasks[i].periodUs;
+  }
+  timerBegin();
+}
+
+/**
+ * @brief Libera una tarea de periodo 0 (seguro en interrupciones)
+ *
+ * @param id Identificador de la tarea
+ */
+void schedRelease(int id) {
+  if (id < 0 || id >= nTasks) return;
+  release(tasks[id], micros());
+#if defined(ARDUINO_ARCH_SAMD)
+  if (tasks[id].mode == SCHED_ISR) {
+    NVIC_SetPendingIRQ(TC4_IRQn);        // Despacho sin esperar al siguiente tick
+  }
+#endif
+}
+
+/**
+ * @brief Ejecuta las tareas diferidas pendientes por orden de prioridad
+ *
+ * Tras cada ejecución se vuelve a buscar desde la prioridad más alta.
+ */
+void schedRun() {
+#if !defined(ARDUINO_ARCH_SAMD)
+  schedTick();                           // Sin temporizador: el tick se emula en cada pasada
+#endif
+  for (;;) {
+    Task *next = nullptr;
+    uint32_t releaseUs = 0;
+    noInterrupts();
+    for (int k = 0; k < nTasks; k++) {
+      Task &t = tasks[order[k]];
+      if (t.mode == SCHED_DEFERRED && t.pending) {
+        t.pending = false;
+        releaseUs = t.releaseUs;
+        next = &t;
+        break;
+      }
+    }
+    interrupts();
+    if (!next) return;
+    execute(*next, releaseUs);
+  }
+}
+
+/**
+ * @brief Lee y reinicia las estadísticas de una tarea
+ *
+ * @param k Posición por orden de prioridad
+ * @param name Nombre de la tarea
+ * @param st Estadísticas desde la lectura anterior
+ * @return false Si k no corresponde a una tarea
+ */
+bool schedTakeStats(int k, const char **name, TaskStats *st) {
+  if (k < 0 || k >= nTasks) return false;
+  Task &t = tasks[order[k]];
+  noInterrupts();
+  *st = t.st;
+  t.st = TaskStats{0, 0, 0, 0, 0, 0};
+  interrupts();
+  *name = t.name;
+  return true;
+}
+
+/**
+ * @brief Imprime las estadísticas de todas las tareas y las reinicia
+ *
+ * @param out Destino (Serial, archivo, ...)
+ */
+void schedPrintStats(Print &out) {
+  out.println(F("Tarea       ejec perd  jitter prom/max   ejec prom/max (us)"));
+  const char *name;
+  TaskStats s;
+  for (int k = 0; schedTakeStats(k, &name, &s); k++) {
+    out.print(name);
+    for (int n = strlen(name); n < 10; n++) out.print(' ');
+    out.print(' ');
+    out.print(s.runs);
+    out.print(' ');
+    out.print(s.missed);
+    out.print(F("  "));
+    out.print(s.runs ? s.jitterSumUs / s.runs : 0);
+    out.print('/');
+    out.print(s.jitterMaxUs);
+    out.print(F("  "));
+    out.print(s.runs ? s.execSumUs / s.runs : 0);
+    out.print('/');
+    out.println(s.execMaxUs);
+  }
+}
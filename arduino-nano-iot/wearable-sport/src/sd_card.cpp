@@ -14,132 +14,168 @@
 #include "velocity_zones.h"
 #include "heart_rate_zones.h"
 #include "metrics.h"
+#include "sd_logger.h"
+
+/** @brief Encabezado del CSV: nombres de todas las columnas de guardarDatosCSV() */
+static const char CSV_HEADER[] =
+    "Timestamp,Dist_m,Dist_Total_km,Vel_Prom_kmh,Vel_Max_kmh,"
+    "BPM_Prom,Seg_CAM,Seg_TRO,Seg_CAR,Seg_SPR,"
+    "Dist_CAM_m,Dist_TRO_m,Dist_CAR_m,Dist_SPR_m,"
+    "Seg_HZ1,Seg_HZ2,Seg_HZ3,Seg_HZ4,Seg_HZ5,Seg_HZ6,"
+    "TRIMP,Sprints_Min,Sprints_Total,"
+    "RMSSD_ms,SDNN_ms,pNN50";
+
+/**
+ * @brief Indica si se pueden agregar filas a path
+ *
+ * @return true Si no existe, está vacío o su primera línea es CSV_HEADER
+ */
+static bool csvAppendable(const char *path) {
+  File f = SD.open(path, FILE_READ);
+  if (!f) return true;
+  bool ok = f.size() == 0;
+  if (!ok) {
+    // Se compara carácter a carácter; basta leer hasta el fin de línea
+    size_t i = 0;
+    int c;
+    while ((c = f.read()) >= 0 && c != '\r' && c != '\n') {
+      if (i >= sizeof(CSV_HEADER) - 1 || c != CSV_HEADER[i]) break;
+      i++;
+    }
+    ok = i == sizeof(CSV_HEADER) - 1 && (c == '\r' || c == '\n');
+  }
+  f.close();
+  return ok;
+}
 
 /**
- * @brief Crea el archivo CSV con encabezados si no existe
+ * @brief Abre el archivo CSV y escribe los encabezados si está vacío
  * 
- * Crea el archivo CSV en la tarjeta SD e inserta la línea de encabezados
- * con los nombres de todas las columnas.
+ * El archivo queda abierto en sdLog. Si CSV_FILENAME tiene otras columnas
+ * (escrito por una versión anterior del firmware) no se le agregan filas:
+ * se usa el primer datosNN.csv libre o con el encabezado actual.
  */
 void crearArchivoCSV() {
-  if (!SD.exists(CSV_FILENAME)) {
-    File dataFile = SD.open(CSV_FILENAME, FILE_WRITE);
-    if (dataFile) {
-      // Escribir encabezados
-      dataFile.println(F("Timestamp,Dist_m,Dist_Total_km,Vel_Prom_kmh,Vel_Max_kmh,"
-                         "BPM_Prom,Seg_CAM,Seg_TRO,Seg_CAR,Seg_SPR,"
-                         "Dist_CAM_m,Dist_TRO_m,Dist_CAR_m,Dist_SPR_m,"
-                         "Seg_HZ1,Seg_HZ2,Seg_HZ3,Seg_HZ4,Seg_HZ5,Seg_HZ6,"
-                         "TRIMP,Sprints_Min,Sprints_Total"));
-      dataFile.close();
-      Serial.println(F("Archivo CSV creado con encabezados"));
-    } else {
-      Serial.println(F("Error al crear archivo CSV"));
+  char name[] = "datos00.csv";
+  const char *path = CSV_FILENAME;
+  for (int n = 0; !csvAppendable(path); n++) {
+    if (n == 100) {
+      Serial.println(F("Error: sin nombre libre para el CSV"));
+      return;
     }
+    name[5] = (char)('0' + n / 10);
+    name[6] = (char)('0' + n % 10);
+    path = name;
+  }
+  if (path == name) {
+    Serial.print(F(CSV_FILENAME " tiene otras columnas; se usa "));
+    Serial.println(path);
+  }
+
+  if (!sdLog.begin(path)) {
+    Serial.println(F("Error al abrir archivo CSV"));
+    return;
+  }
+  if (sdLog.size() == 0) {
+    sdLog.println(CSV_HEADER);
+    sdLog.flush();
+    Serial.println(F("Archivo CSV creado con encabezados"));
   }
 }
 
 /**
- * @brief Guarda los datos del resumen del minuto en el archivo CSV
+ * @brief Agrega el resumen de un minuto cerrado al archivo CSV
  * 
- * @param bpmMeanMin BPM promedio del minuto
- * @param vMeanMin Velocidad promedio del minuto (km/h)
+ * La fila se formatea en el buffer de sdLog; la tarea de SD la escribe en
+ * la tarjeta por sectores.
+ * 
+ * @param m Acumuladores del minuto
+ * @param hrv Métricas de HRV al cierre del minuto
  */
-void guardarDatosCSV(float bpmMeanMin, float vMeanMin) {
-  File dataFile = SD.open(CSV_FILENAME, FILE_WRITE);
+void guardarDatosCSV(const MinuteBank &m, const HrvMetrics &hrv) {
+  Print &dataFile = sdLog;
   
-  if (dataFile) {
+  if (sdLog) {
     // Timestamp (si GPS disponible)
-    if (gps.date.isValid() && gps.time.isValid()) {
-      dataFile.print(gps.date.year());
+    const GpsFix &fix = gps.fix();
+    if (fix.has(GPS_DATE | GPS_TIME)) {
+      dataFile.print(fix.year);
       dataFile.print('-');
-      if (gps.date.month() < 10) dataFile.print('0');
-      dataFile.print(gps.date.month());
+      if (fix.month < 10) dataFile.print('0');
+      dataFile.print(fix.month);
       dataFile.print('-');
-      if (gps.date.day() < 10) dataFile.print('0');
-      dataFile.print(gps.date.day());
+      if (fix.day < 10) dataFile.print('0');
+      dataFile.print(fix.day);
       dataFile.print(' ');
       
-      int lh = wrapLocalHour(gps.time.hour(), UTC_OFFSET_H);
+      int lh = wrapLocalHour(fix.hour, UTC_OFFSET_H);
       if (lh < 10) dataFile.print('0');
       dataFile.print(lh);
       dataFile.print(':');
-      if (gps.time.minute() < 10) dataFile.print('0');
-      dataFile.print(gps.time.minute());
+      if (fix.minute < 10) dataFile.print('0');
+      dataFile.print(fix.minute);
       dataFile.print(':');
-      if (gps.time.second() < 10) dataFile.print('0');
-      dataFile.print(gps.time.second());
+      if (fix.second < 10) dataFile.print('0');
+      dataFile.print(fix.second);
     } else {
       dataFile.print(millis() / 1000); // Usar millis como fallback
     }
     dataFile.print(',');
     
     // Distancias
-    dataFile.print(dist_m_minute, 1);
+    dataFile.print(m.distM, 1);
     dataFile.print(',');
-    dataFile.print(dist_m_total / 1000.0f, 3);
+    dataFile.print(m.distTotalM / 1000.0f, 3);
     dataFile.print(',');
     
     // Velocidades
-    dataFile.print(vMeanMin, 1);
+    dataFile.print(m.vMeanKmh(), 1);
     dataFile.print(',');
-    dataFile.print(v_kmh_max_min, 1);
+    dataFile.print(m.vMaxKmh, 1);
     dataFile.print(',');
     
     // BPM
-    dataFile.print(bpmMeanMin, 1);
+    dataFile.print(m.bpmMean(), 1);
     dataFile.print(',');
     
     // Zonas de velocidad - tiempo
     for (int i = 0; i < 4; i++) {
-      dataFile.print((int)secInVZ[i]);
+      dataFile.print((int)m.secInVZ[i]);
       dataFile.print(',');
     }
     
     // Zonas de velocidad - distancia
     for (int i = 0; i < 4; i++) {
-      dataFile.print((int)distInVZ[i]);
+      dataFile.print((int)m.distInVZ[i]);
       dataFile.print(',');
     }
     
     // Zonas de frecuencia cardíaca
     for (int i = 0; i < 6; i++) {
-      dataFile.print((int)secInHZ[i]);
+      dataFile.print((int)m.secInHZ[i]);
       if (i < 5) dataFile.print(',');
     }
     dataFile.print(',');
     
     // TRIMP y Sprints
-    dataFile.print(trimpMinute, 2);
+    dataFile.print(m.trimp, 2);
+    dataFile.print(',');
+    dataFile.print(m.sprints);
+    dataFile.print(',');
+    dataFile.print(m.sprintsTotal);
     dataFile.print(',');
-    dataFile.print(sprints_min);
+    
+    // Variabilidad de la frecuencia cardíaca
+    dataFile.print(hrv.rmssd, 1);
+    dataFile.print(',');
+    dataFile.print(hrv.sdnn, 1);
     dataFile.print(',');
-    dataFile.println(sprints_total);
+    dataFile.println(hrv.pnn50, 1);
     
-    dataFile.close();
+#if TELEMETRY == TELEM_TEXT
     Serial.println(F("Datos guardados en SD"));
+#endif
   } else {
-    Serial.println(F("Error al abrir archivo CSV"));
-  }
-}
-
-/**
- * @brief Reinicia todos los acumuladores del minuto actual
- */
-void resetMinuteAccumulators() {
-  for (int i = 0; i < 4; i++) {
-    secInVZ[i] = 0;
-    distInVZ[i] = 0;
-  }
-  for (int i = 0; i < 6; i++) {
-    secInHZ[i] = 0;
+    Serial.println(F("Error: archivo CSV no disponible"));
   }
-  trimpMinute = 0;
-  dist_m_minute = 0;
-  v_kmh_max_min = 0;
-  sprints_min = 0;
-  bpmSumSec = 0;
-  bpmSecCount = 0;
-  sprintHold_s = 0;
-  inSprint = false;
 }
@@ -0,0 +1,129 @@
+/**
+ * @file sd_logger.cpp
+ * @brief Implementación del registro en SD con buffer circular
+ * @authors Juan Perez, Ana Gomez
+ * @date 2025
+ */
+
+#include "sd_logger.h"
+
+static uint8_t sdLogRing[SD_LOG_RING];
+static uint8_t sprintLogRing[SPRINT_LOG_RING];
+
+SdLogger sdLog(sdLogRing, SD_LOG_RING);
+SdLogger sprintLog(sprintLogRing, SPRINT_LOG_RING);
+
+/**
+ * @brief Abre (o crea) el archivo para agregar al final
+ *
+ * @param path Nombre del archivo
+ * @return true Si el archivo quedó abierto
+ */
+bool SdLogger::begin(const char *path) {
+  file_ = SD.open(path, FILE_WRITE);
+  open_ = (bool)file_;
+  head_ = tail_ = open_ ? file_.size() : 0;
+  lastFlushMs_ = millis();
+  return open_;
+}
+
+size_t SdLogger::write(uint8_t c) {
+  return write(&c, 1);
+}
+
+/**
+ * @brief Copia bytes al buffer circular (no accede a la tarjeta)
+ */
+size_t SdLogger::write(const uint8_t *buf, size_t n) {
+  if (!open_) return 0;
+  uint32_t room = ringSize_ - (head_ - tail_);
+  if (n > room) {
+    st_.dropped += n - room;
+    n = room;
+  }
+  // Un solo módulo por llamada: el tamaño ya no es constante de compilación
+  uint32_t idx = head_ % ringSize_;
+  for (size_t i = 0; i < n; i++) {
+    ring_[idx] = buf[i];
+    if (++idx == ringSize_) idx = 0;
+  }
+  head_ += n;
+  return n;
+}
+
+/**
+ * @brief Escribe n bytes desde tail_, sin cruzar el final del buffer
+ *
+ * Como el buffer es múltiplo de 512 y el índice del buffer es el
+ * desplazamiento en el archivo, un tramo que termina en frontera de sector
+ * nunca cruza el final del buffer.
+ */
+void SdLogger::writeChunk(uint32_t n) {
+  uint32_t idx = tail_ % ringSize_;
+  if (n > ringSize_ - idx) n = ringSize_ - idx;
+  uint32_t t0 = micros();
+  size_t w = file_.write(ring_ + idx, n);
+  uint32_t dt = micros() - t0;
+  if (dt > st_.writeMaxUs) st_.writeMaxUs = dt;
+  st_.bytes += w;
+  tail_ += w;
+  if (w != n) {
+    // Error de escritura: el archivo solo avanzó w bytes, así que tail_ ya no
+    // sería su desplazamiento. Se cierra el registro y se descarta lo pendiente.
+    st_.errors++;
+    st_.dropped += head_ - tail_;
+    head_ = tail_;
+    file_.close();
+    open_ = false;
+    return;
+  }
+  if (n == 512) st_.sectors++;
+}
+
+/**
+ * @brief Escribe los sectores completos pendientes y sincroniza si corresponde
+ *
+ * @param nowMs Tiempo actual en ms
+ */
+void SdLogger::service(uint32_t nowMs) {
+  if (!open_) return;
+
+  // Completar el sector actual del archivo y luego sectores completos
+  for (;;) {
+    uint32_t toBoundary = 512 - (tail_ % 512);
+    if (head_ - tail_ < toBoundary) break;
+    writeChunk(toBoundary);
+  }
+
+  if (nowMs - lastFlushMs_ >= SD_LOG_FLUSH_MS) {
+    flush();
+    lastFlushMs_ = nowMs;
+  }
+}
+
+/**
+ * @brief Escribe todo lo pendiente (incluido el sector parcial) y sincroniza
+ */
+void SdLogger::flush() {
+  if (!open_) return;
+  while (head_ != tail_) {
+    writeChunk(head_ - tail_);
+  }
+  if (!open_) return;
+  uint32_t t0 = micros();
+  file_.flush();
+  uint32_t dt = micros() - t0;
+  if (dt > st_.flushMaxUs) st_.flushMaxUs = dt;
+  st_.flushes++;
+  lastFlushMs_ = millis();
+}
+
+/**
+ * @brief Copia las estadísticas y reinicia las latencias máximas
+ */
+SdLogStats SdLogger::takeStats() {
+  SdLogStats s = st_;
+  st_.writeMaxUs = 0;
+  st_.flushMaxUs = 0;
+  return s;
+}
@@ -0,0 +1,227 @@
+/**
+ * @file session_log.cpp
+ * @brief Escritura del registro binario de sesión
+ * @authors Juan Perez, Ana Gomez
+ * @date 2025
+ */
+
+#include <Arduino.h>
+#include <SD.h>
+#include <string.h>
+#include "session_log.h"
+#include "config.h"
+#include "gps_processing.h"
+#include "velocity_zones.h"
+#include "heart_rate_zones.h"
+#include "metrics.h"
+#include "sd_logger.h"
+
+static uint32_t recSeq = 0;              ///< Registros escritos desde el arranque
+static uint32_t sprintSeq = 0;           ///< Sprints escritos desde el arranque
+
+// ==================== FUNCIONES INTERNAS ====================
+
+/**
+ * @brief Verifica el encabezado de un archivo existente
+ */
+static bool headerMatches(const char *path, const char *magic) {
+  File f = SD.open(path, FILE_READ);
+  if (!f) return false;
+  SessionLogHeader h;
+  bool ok = f.read(&h, sizeof(h)) == (int)sizeof(h) &&
+            memcmp(h.magic, magic, 4) == 0 &&
+            h.version == SESSION_LOG_VERSION &&
+            h.headerSize == sizeof(SessionLogHeader) &&
+            h.crc == crc16Ccitt(&h, offsetof(SessionLogHeader, crc));
+  f.close();
+  return ok;
+}
+
+/**
+ * @brief Abre un registro y escribe el encabezado si el archivo está vacío
+ *
+ * @return true Si el registro quedó abierto
+ */
+static bool logOpen(SdLogger &log, const char *path, const char *magic) {
+  if (SD.exists(path) && !headerMatches(path, magic)) {
+    Serial.print(F("Error: "));
+    Serial.print(path);
+    Serial.println(F(" tiene otro formato; no se registrará"));
+    return false;
+  }
+  if (!log.begin(path)) {
+    Serial.print(F("Error al abrir "));
+    Serial.println(path);
+    return false;
+  }
+  if (log.size() == 0) {
+    SessionLogHeader h;
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, magic, 4);
+    h.version = SESSION_LOG_VERSION;
+    h.headerSize = sizeof(SessionLogHeader);
+    h.utcOffsetH = UTC_OFFSET_H;
+    h.crc = crc16Ccitt(&h, offsetof(SessionLogHeader, crc));
+    log.write((const uint8_t *)&h, sizeof(h));
+    log.flush();
+    Serial.print(path);
+    Serial.println(F(": archivo binario creado con encabezado"));
+  }
+  return true;
+}
+
+// ==================== INTERFAZ ====================
+
+/**
+ * @brief Abre el archivo binario y escribe el encabezado si está vacío
+ */
+void sessionLogBegin() {
+  logOpen(sdLog, LOG_BIN_FILENAME, "WSLG");
+}
+
+/**
+ * @brief Arma el registro de un minuto cerrado a partir de su banco
+ *
+ * @param m Acumuladores del minuto ya cerrado (ver minuteSwap() en metrics.h)
+ * @param hrv Métricas de HRV al cierre del minuto
+ * @param out Registro (con CRC)
+ */
+void sessionMinuteRecord(const MinuteBank &m, const HrvMetrics &hrv, MinuteRecord *out) {
+  MinuteRecord &r = *out;
+  r.pre.sync = SESSION_LOG_SYNC;
+  r.pre.type = REC_MINUTE;
+  r.pre.len = sizeof(MinuteRecord);
+  r.seq = recSeq++;
+  r.millisMs = millis();
+
+  // Timestamp (si GPS disponible)
+  const GpsFix &fix = gps.fix();
+  if (fix.has(GPS_DATE | GPS_TIME)) {
+    r.utcDate = fix.utcDate();
+    r.utcTime = fix.utcHms();
+  } else {
+    r.utcDate = 0;
+    r.utcTime = 0;
+  }
+
+  // Distancias y velocidades
+  r.distMinuteDm = toU16(m.distM, 10.0f);
+  r.distTotalDm = toU32(m.distTotalM, 10.0f);
+  r.vMean = toU16(m.vMeanKmh(), 100.0f);
+  r.vMax = toU16(m.vMaxKmh, 100.0f);
+  r.bpmMean = toU16(m.bpmMean(), 10.0f);
+
+  // Zonas
+  for (int i = 0; i < 4; i++) {
+    r.secVZ[i] = truncU8(m.secInVZ[i]);
+    r.distVZ[i] = truncU16(m.distInVZ[i]);
+  }
+  for (int i = 0; i < 6; i++) {
+    r.secHZ[i] = truncU8(m.secInHZ[i]);
+  }
+
+  // TRIMP, sprints y HRV
+  r.trimp = toU16(m.trimp, 100.0f);
+  r.sprintsMin = m.sprints > 255 ? 255 : (uint8_t)m.sprints;
+  r.sprintsTotal = m.sprintsTotal > 65535 ? 65535 : (uint16_t)m.sprintsTotal;
+  r.rmssd = toU16(hrv.rmssd, 10.0f);
+  r.sdnn = toU16(hrv.sdnn, 10.0f);
+  r.pnn50 = toU16(hrv.pnn50, 10.0f);
+
+  r.crc = crc16Ccitt(&r, offsetof(MinuteRecord, crc));
+}
+
+/**
+ * @brief Arma el registro de movimiento que acompaña a un MinuteRecord
+ *
+ * @param seq seq del MinuteRecord
+ * @param motion Movimiento del minuto
+ * @param out Registro (con CRC)
+ */
+void sessionMotionRecord(uint32_t seq, const MotionMinute &motion, MotionRecord *out) {
+  MotionRecord &m = *out;
+  m.pre.sync = SESSION_LOG_SYNC;
+  m.pre.type = REC_MOTION;
+  m.pre.len = sizeof(MotionRecord);
+  m.seq = seq;
+  m.steps = motion.steps;
+  m.cadence = toU16(motion.cadenceSpm, 10.0f);
+  m.impacts = motion.impacts;
+  m.peakMg = toU16(motion.peakG, 1000.0f);
+  m.fifoOverruns = motion.fifoOverruns;
+  m.crc = crc16Ccitt(&m, offsetof(MotionRecord, crc));
+}
+
+/**
+ * @brief Agrega el registro del minuto (a través de sdLog)
+ *
+ * @param r Registro del minuto
+ * @param m Movimiento del minuto (nullptr sin IMU)
+ */
+void sessionLogMinute(const MinuteRecord &r, const MotionRecord *m) {
+  if (!sdLog) {
+    Serial.println(F("Error: registro binario no disponible"));
+    return;
+  }
+  sdLog.write((const uint8_t *)&r, sizeof(r));
+  if (m) sdLog.write((const uint8_t *)m, sizeof(*m));
+#if TELEMETRY == TELEM_TEXT
+  Serial.println(F("Datos guardados en SD"));
+#endif
+}
+
+/**
+ * @brief Abre el archivo de sprints (en ambos formatos de registro)
+ */
+void sprintLogBegin() {
+  logOpen(sprintLog, SPRINT_LOG_FILENAME, "WSSP");
+}
+
+/**
+ * @brief Arma el registro de un sprint terminado
+ *
+ * La hora UTC del inicio se obtiene de la última época GPS con hora
+ * (lastGpsMs) retrocediendo lo transcurrido desde startMs.
+ *
+ * @param e Sprint
+ * @param out Registro (con CRC)
+ */
+void sessionSprintRecord(const SprintEvent &e, SprintRecord *out) {
+  SprintRecord &r = *out;
+  r.pre.sync = SESSION_LOG_SYNC;
+  r.pre.type = REC_SPRINT;
+  r.pre.len = sizeof(SprintRecord);
+  r.seq = sprintSeq++;
+  r.startMillis = e.startMs;
+
+  const GpsFix &fix = gps.fix();
+  if (fix.has(GPS_DATE | GPS_TIME)) {
+    const int32_t DAY_MS = 86400000L;
+    int32_t t = (int32_t)fix.utcMs();
+    t -= (int32_t)(lastGpsMs - e.startMs);
+    // La fecha queda la de la época (un sprint que cruza la medianoche)
+    while (t < 0) t += DAY_MS;
+    while (t >= DAY_MS) t -= DAY_MS;
+    r.utcDate = fix.utcDate();
+    r.utcStartMs = (uint32_t)t;
+  } else {
+    r.utcDate = 0;
+    r.utcStartMs = 0;
+  }
+
+  r.durationMs = e.durationMs;
+  r.distDm = toU16(e.distM, 10.0f);
+  r.vPeak = toU16(e.vPeakKmh, 100.0f);
+  r.aPeak = toI16(e.aPeakMs2, 100.0f);
+  r.crc = crc16Ccitt(&r, offsetof(SprintRecord, crc));
+}
+
+/**
+ * @brief Agrega el registro de un sprint (a través de sprintLog)
+ *
+ * @param r Registro del sprint
+ */
+void sessionLogSprint(const SprintRecord &r) {
+  if (!sprintLog) return;
+  sprintLog.write((const uint8_t *)&r, sizeof(r));
+}
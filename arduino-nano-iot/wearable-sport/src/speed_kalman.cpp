@@ -0,0 +1,50 @@
+/**
+ * @file speed_kalman.cpp
+ * @brief Implementación del filtro de Kalman de velocidad
+ * @authors Juan Perez, Ana Gomez
+ * @date 2025
+ */
+
+#include "speed_kalman.h"
+
+/** @brief Incertidumbre inicial del sesgo (m/s²): ±1 m/s² ≈ 6° de inclinación */
+static const float BIAS_VAR0 = 1.0f;
+
+SpeedKalman::SpeedKalman(float accSigma, float biasSigma)
+    : v_(0), b_(0), p00_(0), p01_(0), p11_(BIAS_VAR0),
+      qa_(accSigma * accSigma), qb_(biasSigma * biasSigma) {}
+
+void SpeedKalman::reset(float v, float bias) {
+  v_ = v < 0.0f ? 0.0f : v;
+  b_ = bias;
+  p00_ = 0.0f;
+  p01_ = 0.0f;
+  p11_ = BIAS_VAR0;
+}
+
+void SpeedKalman::predict(float a, float dt) {
+  v_ += (a - b_) * dt;
+  if (v_ < 0.0f) v_ = 0.0f;
+
+  // P = F·P·Fᵀ + Q con F = [1 -dt; 0 1]
+  float dtP11 = dt * p11_;
+  p00_ += dt * (dtP11 - 2.0f * p01_) + qa_ * dt * dt;
+  p01_ -= dtP11;
+  p11_ += qb_ * dt;
+}
+
+void SpeedKalman::update(float v, float var) {
+  float s = p00_ + var;
+  if (s <= 0.0f) return;
+  float k0 = p00_ / s;
+  float k1 = p01_ / s;
+  float y = v - v_;
+  v_ += k0 * y;
+  b_ += k1 * y;
+  if (v_ < 0.0f) v_ = 0.0f;
+
+  // P = (I - K·H)·P
+  p11_ -= k1 * p01_;
+  p00_ -= k0 * p00_;
+  p01_ -= k0 * p01_;
+}
@@ -0,0 +1,165 @@
+/**
+ * @file sprint.cpp
+ * @brief Implementación de la detección de sprints por eventos
+ * @authors Juan Perez, Ana Gomez
+ * @date 2025
+ */
+
+#include "sprint.h"
+#include "config.h"
+
+// ==================== CONSTANTES ====================
+
+const float SPRINT_KMH = 20.0;
+const float SPRINT_EXIT_KMH = 17.0;
+const uint32_t SPRINT_HOLD_MS = 2000;
+
+/** @brief Ventana de la derivada de la velocidad (ms) */
+static const uint32_t ACC_WIN_MS = 1000;
+
+// ==================== ESTADO ====================
+
+enum SprintState : uint8_t {
+  SPR_IDLE,                              ///< Bajo SPRINT_KMH (o ya bajo SPRINT_EXIT_KMH)
+  SPR_CANDIDATE,                         ///< Sobre el umbral, aún sin SPRINT_HOLD_MS
+  SPR_ACTIVE                             ///< Confirmado y contado
+};
+
+static SprintState state = SPR_IDLE;
+static bool havePrev = false;            ///< Hay muestra anterior (no hubo hueco)
+static float vPrev = 0.0f;               ///< Velocidad anterior (km/h)
+static uint32_t clockMs = 0;             ///< Reloj de las muestras: suma de los dt
+static uint32_t lastNowMs = 0;           ///< millis() de la muestra anterior
+static uint32_t startClk = 0;            ///< clockMs del inicio del sprint en curso
+static SprintEvent cur;                  ///< Sprint en curso
+
+static float vRef = 0.0f;                ///< Velocidad al inicio de la ventana de aceleración
+static uint32_t accElapsed = 0;          ///< ms acumulados en la ventana
+static float aLead = 0.0f;               ///< Aceleración máxima de la fase de aceleración actual
+
+static SprintEvent queue[SPRINT_QUEUE];
+static uint8_t qHead = 0;
+static uint8_t qCount = 0;
+static uint16_t dropped = 0;
+
+// ==================== FUNCIONES INTERNAS ====================
+
+/** @brief Distancia a velocidad media v durante ms (m) */
+static inline float distM(float v_kmh, uint32_t ms) {
+  return v_kmh * ms * (1.0f / 3600.0f);
+}
+
+static void push(const SprintEvent &e) {
+  if (qCount == SPRINT_QUEUE) {
+    if (dropped < 0xFFFF) dropped++;
+    return;
+  }
+  queue[(qHead + qCount) % SPRINT_QUEUE] = e;
+  qCount++;
+}
+
+/** @brief Confirma el sprint en curso si ya alcanzó la duración mínima */
+static bool confirm(uint32_t atClk) {
+  if (state == SPR_CANDIDATE && atClk - startClk >= SPRINT_HOLD_MS) {
+    state = SPR_ACTIVE;
+    return true;
+  }
+  return false;
+}
+
+/**
+ * @brief Cierra el sprint en curso; lo encola si cuenta
+ *
+ * @param endClk clockMs del final
+ * @return true Si se confirmó justo al cerrar (la duración interpolada alcanzó el mínimo)
+ */
+static bool close(uint32_t endClk) {
+  bool confirmed = confirm(endClk);
+  if (state == SPR_ACTIVE) {
+    cur.durationMs = endClk - startClk;
+    push(cur);
+  }
+  state = SPR_IDLE;
+  return confirmed;
+}
+
+// ==================== INTERFAZ ====================
+
+void sprintReset() {
+  state = SPR_IDLE;
+  havePrev = false;
+  qHead = qCount = 0;
+  dropped = 0;
+}
+
+bool sprintStep(float v_kmh, uint32_t dtMs, uint32_t nowMs) {
+  bool confirmed = false;
+
+  // Hueco sin velocidades: el sprint termina en la última muestra
+  if (havePrev && nowMs - lastNowMs > GPS_MAX_GAP_MS) {
+    if (state != SPR_IDLE) confirmed = close(clockMs);
+    havePrev = false;
+  }
+  lastNowMs = nowMs;
+  if (!havePrev) {
+    vRef = v_kmh;
+    accElapsed = 0;
+    aLead = 0.0f;
+  }
+  clockMs += dtMs;
+
+  // Aceleración por ventanas; aLead se reinicia cuando deja de acelerar
+  accElapsed += dtMs;
+  if (accElapsed >= ACC_WIN_MS) {
+    float a = (v_kmh - vRef) * (1000.0f / 3.6f) / accElapsed;
+    vRef = v_kmh;
+    accElapsed = 0;
+    if (a <= 0.0f) aLead = 0.0f;
+    else if (a > aLead) aLead = a;
+    if (state != SPR_IDLE && a > cur.aPeakMs2) cur.aPeakMs2 = a;
+  }
+
+  if (state == SPR_IDLE) {
+    if (v_kmh >= SPRINT_KMH) {
+      // Cruce interpolado dentro del intervalo
+      uint32_t back = 0;
+      if (havePrev && vPrev < SPRINT_KMH) {
+        back = (uint32_t)(dtMs * (v_kmh - SPRINT_KMH) / (v_kmh - vPrev));
+      }
+      state = SPR_CANDIDATE;
+      startClk = clockMs - back;
+      cur.startMs = nowMs - back;
+      cur.distM = distM(0.5f * (SPRINT_KMH + v_kmh), back);
+      cur.vPeakKmh = v_kmh;
+      cur.aPeakMs2 = aLead;
+      confirmed |= confirm(clockMs);
+    }
+  } else if (v_kmh >= SPRINT_EXIT_KMH) {
+    cur.distM += distM(0.5f * (vPrev + v_kmh), dtMs);
+    if (v_kmh > cur.vPeakKmh) cur.vPeakKmh = v_kmh;
+    confirmed |= confirm(clockMs);
+  } else {
+    // Cruce interpolado de SPRINT_EXIT_KMH
+    uint32_t fwd = (uint32_t)(dtMs * (vPrev - SPRINT_EXIT_KMH) / (vPrev - v_kmh));
+    cur.distM += distM(0.5f * (vPrev + SPRINT_EXIT_KMH), fwd);
+    confirmed |= close(clockMs - dtMs + fwd);
+  }
+
+  vPrev = v_kmh;
+  havePrev = true;
+  return confirmed;
+}
+
+bool sprintTakeEvent(SprintEvent *ev) {
+  if (qCount == 0) return false;
+  *ev = queue[qHead];
+  qHead = (qHead + 1) % SPRINT_QUEUE;
+  qCount--;
+  return true;
+}
+
+uint16_t sprintTakeDropped() {
+  uint16_t n = dropped;
+  dropped = 0;
+  return n;
+}
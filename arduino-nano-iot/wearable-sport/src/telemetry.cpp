@@ -0,0 +1,183 @@
+/**
+ * @file telemetry.cpp
+ * @brief Envío de la telemetría binaria por Serial
+ * @authors Juan Perez, Ana Gomez
+ * @date 2025
+ */
+
+#include <Arduino.h>
+#include <string.h>
+#include "telemetry.h"
+#include "config.h"
+#include "gps_processing.h"
+#include "gps_distance.h"
+#include "gps_uart.h"
+#include "heart_rate.h"
+#include "metrics.h"
+#include "rolling.h"
+#include "scheduler.h"
+#include "sd_logger.h"
+#include "ecg_adc.h"
+#include "ecg_capture.h"
+
+// ==================== FUNCIONES INTERNAS ====================
+
+/** @brief Completa el prefijo de un registro */
+static void prefix(RecordPrefix &p, uint8_t type, size_t len) {
+  p.sync = SESSION_LOG_SYNC;
+  p.type = type;
+  p.len = (uint8_t)len;
+}
+
+/** @brief Completa el CRC (últimos dos bytes) y envía el registro */
+static void seal(void *rec, size_t n) {
+  uint16_t crc = crc16Ccitt(rec, n - 2);
+  memcpy((uint8_t *)rec + n - 2, &crc, 2);
+  telemetrySend(rec, n);
+}
+
+/**
+ * @brief Ventanas deslizantes y picos de 5 min
+ */
+static void sendRolling(uint32_t seq) {
+  RollingRecord r;
+  prefix(r.pre, REC_ROLLING, sizeof(r));
+  r.seq = seq;
+  for (int w = ROLL_1MIN; w < ROLL_WINDOWS; w++) {
+    RollingTotals t = rollingTotals((RollWindow)w);
+    r.distM[w] = truncU16(t.distM);
+    r.hsDistM[w] = truncU16(t.hsDistM);
+    r.trimp[w] = toU16(t.trimp, 100.0f);
+    for (int i = 0; i < 6; i++) r.secHZ[w][i] = t.secInHZ[i];
+    r.seconds[w] = t.seconds;
+  }
+  RollingPeaks p = rollingPeaks();
+  r.peakDist5M = truncU16(p.dist5M);
+  r.peakHsDist5M = truncU16(p.hsDist5M);
+  r.peakTrimp5 = toU16(p.trimp5, 100.0f);
+  r.acuteChronic = toU16(rollingAcuteChronic(), 1000.0f);
+  seal(&r, sizeof(r));
+}
+
+/**
+ * @brief Contadores de distancia, recepción del GPS, SD, ECG y captura
+ */
+static void sendDiag(uint32_t seq, const GpsDistanceStats &ds, uint16_t sprintsLost,
+                     const GpsUartStats &rx, const SdLogStats &sd, const CaptureStats *cap) {
+  DiagRecord d;
+  memset(&d, 0, sizeof(d));
+  prefix(d.pre, REC_DIAG, sizeof(d));
+  d.seq = seq;
+  d.dopplerDm = toU16(ds.dopplerM, 10.0f);
+  d.positionDm = toU16(ds.positionM, 10.0f);
+  d.correctionDm = toI16(ds.correctionM, 10.0f);
+  d.segments = ds.segments;
+  d.rejected = ds.rejected;
+  d.sprintsDropped = sprintsLost;
+  d.gpsRxBytes = rx.bytes;
+  d.gpsRxOverruns = rx.overruns;
+  d.gpsRxMaxFill = truncU16(rx.maxFill);
+  d.sdBytes = sd.bytes;
+  d.sdSectors = sd.sectors;
+  d.sdPending = sdLog.pending();
+  d.sdDropped = sd.dropped;
+  d.sdWriteMaxUs = sd.writeMaxUs;
+  d.sdFlushMaxUs = sd.flushMaxUs;
+#if ECG_ACQ_MODE == ECG_ACQ_DMA
+  d.flags |= DIAG_ECG_DMA;
+  d.ecgBlocks = ecgAdcStats.blocks;
+  d.ecgOverruns = ecgAdcStats.overruns;
+#endif
+  if (cap) {
+    d.flags |= DIAG_CAPTURE;
+#if ECG_CAPTURE
+    if (captureActive()) d.flags |= DIAG_CAPTURE_ON;
+#endif
+    d.capSectors = cap->sectors;
+    d.capDropped = cap->dropped;
+    d.capErrors = cap->errors;
+    d.capWriteMaxUs = cap->writeMaxUs;
+  }
+  seal(&d, sizeof(d));
+}
+
+/**
+ * @brief Estadísticas del planificador: las reinicia y, con TELEM_LEVEL >= 2, las envía
+ */
+static void sendTasks(uint32_t seq) {
+  TaskRecord t;
+  const char *name;
+  TaskStats s;
+  for (int k = 0; schedTakeStats(k, &name, &s); k++) {
+    if (TELEM_LEVEL < 2) continue;
+    prefix(t.pre, REC_TASK, sizeof(t));
+    t.seq = seq;
+    size_t len = strlen(name);
+    memset(t.name, 0, sizeof(t.name));
+    memcpy(t.name, name, len < sizeof(t.name) ? len : sizeof(t.name));
+    t.runs = s.runs;
+    t.missed = s.missed;
+    t.jitterAvgUs = s.runs ? s.jitterSumUs / s.runs : 0;
+    t.jitterMaxUs = s.jitterMaxUs;
+    t.execAvgUs = s.runs ? s.execSumUs / s.runs : 0;
+    t.execMaxUs = s.execMaxUs;
+    seal(&t, sizeof(t));
+  }
+}
+
+// ==================== INTERFAZ ====================
+
+/**
+ * @brief Envía un registro como trama COBS por Serial
+ *
+ * @param rec Registro completo
+ * @param n Bytes del registro
+ */
+void telemetrySend(const void *rec, size_t n) {
+  static uint8_t frame[TELEM_MAX_RECORD + 3];
+  if (n > TELEM_MAX_RECORD) return;
+  frame[0] = 0;
+  size_t len = cobsEncode((const uint8_t *)rec, n, frame + 1);
+  frame[len + 1] = 0;
+  Serial.write(frame, len + 2);
+}
+
+/**
+ * @brief Envía el StateRecord con la última época GPS y el BPM actual
+ */
+void telemetryState() {
+  StateRecord r;
+  prefix(r.pre, REC_STATE, sizeof(r));
+  r.millisMs = millis();
+
+  const GpsFix &fix = gps.fix();
+  if (fix.has(GPS_DATE | GPS_TIME)) {
+    r.utcDate = fix.utcDate();
+    r.utcTimeMs = fix.utcMs();
+  } else {
+    r.utcDate = 0;
+    r.utcTimeMs = 0;
+  }
+  r.latE7 = fix.latE7;
+  r.lonE7 = fix.lonE7;
+  r.altCm = fix.altCm;
+  r.speed = toU16(v_kmh_last, 100.0f);
+  r.hdop = fix.hdop;
+  r.bpm = toU16(bpmAvg, 10.0f);
+  r.sats = fix.sats;
+  r.valid = (uint8_t)fix.valid;
+  seal(&r, sizeof(r));
+}
+
+/**
+ * @brief Envía el resumen del minuto según TELEM_LEVEL
+ */
+void telemetryMinute(const MinuteRecord &r, const MotionRecord *m,
+                     const GpsDistanceStats &ds, uint16_t sprintsLost,
+                     const GpsUartStats &rx, const SdLogStats &sd, const CaptureStats *cap) {
+  telemetrySend(&r, sizeof(r));
+  if (m) telemetrySend(m, sizeof(*m));
+  if (TELEM_LEVEL >= 1) sendRolling(r.seq);
+  if (TELEM_LEVEL >= 2) sendDiag(r.seq, ds, sprintsLost, rx, sd, cap);
+  sendTasks(r.seq);
+}
@@ -0,0 +1,253 @@
+/**
+ * @file ubx.cpp
+ * @brief Parser UBX (NAV-PVT, ACK) y configuración del receptor u-blox
+ * @authors Juan Perez, Ana Gomez
+ * @date 2025
+ */
+
+#include <Arduino.h>
+#include <string.h>
+#include "ubx.h"
+#include "config.h"
+
+/** @brief Tramas más largas se consideran basura (NAV-PVT ocupa 92 B) */
+static const uint16_t UBX_MAX_LEN = 1024;
+
+UbxParser::UbxParser()
+    : state_(SYNC1), cls_(0), id_(0), len_(0), pos_(0), ckA_(0), ckB_(0),
+      ack_(-1), dbd_(false), ackCls_(0), ackId_(0), passed_(0), failed_(0) {
+  memset(buf_, 0, sizeof(buf_));
+  memset(&fix_, 0, sizeof(fix_));
+}
+
+// ==================== PARSER ====================
+
+/** @brief Checksum Fletcher-8 sobre clase, id, longitud y carga útil */
+void UbxParser::checksum(uint8_t b) {
+  ckA_ += b;
+  ckB_ += ckA_;
+}
+
+/**
+ * @brief Procesa un byte del receptor
+ *
+ * @param c Byte recibido
+ * @return true Si completó un NAV-PVT con checksum válido
+ */
+bool UbxParser::encode(char c) {
+  uint8_t b = (uint8_t)c;
+  switch (state_) {
+    case SYNC1:
+      if (b == UBX_SYNC1) state_ = SYNC2;
+      return false;
+    case SYNC2:
+      state_ = b == UBX_SYNC2 ? CLASS : (b == UBX_SYNC1 ? SYNC2 : SYNC1);
+      return false;
+    case CLASS:
+      ckA_ = ckB_ = 0;
+      checksum(b);
+      cls_ = b;
+      state_ = ID;
+      return false;
+    case ID:
+      checksum(b);
+      id_ = b;
+      state_ = LEN1;
+      return false;
+    case LEN1:
+      checksum(b);
+      len_ = b;
+      state_ = LEN2;
+      return false;
+    case LEN2:
+      checksum(b);
+      len_ |= (uint16_t)b << 8;
+      pos_ = 0;
+      dbd_ = false;                      // buf_ se reutiliza con esta trama
+      state_ = len_ > UBX_MAX_LEN ? SYNC1 : (len_ ? PAYLOAD : CK_A);
+      return false;
+    case PAYLOAD:
+      checksum(b);
+      if (pos_ < sizeof(buf_)) buf_[pos_] = b;
+      if (++pos_ == len_) state_ = CK_A;
+      return false;
+    case CK_A:
+      if (b != ckA_) {
+        failed_++;
+        state_ = SYNC1;
+      } else {
+        state_ = CK_B;
+      }
+      return false;
+    case CK_B:
+      state_ = SYNC1;
+      if (b != ckB_) {
+        failed_++;
+        return false;
+      }
+      passed_++;
+      handle();
+      return cls_ == UBX_CLASS_NAV && id_ == UBX_NAV_PVT && len_ == sizeof(UbxNavPvt);
+  }
+  return false;
+}
+
+/**
+ * @brief Interpreta una trama con checksum válido
+ *
+ * Posición, velocidad, rumbo y altitud solo se aceptan con gnssFixOK y fix
+ * 2D/3D (o con navegación por estima); fecha y hora según sus bits de
+ * validez; satélites y PDOP siempre.
+ */
+void UbxParser::handle() {
+  if (cls_ == UBX_CLASS_ACK && len_ == 2) {
+    ack_ = id_ == UBX_ACK_ACK ? 1 : 0;
+    ackCls_ = buf_[0];
+    ackId_ = buf_[1];
+    return;
+  }
+  if (cls_ == UBX_CLASS_MGA && id_ == UBX_MGA_DBD && len_ <= sizeof(buf_)) {
+    dbd_ = true;
+    return;
+  }
+  if (cls_ != UBX_CLASS_NAV || id_ != UBX_NAV_PVT || len_ != sizeof(UbxNavPvt)) return;
+
+  const UbxNavPvt &p = pvt_;
+  bool fixOk = (p.flags & 0x01) && p.fixType >= 2 && p.fixType <= 4;
+  uint16_t set = GPS_SATS | GPS_HDOP;
+
+  fix_.towMs = p.iTOW;
+  fix_.sats = p.numSV;
+  fix_.hdop = p.pDOP;
+  fix_.quality = fixOk ? 1 : 0;
+  if (p.valid & 0x01) {
+    fix_.year = p.year;
+    fix_.month = p.month;
+    fix_.day = p.day;
+    set |= GPS_DATE;
+  }
+  if (p.valid & 0x02) {
+    fix_.hour = p.hour;
+    fix_.minute = p.min;
+    fix_.second = p.sec;
+    fix_.centis = p.nano > 0 ? (uint8_t)(p.nano / 10000000L) : 0;
+    set |= GPS_TIME;
+  }
+  if (fixOk) {
+    fix_.latE7 = p.lat;
+    fix_.lonE7 = p.lon;
+    fix_.altCm = p.hMSL / 10;
+    fix_.hAccMm = p.hAcc;
+    // mm/s a 0.01 km/h: × 0.36 = × 9 / 25
+    fix_.speed = p.gSpeed > 0 ? ((uint32_t)p.gSpeed * 9 + 12) / 25 : 0;
+    int32_t course = p.headMot / 1000;   // 1e-5 a 0.01 grados
+    if (course < 0) course += 36000;
+    fix_.course = (uint16_t)(course % 36000);
+    set |= GPS_LOCATION | GPS_SPEED | GPS_COURSE | GPS_ALTITUDE;
+  }
+  fix_.valid |= set;
+  fix_.updated = set;
+}
+
+int UbxParser::takeAck(uint8_t *cls, uint8_t *id) {
+  int a = ack_;
+  *cls = ackCls_;
+  *id = ackId_;
+  ack_ = -1;
+  return a;
+}
+
+bool UbxParser::takeDbd(const uint8_t **payload, uint16_t *len) {
+  if (!dbd_) return false;
+  dbd_ = false;
+  *payload = buf_;
+  *len = len_;
+  return true;
+}
+
+// ==================== CONFIGURACIÓN ====================
+
+static void put16(uint8_t *p, uint16_t v) {
+  p[0] = (uint8_t)v;
+  p[1] = (uint8_t)(v >> 8);
+}
+
+static void put32(uint8_t *p, uint32_t v) {
+  put16(p, (uint16_t)v);
+  put16(p + 2, (uint16_t)(v >> 16));
+}
+
+/**
+ * @brief Envía una trama UBX con su checksum
+ */
+void ubxSend(HardwareSerial &port, uint8_t cls, uint8_t id, const uint8_t *payload, uint16_t len) {
+  uint8_t hdr[6] = {UBX_SYNC1, UBX_SYNC2, cls, id, (uint8_t)len, (uint8_t)(len >> 8)};
+  uint8_t ck[2] = {0, 0};
+  for (int i = 2; i < 6; i++) {
+    ck[0] += hdr[i];
+    ck[1] += ck[0];
+  }
+  for (uint16_t i = 0; i < len; i++) {
+    ck[0] += payload[i];
+    ck[1] += ck[0];
+  }
+  port.write(hdr, sizeof(hdr));
+  port.write(payload, len);
+  port.write(ck, sizeof(ck));
+}
+
+/**
+ * @brief Espera el ACK (o NAK) de un mensaje de configuración
+ */
+static bool ubxWaitAck(HardwareSerial &port, uint8_t cls, uint8_t id, uint32_t timeoutMs) {
+  UbxParser p;
+  uint32_t t0 = millis();
+  while (millis() - t0 < timeoutMs) {
+    while (port.available()) p.encode((char)port.read());
+    uint8_t ackCls, ackId;
+    int a = p.takeAck(&ackCls, &ackId);
+    if (a >= 0 && ackCls == cls && ackId == id) return a == 1;
+    delay(1);
+  }
+  return false;
+}
+
+/**
+ * @brief Configura el receptor: baudios, tasa de navegación y salida NAV-PVT
+ *
+ * @param port Puerto serie del GPS (Serial1)
+ * @return true Si el receptor confirmó la tasa y el mensaje
+ */
+bool ubxConfigure(HardwareSerial &port) {
+  // UART1: 8N1 a GPS_UBX_BAUD, entrada UBX+NMEA, salida solo UBX
+  uint8_t prt[20];
+  memset(prt, 0, sizeof(prt));
+  prt[0] = 1;
+  put32(prt + 4, 0x000008D0UL);
+  put32(prt + 8, GPS_UBX_BAUD);
+  put16(prt + 12, 0x0003);
+  put16(prt + 14, 0x0001);
+
+  const uint32_t bauds[2] = {BAUD_GPS, GPS_UBX_BAUD};
+  for (int i = 0; i < 2; i++) {
+    port.begin(bauds[i]);
+    ubxSend(port, UBX_CLASS_CFG, UBX_CFG_PRT, prt, sizeof(prt));
+    port.flush();
+    delay(50);                           // El receptor cambia de velocidad tras responder
+  }
+  port.begin(GPS_UBX_BAUD);
+
+  // Periodo de medición y una solución por medición, referida a tiempo GPS
+  uint8_t rate[6];
+  put16(rate, (uint16_t)(1000 / GPS_RATE_HZ));
+  put16(rate + 2, 1);
+  put16(rate + 4, 1);
+  ubxSend(port, UBX_CLASS_CFG, UBX_CFG_RATE, rate, sizeof(rate));
+  bool ok = ubxWaitAck(port, UBX_CLASS_CFG, UBX_CFG_RATE, 500);
+
+  // NAV-PVT en cada solución por el puerto actual
+  const uint8_t msg[3] = {UBX_CLASS_NAV, UBX_NAV_PVT, 1};
+  ubxSend(port, UBX_CLASS_CFG, UBX_CFG_MSG, msg, sizeof(msg));
+  ok = ubxWaitAck(port, UBX_CLASS_CFG, UBX_CFG_MSG, 500) && ok;
+  return ok;
+}
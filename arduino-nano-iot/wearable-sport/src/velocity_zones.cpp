@@ -6,6 +6,7 @@
  */
 
 #include "velocity_zones.h"
+#include "zone_table.h"
 
 // ==================== CONSTANTES ====================
 
@@ -13,8 +14,16 @@ const float V_BINS[] = {7.0, 15.0, 20.0};
 
 // ==================== VARIABLES ====================
 
-float secInVZ[4] = {0};
-float distInVZ[4] = {0};
+static ZoneTable<3> vzTable;             ///< Bordes en 0.01 km/h
+
+/**
+ * @brief Fija los bordes de las zonas
+ * 
+ * @param bins Bordes ascendentes en km/h
+ */
+void velZonesConfigure(const float bins[3]) {
+  vzTable.set(bins, 100.0f);
+}
 
 /**
  * @brief Determina la zona de velocidad según la velocidad actual
@@ -23,8 +32,5 @@ float distInVZ[4] = {0};
  * @return int Índice de zona (0-3)
  */
 int velZoneIndex(float v) {
-  if (v < V_BINS[0]) return VZ_CAM;
-  if (v < V_BINS[1]) return VZ_TRO;
-  if (v < V_BINS[2]) return VZ_CAR;
-  return VZ_SPR;
+  return vzTable.index((int32_t)(v * 100.0f));
 }
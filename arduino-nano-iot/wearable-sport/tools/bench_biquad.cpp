@@ -0,0 +1,170 @@
+/**
+ * @file bench_biquad.cpp
+ * @brief Benchmark en PC de la cascada ECG: float vs Q15 vs Q31
+ * @authors Juan Perez, Ana Gomez
+ * @date 2025
+ *
+ * @details Compara la cascada float de referencia (filterSampleFloat) con el
+ * motor BiquadCascade en Q15 y Q31: error máximo y RMS respecto a float
+ * (en cuentas del ADC, tras el transitorio inicial), ciclos y muestras por
+ * segundo. También compara NCH canales filtrados con cascadas separadas
+ * contra un solo BiquadBank (estructura de arreglos). Los ciclos medidos son del procesador del PC (con FPU); sirven
+ * para comparar implementaciones, no como estimación directa del M0+.
+ *
+ * Compilación (desde la carpeta del proyecto):
+ *   g++ -O2 -std=gnu++11 -Iinclude -Itools tools/bench_biquad.cpp src/filter.cpp -o bench_biquad
+ *
+ * Uso:
+ *   ./bench_biquad [archivo_adc.txt]
+ * El archivo opcional contiene una lectura del ADC por línea a SAMPLE_RATE;
+ * sin archivo se genera una señal ECG sintética de 10 minutos.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <chrono>
+#include <vector>
+#include "config.h"
+#include "filter.h"
+#include "biquad_fixed.h"
+#include "ecg_synth.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+static inline unsigned long long cycles() { return __rdtsc(); }
+#else
+static inline unsigned long long cycles() { return 0; }
+#endif
+
+static const int N_STAGES = SOS_STAGES;
+static const int ADC_MID = 1 << (ADC_RESOLUTION - 1);
+
+static std::vector<int> loadAdc(const char *path) {
+  std::vector<int> v;
+  FILE *f = fopen(path, "r");
+  if (!f) {
+    perror(path);
+    exit(1);
+  }
+  int a;
+  while (fscanf(f, "%d", &a) == 1) v.push_back(a);
+  fclose(f);
+  return v;
+}
+
+struct Result {
+  double ns, cyc, maxErr, rmsErr;
+};
+
+template <class Q>
+static Result runFixed(const std::vector<int> &in, const std::vector<float> &ref, int shift) {
+  BiquadCascade<Q, N_STAGES> c(sos);
+  std::vector<float> out(in.size());
+  const float k = 1.0f / (float)(1LL << shift);
+  const long long scale = 1LL << shift;
+  auto t0 = std::chrono::steady_clock::now();
+  unsigned long long c0 = cycles();
+  for (size_t i = 0; i < in.size(); ++i) {
+    typename Q::sample_t x = (typename Q::sample_t)((in[i] - ADC_MID) * scale);
+    out[i] = (float)c.process(x) * k;
+  }
+  unsigned long long c1 = cycles();
+  auto t1 = std::chrono::steady_clock::now();
+  Result r;
+  r.ns = std::chrono::duration<double, std::nano>(t1 - t0).count() / in.size();
+  r.cyc = (double)(c1 - c0) / in.size();
+  size_t settle = (size_t)(20 * SAMPLE_RATE);
+  double m = 0, s = 0;
+  size_t cnt = 0;
+  for (size_t i = settle; i < in.size(); ++i) {
+    double e = fabs((double)out[i] - ref[i]);
+    if (e > m) m = e;
+    s += e * e;
+    cnt++;
+  }
+  r.maxErr = m;
+  r.rmsErr = cnt ? sqrt(s / cnt) : 0;
+  return r;
+}
+
+/** @brief Pasadas de cada versión en la comparación del banco */
+static const int BANK_RUNS = 5;
+
+/**
+ * @brief NCH canales en Q31: NCH cascadas independientes vs un BiquadBank
+ *
+ * Cada canal recibe la señal desplazada en el tiempo; se verifica que ambas
+ * versiones den exactamente las mismas salidas.
+ */
+template <int NCH>
+static void runBank(const std::vector<int> &in) {
+  typedef Q31::sample_t sample_t;
+  const long long scale = 1LL << (28 - ADC_RESOLUTION);
+  const size_t len = in.size() - NCH;
+
+  BiquadCascade<Q31, N_STAGES> cas[NCH];
+  for (int c = 0; c < NCH; ++c) cas[c].setCoeffs(sos);
+  BiquadBank<Q31, N_STAGES, NCH> bank(sos);
+  std::vector<sample_t> outC(len * NCH), outB(len * NCH);
+
+  // Mejor de BANK_RUNS pasadas de cada versión (el mismo filtro continúa entre pasadas)
+  unsigned long long bestC = ~0ULL, bestB = ~0ULL;
+  for (int run = 0; run < BANK_RUNS; ++run) {
+    unsigned long long c0 = cycles();
+    for (size_t i = 0; i < len; ++i) {
+      for (int c = 0; c < NCH; ++c) {
+        outC[i * NCH + c] = cas[c].process((sample_t)((in[i + c] - ADC_MID) * scale));
+      }
+    }
+    unsigned long long c1 = cycles();
+    for (size_t i = 0; i < len; ++i) {
+      sample_t x[NCH];
+      for (int c = 0; c < NCH; ++c) x[c] = (sample_t)((in[i + c] - ADC_MID) * scale);
+      bank.process(x);
+      for (int c = 0; c < NCH; ++c) outB[i * NCH + c] = x[c];
+    }
+    unsigned long long c2 = cycles();
+    if (c1 - c0 < bestC) bestC = c1 - c0;
+    if (c2 - c1 < bestB) bestB = c2 - c1;
+  }
+
+  printf("Q31 x%d  cascadas %7.1f ciclos/tick  banco %7.1f ciclos/tick  salidas %s\n",
+         NCH, (double)bestC / len, (double)bestB / len,
+         outC == outB ? "idénticas" : "DIFERENTES");
+}
+
+static void report(const char *name, const Result &r) {
+  printf("%-6s %9.2f ns/muestra %9.1f ciclos %10.2f Mmuestras/s  err max %.5f  rms %.5f (cuentas ADC)\n",
+         name, r.ns, r.cyc, 1e3 / r.ns, r.maxErr, r.rmsErr);
+}
+
+int main(int argc, char **argv) {
+  std::vector<int> in = (argc > 1) ? loadAdc(argv[1]) : ecgSynth(600, 0.8, 0.8, 20, nullptr);
+  if (in.size() < (size_t)(40 * SAMPLE_RATE)) {
+    fprintf(stderr, "Se requieren al menos 40 s de señal\n");
+    return 1;
+  }
+
+  // Referencia float (misma cascada DF2T que el firmware); la entrada se
+  // centra igual que en los motores de punto fijo para comparar sin transitorio de DC
+  std::vector<float> ref(in.size());
+  auto t0 = std::chrono::steady_clock::now();
+  unsigned long long c0 = cycles();
+  for (size_t i = 0; i < in.size(); ++i) {
+    ref[i] = filterSampleFloat((float)(in[i] - ADC_MID));
+  }
+  unsigned long long c1 = cycles();
+  auto t1 = std::chrono::steady_clock::now();
+  Result rf;
+  rf.ns = std::chrono::duration<double, std::nano>(t1 - t0).count() / in.size();
+  rf.cyc = (double)(c1 - c0) / in.size();
+  rf.maxErr = rf.rmsErr = 0;
+
+  printf("Muestras: %u a %d Hz, %d etapas\n", (unsigned)in.size(), SAMPLE_RATE, N_STAGES);
+  report("float", rf);
+  report("Q15", runFixed<Q15>(in, ref, 14 - ADC_RESOLUTION));
+  report("Q31", runFixed<Q31>(in, ref, 28 - ADC_RESOLUTION));
+  runBank<4>(in);
+  return 0;
+}
@@ -0,0 +1,222 @@
+/**
+ * @file bench_decim.cpp
+ * @brief Benchmark en PC de la adquisición sobremuestreada: diezmado vs notch
+ * @authors Juan Perez, Ana Gomez
+ * @date 2025
+ *
+ * @details Compara las dos cadenas de adquisición del ECG con la misma
+ * entrada simulada a ECG_OVS_RATE: red en ECG_NOTCH_HZ con su tercer
+ * armónico, ruido blanco gaussiano por conversión y cuantización a 12 bits.
+ *
+ * - Directo: una conversión por muestra a SAMPLE_RATE y cascada Q31 de 5
+ *   etapas (pasa-banda + notch), como con ECG_OVERSAMPLE = 0.
+ * - Diezmado: ECG_ADC_AVG conversiones acumuladas por disparo, EcgDecimator
+ *   y cascada Q31 de 4 etapas (sin notch), como con ECG_OVERSAMPLE = 1.
+ *
+ * Para cada una informa tiempo y ciclos por muestra de salida y el residuo
+ * (RMS en cuentas del ADC, tras el transitorio) de la red sola y del ruido
+ * solo; la razón de ruidos da los bits efectivos ganados. Los ciclos son del
+ * procesador del PC; sirven para comparar las cadenas, no como estimación
+ * directa del M0+.
+ *
+ * Compilación (desde la carpeta del proyecto):
+ *   g++ -O2 -std=gnu++11 -Iinclude tools/bench_decim.cpp -o bench_decim
+ *
+ * Uso:
+ *   ./bench_decim [segundos]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <chrono>
+#include <vector>
+#include "config.h"
+#include "filter.h"
+#include "filter_design.h"
+#include "biquad_fixed.h"
+#include "ecg_decim.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+static inline unsigned long long cycles() { return __rdtsc(); }
+#else
+static inline unsigned long long cycles() { return 0; }
+#endif
+
+static_assert(ECG_NOTCH_HZ > 0, "El benchmark compara contra el notch: ECG_NOTCH_HZ debe ser > 0");
+
+/** @brief Bits de la entrada en Q31 (los mismos 3 bits de margen que filter.cpp) */
+static const int Q_BITS = 28;
+static const int ADC_BITS = ECG_OVS_ADC_BITS;
+static const int ADC_MAX = (1 << ADC_BITS) - 1;
+
+struct Result {
+  double ns, cyc, rms;
+};
+
+/** @brief Generador reproducible de ruido gaussiano (LCG + Box-Muller) */
+struct Noise {
+  uint64_t s;
+  double uniform() {
+    s = s * 6364136223846793005ULL + 1442695040888963407ULL;
+    return ((s >> 11) + 0.5) / 9007199254740992.0;
+  }
+  double gauss() {
+    return sqrt(-2 * log(uniform())) * cos(2 * M_PI * uniform());
+  }
+};
+
+/**
+ * @brief Conversiones del ADC a ECG_OVS_RATE * ECG_ADC_AVG por segundo
+ *
+ * @param seconds Duración
+ * @param mains Amplitud de la red (cuentas); el tercer armónico lleva un tercio
+ * @param sigma Ruido por conversión (cuentas RMS)
+ */
+static std::vector<uint16_t> convert(int seconds, double mains, double sigma) {
+  const double rate = (double)ECG_OVS_RATE * ECG_ADC_AVG;
+  const long n = (long)(seconds * rate);
+  std::vector<uint16_t> v((size_t)n);
+  Noise g = {42};
+  for (long i = 0; i < n; ++i) {
+    double t = i / rate;
+    double x = (1 << (ADC_BITS - 1)) + 0.3 +
+               mains * sin(2 * M_PI * ECG_NOTCH_HZ * t) +
+               mains / 3 * sin(2 * M_PI * 3 * ECG_NOTCH_HZ * t + 0.7) +
+               sigma * g.gauss();
+    long a = lround(x);
+    v[(size_t)i] = (uint16_t)(a < 0 ? 0 : a > ADC_MAX ? ADC_MAX : a);
+  }
+  return v;
+}
+
+/** @brief RMS de la salida tras el transitorio del pasa-altas */
+static double rmsAfterSettle(const std::vector<float> &y) {
+  size_t settle = (size_t)(20 * SAMPLE_RATE);
+  double s = 0;
+  size_t cnt = 0;
+  for (size_t i = settle; i < y.size(); ++i, ++cnt) s += (double)y[i] * y[i];
+  return cnt ? sqrt(s / cnt) : 0;
+}
+
+/**
+ * @brief Una conversión por muestra y cascada con notch
+ */
+static Result runDirect(const std::vector<uint16_t> &conv) {
+  Biquad sos5[5];
+  for (int k = 0; k < 4; ++k) sos5[k] = fdesign::butterBandpass(ECG_HP_HZ, ECG_LP_HZ, SAMPLE_RATE, 4, k);
+  sos5[4] = fdesign::notch(ECG_NOTCH_HZ, SAMPLE_RATE, ECG_NOTCH_Q);
+  BiquadCascade<Q31, 5> c(sos5);
+
+  // El ADC a SAMPLE_RATE toma una de cada ECG_DECIM * ECG_ADC_AVG conversiones
+  const size_t step = (size_t)ECG_DECIM * ECG_ADC_AVG;
+  const size_t n = conv.size() / step;
+  std::vector<uint16_t> in(n);
+  for (size_t i = 0; i < n; ++i) in[i] = conv[i * step];
+
+  std::vector<float> out(n);
+  const int mid = 1 << (ADC_BITS - 1);
+  const float k = 1.0f / (float)(1L << (Q_BITS - ADC_BITS));
+  auto t0 = std::chrono::steady_clock::now();
+  unsigned long long c0 = cycles();
+  for (size_t i = 0; i < n; ++i) {
+    out[i] = (float)c.process((Q31::sample_t)((in[i] - mid) * (1L << (Q_BITS - ADC_BITS)))) * k;
+  }
+  unsigned long long c1 = cycles();
+  auto t1 = std::chrono::steady_clock::now();
+
+  Result r;
+  r.ns = std::chrono::duration<double, std::nano>(t1 - t0).count() / n;
+  r.cyc = (double)(c1 - c0) / n;
+  r.rms = rmsAfterSettle(out);
+  return r;
+}
+
+/**
+ * @brief Acumulación del ADC, diezmado y cascada sin notch
+ *
+ * @param decimOnly Tiempo del diezmado solo (salida)
+ */
+static Result runDecim(const std::vector<uint16_t> &conv, Result *decimOnly) {
+  Biquad sos4[4];
+  for (int k = 0; k < 4; ++k) sos4[k] = fdesign::butterBandpass(ECG_HP_HZ, ECG_LP_HZ, SAMPLE_RATE, 4, k);
+  BiquadCascade<Q31, 4> c(sos4);
+  EcgDecimator d = {};
+
+  // Lo que el DMA deja en el buffer: una suma de ECG_ADC_AVG conversiones por disparo
+  const size_t nTrig = conv.size() / ECG_ADC_AVG;
+  const size_t nBlocks = nTrig / (ECG_BLOCK_LEN * ECG_DECIM);
+  // Cada bloque lleva ECG_DECIM_TAPS posiciones libres antes, como ecgBuf
+  const size_t rawLen = ECG_BLOCK_LEN * ECG_DECIM, stride = ECG_DECIM_TAPS + rawLen;
+  std::vector<uint16_t> raw(nBlocks * stride);
+  for (size_t i = 0; i < nBlocks * rawLen; ++i) {
+    uint16_t s = 0;
+    for (int j = 0; j < ECG_ADC_AVG; ++j) s += conv[i * ECG_ADC_AVG + j];
+    raw[i / rawLen * stride + ECG_DECIM_TAPS + i % rawLen] = s;
+  }
+
+  const size_t n = nBlocks * ECG_BLOCK_LEN;
+  std::vector<uint16_t> dec(n);
+  std::vector<float> out(n);
+  const int mid = 1 << 15;
+  const float k = 1.0f / (float)(1L << (Q_BITS - ADC_RESOLUTION));
+  auto t0 = std::chrono::steady_clock::now();
+  unsigned long long c0 = cycles();
+  for (size_t b = 0; b < nBlocks; ++b) {
+    d.process(&raw[b * stride + ECG_DECIM_TAPS], &dec[b * ECG_BLOCK_LEN], ECG_BLOCK_LEN);
+  }
+  unsigned long long c1 = cycles();
+  auto t1 = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < n; ++i) {
+    out[i] = (float)c.process((Q31::sample_t)((dec[i] - mid) * (1L << (Q_BITS - 16)))) * k;
+  }
+  unsigned long long c2 = cycles();
+  auto t2 = std::chrono::steady_clock::now();
+
+  decimOnly->ns = std::chrono::duration<double, std::nano>(t1 - t0).count() / n;
+  decimOnly->cyc = (double)(c1 - c0) / n;
+  decimOnly->rms = 0;
+  Result r;
+  r.ns = std::chrono::duration<double, std::nano>(t2 - t0).count() / n;
+  r.cyc = (double)(c2 - c0) / n;
+  r.rms = rmsAfterSettle(out);
+  return r;
+}
+
+/** @brief Ganancia de la suma móvil a la frecuencia f (núcleo de Dirichlet) */
+static double decimGain(double f) {
+  double x = M_PI * f / ECG_OVS_RATE;
+  return fabs(sin(ECG_DECIM_TAPS * x) / (ECG_DECIM_TAPS * sin(x)));
+}
+
+int main(int argc, char **argv) {
+  int seconds = argc > 1 ? atoi(argv[1]) : 120;
+  if (seconds < 40) {
+    fprintf(stderr, "Se requieren al menos 40 s de señal\n");
+    return 1;
+  }
+
+  printf("Red %d Hz, %lu disparos/s x %d conversiones, ventana %lu, %d Hz de salida, %d s\n",
+         ECG_NOTCH_HZ, (unsigned long)ECG_OVS_RATE, ECG_ADC_AVG, (unsigned long)ECG_DECIM_TAPS,
+         SAMPLE_RATE, seconds);
+
+  // Red sola (100 cuentas + armónico) y ruido solo (4 cuentas RMS por conversión)
+  std::vector<uint16_t> mains = convert(seconds, 100, 0);
+  std::vector<uint16_t> noise = convert(seconds, 0, 4);
+  // La primera pasada de cada cadena solo calienta caché y predictor
+  Result decOnly;
+  Result am = runDirect(mains), dm = runDecim(mains, &decOnly);
+  Result an = runDirect(noise), dn = runDecim(noise, &decOnly);
+  an = runDirect(noise);
+  dn = runDecim(noise, &decOnly);
+
+  printf("%-20s %10s %9s %14s %12s\n", "", "ns/muestra", "ciclos", "red rms", "ruido rms");
+  printf("%-20s %10.2f %9.1f %14.4f %12.4f\n", "directo + notch", an.ns, an.cyc, am.rms, an.rms);
+  printf("%-20s %10.2f %9.1f %14.4f %12.4f\n", "diezmado + cascada", dn.ns, dn.cyc, dm.rms, dn.rms);
+  printf("%-20s %10.2f %9.1f\n", "  solo diezmado", decOnly.ns, decOnly.cyc);
+  printf("Bits efectivos ganados: %.2f\n", log2(an.rms / dn.rms));
+  printf("Ganancia del diezmado: 5 Hz %.3f  10 Hz %.3f  20 Hz %.3f  %d Hz %.3f\n",
+         decimGain(5), decimGain(10), decimGain(20), (int)ECG_LP_HZ, decimGain(ECG_LP_HZ));
+  return 0;
+}
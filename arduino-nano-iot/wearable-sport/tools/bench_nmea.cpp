@@ -0,0 +1,188 @@
+/**
+ * @file bench_nmea.cpp
+ * @brief Benchmark en PC del parser NMEA propio contra TinyGPSPlus
+ * @authors Juan Perez, Ana Gomez
+ * @date 2025
+ *
+ * @details Pasa el mismo flujo NMEA por NmeaParser y por TinyGPSPlus y
+ * reporta bytes/s y ciclos por oración de cada uno, más la diferencia
+ * máxima entre ambos en posición, velocidad, altitud y HDOP tras cada
+ * oración aceptada. Los ciclos son del procesador del PC; sirven para
+ * comparar implementaciones, no como estimación directa del M0+.
+ *
+ * Sin archivo se genera una hora de recorrido a 1 Hz con RMC, GGA, VTG y
+ * GSV (esta última la descartan ambos parsers, pero cuesta recorrerla).
+ *
+ * TinyGPSPlus se compila contra los sustitutos de lib/host_shim; su ruta es
+ * la de la biblioteca descargada (p. ej. .pio/libdeps/.../TinyGPSPlus/src
+ * de otro proyecto o un clon de github.com/mikalhart/TinyGPSPlus).
+ *
+ * Compilación (desde la carpeta del proyecto):
+ *   g++ -O2 -std=gnu++11 -Iinclude -Ilib/host_shim -I$TGP tools/bench_nmea.cpp \
+ *       src/nmea_parser.cpp $TGP/TinyGPS++.cpp -o bench_nmea
+ *
+ * Uso:
+ *   ./bench_nmea [registro.nmea]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <chrono>
+#include <string>
+#include <TinyGPSPlus.h>
+#include "nmea_parser.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+static inline unsigned long long cycles() { return __rdtsc(); }
+#else
+static inline unsigned long long cycles() { return 0; }
+#endif
+
+/** @brief Reloj para TinyGPSPlus (edad de los campos); no se usa en la medición */
+unsigned long millis() {
+  return 0;
+}
+
+// ==================== FLUJO SINTÉTICO ====================
+
+static void appendSentence(std::string &out, const char *body) {
+  uint8_t cs = 0;
+  for (const char *p = body; *p; p++) cs ^= (uint8_t)*p;
+  char tail[8];
+  snprintf(tail, sizeof(tail), "*%02X\r\n", cs);
+  out += '$';
+  out += body;
+  out += tail;
+}
+
+/** @brief Coordenada NMEA (d)ddmm.mmmmm */
+static void nmeaCoord(char *b, size_t n, double deg, int degDigits) {
+  double a = fabs(deg);
+  int d = (int)a;
+  double m = (a - d) * 60.0;
+  snprintf(b, n, "%0*d%08.5f", degDigits, d, m);
+}
+
+static std::string synthStream(int seconds) {
+  std::string s;
+  double lat = 19.3, lon = -99.1166667;
+  double course = 0;
+  char b[160], la[24], lo[24];
+  for (int t = 0; t < seconds; t++) {
+    double kmh = 6.0 + 18.0 * (0.5 + 0.5 * sin(t * 0.05)) * (t % 97 < 8 ? 1.6 : 1.0);
+    course = fmod(course + 3.0 + 2.0 * sin(t * 0.013), 360.0);
+    double d = kmh / 3.6;
+    lat += d * cos(course * M_PI / 180) / 111320.0;
+    lon += d * sin(course * M_PI / 180) / (111320.0 * cos(lat * M_PI / 180));
+    int hh = 12 + t / 3600, mm = t / 60 % 60, ss = t % 60;
+    nmeaCoord(la, sizeof(la), lat, 2);
+    nmeaCoord(lo, sizeof(lo), lon, 3);
+    double alt = 2240.0 + 3.0 * sin(t * 0.01);
+    double hdop = 0.8 + 0.1 * (t % 7);
+    snprintf(b, sizeof(b), "GPRMC,%02d%02d%02d.00,A,%s,%c,%s,%c,%.3f,%.2f,150325,,,A",
+             hh, mm, ss, la, lat >= 0 ? 'N' : 'S', lo, lon >= 0 ? 'E' : 'W', kmh / 1.852, course);
+    appendSentence(s, b);
+    snprintf(b, sizeof(b), "GPVTG,%.2f,T,,M,%.3f,N,%.2f,K,A", course, kmh / 1.852, kmh);
+    appendSentence(s, b);
+    snprintf(b, sizeof(b), "GPGGA,%02d%02d%02d.00,%s,%c,%s,%c,1,%02d,%.2f,%.1f,M,-5.0,M,,",
+             hh, mm, ss, la, lat >= 0 ? 'N' : 'S', lo, lon >= 0 ? 'E' : 'W', 7 + t % 5, hdop, alt);
+    appendSentence(s, b);
+    appendSentence(s, "GPGSV,3,1,11,03,03,111,00,04,15,270,00,06,01,010,00,13,06,292,00");
+  }
+  return s;
+}
+
+// ==================== MEDICIÓN ====================
+
+struct Result {
+  double ns;                             ///< ns totales
+  unsigned long long cyc;                ///< Ciclos totales
+  unsigned long accepted;                ///< Oraciones aceptadas (encode() == true)
+};
+
+template <class P>
+static Result run(P &p, const std::string &s) {
+  Result r = {0, 0, 0};
+  auto t0 = std::chrono::steady_clock::now();
+  unsigned long long c0 = cycles();
+  for (char c : s) r.accepted += p.encode(c);
+  r.cyc = cycles() - c0;
+  r.ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count();
+  return r;
+}
+
+int main(int argc, char **argv) {
+  std::string s;
+  if (argc > 1) {
+    FILE *f = fopen(argv[1], "rb");
+    if (!f) {
+      perror(argv[1]);
+      return 1;
+    }
+    char buf[4096];
+    size_t n;
+    while ((n = fread(buf, 1, sizeof(buf), f)) > 0) s.append(buf, n);
+    fclose(f);
+  } else {
+    s = synthStream(3600);
+  }
+  unsigned long sentences = 0;
+  for (char c : s) sentences += c == '$';
+  if (sentences == 0) {
+    fprintf(stderr, "Sin oraciones NMEA\n");
+    return 1;
+  }
+
+  // Repetir hasta ~20 MB para una medición estable (cada pasada con parser nuevo)
+  int reps = (int)(20e6 / s.size()) + 1;
+  Result own = {0, 0, 0}, tiny = {0, 0, 0};
+  for (int i = 0; i < reps; i++) {
+    NmeaParser p;
+    TinyGPSPlus t;
+    Result a = run(p, s), b = run(t, s);
+    own.ns += a.ns; own.cyc += a.cyc; own.accepted = a.accepted;
+    tiny.ns += b.ns; tiny.cyc += b.cyc; tiny.accepted = b.accepted;
+  }
+
+  double bytes = (double)s.size() * reps;
+  double sent = (double)sentences * reps;
+  printf("%lu bytes, %lu oraciones x %d pasadas\n", (unsigned long)s.size(), sentences, reps);
+  printf("%-12s %8.1f MB/s %8.1f ciclos/oracion %6.2f ns/byte  aceptadas %lu\n", "NmeaParser",
+         bytes / own.ns * 1e3, own.cyc / sent, own.ns / bytes, own.accepted);
+  printf("%-12s %8.1f MB/s %8.1f ciclos/oracion %6.2f ns/byte  aceptadas %lu\n", "TinyGPSPlus",
+         bytes / tiny.ns * 1e3, tiny.cyc / sent, tiny.ns / bytes, tiny.accepted);
+
+  // Comparación de valores tras cada oración aceptada por ambos
+  NmeaParser p;
+  TinyGPSPlus t;
+  double dLat = 0, dLon = 0, dSpd = 0, dAlt = 0, dHdop = 0;
+  unsigned long compared = 0;
+  for (char c : s) {
+    bool a = p.encode(c);
+    bool b = t.encode(c);
+    if (!(a && b)) continue;
+    const GpsFix &f = p.fix();
+    if (f.has(GPS_LOCATION) && t.location.isValid()) {
+      dLat = fmax(dLat, fabs(f.latE7 * 1e-7 - t.location.lat()));
+      dLon = fmax(dLon, fabs(f.lonE7 * 1e-7 - t.location.lng()));
+    }
+    if (f.has(GPS_SPEED) && t.speed.isValid()) {
+      dSpd = fmax(dSpd, fabs(f.speed * 0.01 - t.speed.kmph()));
+    }
+    if (f.has(GPS_ALTITUDE) && t.altitude.isValid()) {
+      dAlt = fmax(dAlt, fabs(f.altCm * 0.01 - t.altitude.meters()));
+    }
+    if (f.has(GPS_HDOP) && t.hdop.isValid()) {
+      dHdop = fmax(dHdop, fabs(f.hdop * 0.01 - t.hdop.hdop()));
+    }
+    compared++;
+  }
+  printf("Diferencia maxima en %lu oraciones: lat %.2e deg  lon %.2e deg  vel %.3f km/h  "
+         "alt %.3f m  HDOP %.3f\n", compared, dLat, dLon, dSpd, dAlt, dHdop);
+  printf("Checksum NmeaParser ok/falla: %lu/%lu  TinyGPSPlus: %lu/%lu\n",
+         (unsigned long)p.passedChecksum(), (unsigned long)p.failedChecksum(),
+         (unsigned long)t.passedChecksum(), (unsigned long)t.failedChecksum());
+  return 0;
+}
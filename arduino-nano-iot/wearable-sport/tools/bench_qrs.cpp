@@ -0,0 +1,110 @@
+/**
+ * @file bench_qrs.cpp
+ * @brief Reproducción en PC del detector QRS: muestras/s, sensibilidad y PPV
+ * @authors Juan Perez, Ana Gomez
+ * @date 2025
+ *
+ * @details Pasa un trazo de ECG por la misma cadena del firmware
+ * (filterAdcSample() + qrsProcess()) y compara los latidos detectados con
+ * las anotaciones de referencia. Un latido cuenta como verdadero positivo si
+ * cae a menos de 150 ms de una anotación, después de compensar el retardo
+ * constante (mediana) entre detecciones y anotaciones.
+ *
+ * Compilación (desde la carpeta del proyecto):
+ *   g++ -O2 -std=gnu++11 -Iinclude -Itools tools/bench_qrs.cpp src/filter.cpp \
+ *       src/qrs_detector.cpp src/heart_rate.cpp src/hrv.cpp -o bench_qrs
+ *
+ * Uso:
+ *   ./bench_qrs                       Señal sintética con RR y ruido variables
+ *   ./bench_qrs trazo.txt anot.txt    Trazo grabado a SAMPLE_RATE
+ * trazo.txt: una lectura del ADC por línea. anot.txt: índice de muestra de
+ * cada pico R, uno por línea.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <algorithm>
+#include <chrono>
+#include <vector>
+#include "config.h"
+#include "filter.h"
+#include "qrs_detector.h"
+#include "ecg_synth.h"
+
+template <class T>
+static std::vector<T> loadColumn(const char *path) {
+  std::vector<T> v;
+  FILE *f = fopen(path, "r");
+  if (!f) {
+    perror(path);
+    exit(1);
+  }
+  double a;
+  while (fscanf(f, "%lf", &a) == 1) v.push_back((T)a);
+  fclose(f);
+  return v;
+}
+
+int main(int argc, char **argv) {
+  std::vector<int> trace;
+  std::vector<long> ref;
+  if (argc > 2) {
+    trace = loadColumn<int>(argv[1]);
+    ref = loadColumn<long>(argv[2]);
+  } else {
+    trace = ecgSynth(1800, 0.33, 1.1, 40, &ref);  // 30 min, 55-180 bpm
+  }
+
+  std::vector<long> det;
+  qrsReset();
+  auto t0 = std::chrono::steady_clock::now();
+  // El trazo está en cuentas del ADC; con sobremuestreo el filtro espera ECG_SAMPLE_BITS
+  const int inShift = ECG_SAMPLE_BITS - ADC_RESOLUTION;
+  for (size_t i = 0; i < trace.size(); ++i) {
+    QrsBeat b;
+    if (qrsProcess(filterAdcSample(trace[i] << inShift), &b)) det.push_back(b.sample);
+  }
+  auto t1 = std::chrono::steady_clock::now();
+  double secs = std::chrono::duration<double>(t1 - t0).count();
+
+  // Retardo constante entre detección y anotación (mediana de la anotación más cercana)
+  std::vector<long> offs;
+  for (size_t i = 0; i < det.size(); ++i) {
+    std::vector<long>::iterator it = std::lower_bound(ref.begin(), ref.end(), det[i]);
+    long best = 1L << 30;
+    if (it != ref.end()) best = det[i] - *it;
+    if (it != ref.begin() && labs(det[i] - *(it - 1)) < labs(best)) best = det[i] - *(it - 1);
+    offs.push_back(best);
+  }
+  long delay = 0;
+  if (!offs.empty()) {
+    std::nth_element(offs.begin(), offs.begin() + offs.size() / 2, offs.end());
+    delay = offs[offs.size() / 2];
+  }
+
+  // Emparejamiento uno a uno con tolerancia de 150 ms
+  const long tol = (150L * SAMPLE_RATE + 999) / 1000;
+  long tp = 0;
+  size_t j = 0;
+  for (size_t i = 0; i < ref.size(); ++i) {
+    while (j < det.size() && det[j] - delay < ref[i] - tol) j++;
+    if (j < det.size() && labs(det[j] - delay - ref[i]) <= tol) {
+      tp++;
+      j++;
+    }
+  }
+  long fn = (long)ref.size() - tp;
+  long fp = (long)det.size() - tp;
+
+  printf("Muestras: %u a %d Hz (%.1f min)\n", (unsigned)trace.size(), SAMPLE_RATE,
+         trace.size() / (60.0 * SAMPLE_RATE));
+  printf("Rendimiento: %.2f Mmuestras/s (%.1f ns/muestra, %.0fx tiempo real)\n",
+         trace.size() / secs / 1e6, secs * 1e9 / trace.size(), trace.size() / (secs * SAMPLE_RATE));
+  printf("Latidos ref/det: %u/%u  retardo: %ld muestras\n", (unsigned)ref.size(), (unsigned)det.size(), delay);
+  printf("TP %ld  FN %ld  FP %ld\n", tp, fn, fp);
+  printf("Sensibilidad: %.2f %%  PPV: %.2f %%\n",
+         ref.empty() ? 0.0 : 100.0 * tp / (tp + fn), det.empty() ? 0.0 : 100.0 * tp / (tp + fp));
+  printf("Search-back: %u  Ondas T descartadas: %u\n", qrsStats.searchBacks, qrsStats.tWaves);
+  return 0;
+}
@@ -0,0 +1,233 @@
+/**
+ * @file bin2csv.cpp
+ * @brief Convierte el registro binario de sesión (sesion.bin) o de sprints (sprints.bin) a CSV o JSON
+ * @authors Juan Perez, Ana Gomez
+ * @date 2025
+ *
+ * @details Lee el formato de session_log.h: valida el encabezado, verifica
+ * el CRC de cada registro y, si un registro está dañado, busca el siguiente
+ * byte de sincronía. La salida CSV tiene las mismas columnas y decimales que
+ * guardarDatosCSV(), más pasos, cadencia, impactos y pico de aceleración
+ * del MotionRecord de cada minuto (vacías sin IMU); la salida JSON es un
+ * objeto por línea con el número de registro y millis() adicionales.
+ *
+ * Con el archivo de sprints (magic "WSSP") la salida es una fila por
+ * sprint: inicio (hora local con milisegundos), duración, distancia y picos.
+ *
+ * Compilación (desde la carpeta del proyecto):
+ *   g++ -O2 -std=gnu++11 -Iinclude tools/bin2csv.cpp -o bin2csv
+ *
+ * Uso:
+ *   ./bin2csv sesion.bin [--json] > sesion.csv
+ *   ./bin2csv sprints.bin [--json] > sprints.csv
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include "session_log.h"
+
+static int wrapHour(int h) {
+  while (h < 0) h += 24;
+  while (h >= 24) h -= 24;
+  return h;
+}
+
+/**
+ * @brief Timestamp igual al del CSV: fecha UTC y hora local, o segundos desde el arranque
+ */
+static std::string timestamp(const MinuteRecord &r, int utcOffsetH) {
+  char b[40];
+  if (r.utcDate == 0) {
+    snprintf(b, sizeof(b), "%lu", (unsigned long)(r.millisMs / 1000));
+  } else {
+    unsigned y = r.utcDate / 10000, mo = r.utcDate / 100 % 100, d = r.utcDate % 100;
+    unsigned h = r.utcTime / 10000, mi = r.utcTime / 100 % 100, s = r.utcTime % 100;
+    snprintf(b, sizeof(b), "%u-%02u-%02u %02d:%02u:%02u", y, mo, d,
+             wrapHour((int)h + utcOffsetH), mi, s);
+  }
+  return b;
+}
+
+static void printCsvHeader() {
+  printf("Timestamp,Dist_m,Dist_Total_km,Vel_Prom_kmh,Vel_Max_kmh,"
+         "BPM_Prom,Seg_CAM,Seg_TRO,Seg_CAR,Seg_SPR,"
+         "Dist_CAM_m,Dist_TRO_m,Dist_CAR_m,Dist_SPR_m,"
+         "Seg_HZ1,Seg_HZ2,Seg_HZ3,Seg_HZ4,Seg_HZ5,Seg_HZ6,"
+         "TRIMP,Sprints_Min,Sprints_Total,"
+         "RMSSD_ms,SDNN_ms,pNN50,"
+         "Pasos,Cadencia_ppm,Impactos,Pico_g\n");
+}
+
+/** @brief Fila CSV de un minuto; motion es nullptr si el minuto no tiene MotionRecord */
+static void printCsv(const MinuteRecord &r, const MotionRecord *motion, int utcOffsetH) {
+  printf("%s,%.1f,%.3f,%.1f,%.1f,%.1f,", timestamp(r, utcOffsetH).c_str(),
+         r.distMinuteDm / 10.0, r.distTotalDm / 10000.0,
+         r.vMean / 100.0, r.vMax / 100.0, r.bpmMean / 10.0);
+  for (int i = 0; i < 4; i++) printf("%u,", r.secVZ[i]);
+  for (int i = 0; i < 4; i++) printf("%u,", r.distVZ[i]);
+  for (int i = 0; i < 6; i++) printf("%u,", r.secHZ[i]);
+  printf("%.2f,%u,%u,%.1f,%.1f,%.1f,", r.trimp / 100.0, r.sprintsMin, r.sprintsTotal,
+         r.rmssd / 10.0, r.sdnn / 10.0, r.pnn50 / 10.0);
+  if (motion) {
+    printf("%u,%.1f,%u,%.2f\n", motion->steps, motion->cadence / 10.0, motion->impacts,
+           motion->peakMg / 1000.0);
+  } else {
+    printf(",,,\n");
+  }
+}
+
+static void printJson(const MinuteRecord &r, int utcOffsetH) {
+  printf("{\"seq\":%lu,\"millis\":%lu,\"timestamp\":\"%s\","
+         "\"dist_m\":%.1f,\"dist_total_km\":%.3f,\"vel_prom_kmh\":%.2f,\"vel_max_kmh\":%.2f,"
+         "\"bpm_prom\":%.1f,",
+         (unsigned long)r.seq, (unsigned long)r.millisMs, timestamp(r, utcOffsetH).c_str(),
+         r.distMinuteDm / 10.0, r.distTotalDm / 10000.0, r.vMean / 100.0, r.vMax / 100.0,
+         r.bpmMean / 10.0);
+  printf("\"seg_vz\":[%u,%u,%u,%u],\"dist_vz_m\":[%u,%u,%u,%u],\"seg_hz\":[%u,%u,%u,%u,%u,%u],",
+         r.secVZ[0], r.secVZ[1], r.secVZ[2], r.secVZ[3],
+         r.distVZ[0], r.distVZ[1], r.distVZ[2], r.distVZ[3],
+         r.secHZ[0], r.secHZ[1], r.secHZ[2], r.secHZ[3], r.secHZ[4], r.secHZ[5]);
+  printf("\"trimp\":%.2f,\"sprints_min\":%u,\"sprints_total\":%u,"
+         "\"rmssd_ms\":%.1f,\"sdnn_ms\":%.1f,\"pnn50\":%.1f}\n",
+         r.trimp / 100.0, r.sprintsMin, r.sprintsTotal,
+         r.rmssd / 10.0, r.sdnn / 10.0, r.pnn50 / 10.0);
+}
+
+static void printJsonMotion(const MotionRecord &m) {
+  printf("{\"seq\":%lu,\"pasos\":%u,\"cadencia_ppm\":%.1f,\"impactos\":%u,\"pico_g\":%.3f,"
+         "\"fifo_desbordada\":%u}\n",
+         (unsigned long)m.seq, m.steps, m.cadence / 10.0, m.impacts, m.peakMg / 1000.0,
+         m.fifoOverruns);
+}
+
+/**
+ * @brief Inicio de un sprint: fecha UTC y hora local con ms, o segundos desde el arranque
+ */
+static std::string sprintStart(const SprintRecord &r, int utcOffsetH) {
+  char b[40];
+  if (r.utcDate == 0) {
+    snprintf(b, sizeof(b), "%.3f", r.startMillis / 1000.0);
+  } else {
+    unsigned y = r.utcDate / 10000, mo = r.utcDate / 100 % 100, d = r.utcDate % 100;
+    unsigned long t = r.utcStartMs;
+    unsigned h = t / 3600000, mi = t / 60000 % 60, s = t / 1000 % 60, ms = t % 1000;
+    snprintf(b, sizeof(b), "%u-%02u-%02u %02d:%02u:%02u.%03u", y, mo, d,
+             wrapHour((int)h + utcOffsetH), mi, s, ms);
+  }
+  return b;
+}
+
+static void printSprintCsvHeader() {
+  printf("Sprint,Inicio,Millis_s,Duracion_s,Dist_m,Vel_Pico_kmh,Acel_Pico_ms2\n");
+}
+
+static void printSprint(const SprintRecord &r, int utcOffsetH, bool json) {
+  if (json) {
+    printf("{\"sprint\":%lu,\"millis\":%lu,\"inicio\":\"%s\",\"duracion_s\":%.3f,"
+           "\"dist_m\":%.1f,\"vel_pico_kmh\":%.2f,\"acel_pico_ms2\":%.2f}\n",
+           (unsigned long)r.seq, (unsigned long)r.startMillis, sprintStart(r, utcOffsetH).c_str(),
+           r.durationMs / 1000.0, r.distDm / 10.0, r.vPeak / 100.0, r.aPeak / 100.0);
+  } else {
+    printf("%lu,%s,%.3f,%.3f,%.1f,%.2f,%.2f\n", (unsigned long)r.seq,
+           sprintStart(r, utcOffsetH).c_str(), r.startMillis / 1000.0, r.durationMs / 1000.0,
+           r.distDm / 10.0, r.vPeak / 100.0, r.aPeak / 100.0);
+  }
+}
+
+int main(int argc, char **argv) {
+  const char *path = nullptr;
+  bool json = false;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--json") == 0) json = true;
+    else path = argv[i];
+  }
+  if (!path) {
+    fprintf(stderr, "Uso: %s sesion.bin|sprints.bin [--json]\n", argv[0]);
+    return 1;
+  }
+
+  FILE *f = fopen(path, "rb");
+  if (!f) {
+    perror(path);
+    return 1;
+  }
+  std::vector<uint8_t> data;
+  uint8_t buf[4096];
+  size_t n;
+  while ((n = fread(buf, 1, sizeof(buf), f)) > 0) data.insert(data.end(), buf, buf + n);
+  fclose(f);
+
+  SessionLogHeader h;
+  if (data.size() < sizeof(h)) {
+    fprintf(stderr, "%s: archivo demasiado corto\n", path);
+    return 1;
+  }
+  memcpy(&h, data.data(), sizeof(h));
+  bool sprints = memcmp(h.magic, "WSSP", 4) == 0;
+  if ((!sprints && memcmp(h.magic, "WSLG", 4) != 0) || h.crc != crc16Ccitt(&h, offsetof(SessionLogHeader, crc))) {
+    fprintf(stderr, "%s: encabezado inválido\n", path);
+    return 1;
+  }
+  if (h.version != SESSION_LOG_VERSION) {
+    fprintf(stderr, "%s: versión %u no soportada (se espera %u)\n", path, h.version, SESSION_LOG_VERSION);
+    return 1;
+  }
+
+  if (!json) {
+    if (sprints) printSprintCsvHeader();
+    else printCsvHeader();
+  }
+  unsigned long good = 0, bad = 0, unknown = 0;
+  // En CSV el minuto espera a su MotionRecord (mismo seq) para imprimirse en una fila
+  MinuteRecord pending;
+  bool havePending = false;
+  size_t pos = h.headerSize;
+  while (pos + sizeof(RecordPrefix) <= data.size()) {
+    RecordPrefix pre;
+    memcpy(&pre, &data[pos], sizeof(pre));
+    if (pre.sync != SESSION_LOG_SYNC || pre.len < sizeof(RecordPrefix) + 2 || pos + pre.len > data.size() ||
+        crc16Ccitt(&data[pos], pre.len - 2) != (uint16_t)(data[pos + pre.len - 2] | data[pos + pre.len - 1] << 8)) {
+      // Registro dañado o truncado: buscar la siguiente sincronía
+      bad++;
+      pos++;
+      while (pos < data.size() && data[pos] != SESSION_LOG_SYNC) pos++;
+      continue;
+    }
+    if (pre.type == REC_MINUTE && pre.len == sizeof(MinuteRecord)) {
+      MinuteRecord r;
+      memcpy(&r, &data[pos], sizeof(r));
+      if (json) {
+        printJson(r, h.utcOffsetH);
+      } else {
+        if (havePending) printCsv(pending, nullptr, h.utcOffsetH);
+        pending = r;
+        havePending = true;
+      }
+      good++;
+    } else if (pre.type == REC_MOTION && pre.len == sizeof(MotionRecord)) {
+      MotionRecord m;
+      memcpy(&m, &data[pos], sizeof(m));
+      if (json) {
+        printJsonMotion(m);
+      } else if (havePending && pending.seq == m.seq) {
+        printCsv(pending, &m, h.utcOffsetH);
+        havePending = false;
+      }
+      good++;
+    } else if (pre.type == REC_SPRINT && pre.len == sizeof(SprintRecord)) {
+      SprintRecord r;
+      memcpy(&r, &data[pos], sizeof(r));
+      printSprint(r, h.utcOffsetH, json);
+      good++;
+    } else {
+      unknown++;
+    }
+    pos += pre.len;
+  }
+  if (havePending) printCsv(pending, nullptr, h.utcOffsetH);
+
+  fprintf(stderr, "%lu registros, %lu de tipo desconocido, %lu posiciones dañadas\n", good, unknown, bad);
+  return 0;
+}
@@ -0,0 +1,64 @@
+/**
+ * @file ecg_synth.h
+ * @brief Señal ECG sintética para las herramientas de PC
+ * @authors Juan Perez, Ana Gomez
+ * @date 2025
+ *
+ * @details Genera lecturas del ADC a SAMPLE_RATE con complejos QRS
+ * gaussianos, onda T, deriva de línea base y ruido, junto con la posición
+ * (en muestras) de cada pico R para medir detectores.
+ */
+
+#ifndef ECG_SYNTH_H
+#define ECG_SYNTH_H
+
+#include <stdlib.h>
+#include <math.h>
+#include <vector>
+#include "config.h"
+
+/**
+ * @brief Genera una señal ECG sintética
+ *
+ * @param seconds Duración en segundos
+ * @param rrMinS RR mínimo (s); el RR hace una caminata aleatoria hasta rrMaxS
+ * @param rrMaxS RR máximo (s)
+ * @param noise Amplitud del ruido uniforme (cuentas del ADC)
+ * @param beats Posiciones de los picos R (salida, puede ser nullptr)
+ * @return std::vector<int> Lecturas del ADC
+ */
+static inline std::vector<int> ecgSynth(int seconds, double rrMinS, double rrMaxS, int noise,
+                                        std::vector<long> *beats) {
+  const int adcMid = 1 << (ADC_RESOLUTION - 1);
+  const int adcMax = (1 << ADC_RESOLUTION) - 1;
+  std::vector<int> v;
+  srand(1234);
+  double beat = 0.5, rr = rrMaxS;
+  if (beats) beats->push_back(lround(beat * SAMPLE_RATE));
+  for (long n = 0; n < (long)seconds * SAMPLE_RATE; ++n) {
+    double t = (double)n / SAMPLE_RATE;
+    if (t > beat + 0.5 * rr) {
+      rr += 0.04 * (rand() / (double)RAND_MAX - 0.5);
+      if (rr < rrMinS) rr = rrMinS;
+      if (rr > rrMaxS) rr = rrMaxS;
+      beat += rr;
+      if (beats) beats->push_back(lround(beat * SAMPLE_RATE));
+    }
+    // Contribución del latido actual y del anterior (onda T tardía)
+    double x = adcMid + 250.0 * sin(2 * M_PI * 0.2 * t);
+    double bq[2] = {beat, beat - rr};
+    for (int k = 0; k < 2; ++k) {
+      double dq = t - bq[k], dt = t - bq[k] - 0.25;
+      x += 900.0 * exp(-dq * dq / (2 * 0.012 * 0.012)) + 150.0 * exp(-dt * dt / (2 * 0.04 * 0.04));
+    }
+    x += (rand() % (2 * noise + 1)) - noise;
+    int a = (int)lround(x);
+    if (a < 0) a = 0;
+    if (a > adcMax) a = adcMax;
+    v.push_back(a);
+  }
+  if (beats && !beats->empty() && beats->back() >= (long)v.size()) beats->pop_back();
+  return v;
+}
+
+#endif // ECG_SYNTH_H
@@ -0,0 +1,102 @@
+/**
+ * @file ecgcap2csv.cpp
+ * @brief Convierte una captura de ECG (ECGnn.BIN) a CSV o a texto para el reproductor
+ * @authors Juan Perez, Ana Gomez
+ * @date 2025
+ *
+ * @details Lee el formato de ecg_capture.h: valida el encabezado y recorre
+ * los sectores de datos hasta el primero sin escribir (en 0x00 o en 0xFF,
+ * según cómo borre la tarjeta). Los sectores con CRC inválido se saltan y
+ * se cuentan.
+ *
+ * - Salida CSV (por defecto): muestra, tiempo (s), lectura cruda y filtrada.
+ * - Con --raw: solo la lectura cruda, una por línea, que es la entrada
+ *   --ecg del entorno `native` y de bench_qrs. Los huecos se rellenan
+ *   repitiendo la última lectura para conservar la base de tiempo. Las
+ *   capturas sobremuestreadas (adcBits > ADC_RESOLUTION) se pasan a cuentas
+ *   del ADC.
+ *
+ * Compilación (desde la carpeta del proyecto):
+ *   g++ -O2 -std=gnu++11 -Iinclude tools/ecgcap2csv.cpp -o ecgcap2csv
+ *
+ * Uso:
+ *   ./ecgcap2csv ECG00.BIN > ecg.csv
+ *   ./ecgcap2csv ECG00.BIN --raw > ecg.txt
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "config.h"
+#include "ecg_capture.h"
+
+int main(int argc, char **argv) {
+  const char *path = nullptr;
+  bool raw = false;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--raw") == 0) raw = true;
+    else path = argv[i];
+  }
+  if (!path) {
+    fprintf(stderr, "Uso: %s ECG00.BIN [--raw]\n", argv[0]);
+    return 1;
+  }
+
+  FILE *f = fopen(path, "rb");
+  if (!f) {
+    perror(path);
+    return 1;
+  }
+  CaptureFileHeader h;
+  if (fread(&h, 1, sizeof(h), f) != sizeof(h) || memcmp(h.magic, "WECG", 4) != 0 ||
+      h.crc != crc16Ccitt(&h, offsetof(CaptureFileHeader, crc))) {
+    fprintf(stderr, "%s: encabezado inválido\n", path);
+    fclose(f);
+    return 1;
+  }
+  if (h.version != CAPTURE_VERSION || h.perSector != CAPTURE_PER_SECTOR) {
+    fprintf(stderr, "%s: versión %u no soportada (se espera %u)\n", path, h.version, CAPTURE_VERSION);
+    fclose(f);
+    return 1;
+  }
+
+  if (!raw) printf("Muestra,Tiempo_s,Crudo,Filtrado\n");
+  unsigned long sectors = 0, bad = 0, gaps = 0, lost = 0;
+  unsigned long samples = 0;
+  bool haveNext = false;
+  uint32_t next = 0;
+  uint16_t lastRaw = (uint16_t)(1u << (h.adcBits - 1));
+  const int rawShift = h.adcBits > ADC_RESOLUTION ? h.adcBits - ADC_RESOLUTION : 0;
+  CaptureSector s;
+  for (uint32_t k = 0; k < h.dataSectors && fread(&s, 1, sizeof(s), f) == sizeof(s); k++) {
+    if (captureSectorErased(s)) break;   // Fin de la captura
+    if (s.count > CAPTURE_PER_SECTOR || s.crc != captureSectorCrc(s)) {
+      bad++;
+      continue;
+    }
+    if (haveNext && s.firstSample != next) {
+      gaps++;
+      if (s.firstSample > next) {
+        lost += s.firstSample - next;
+        if (raw) {
+          for (uint32_t i = next; i < s.firstSample; i++) printf("%u\n", lastRaw >> rawShift);
+        }
+      }
+    }
+    for (int i = 0; i < s.count; i++) {
+      uint32_t n = s.firstSample + i;
+      if (raw) printf("%u\n", s.s[i].raw >> rawShift);
+      else printf("%lu,%.4f,%u,%d\n", (unsigned long)n, (double)n / h.sampleRate, s.s[i].raw, s.s[i].filt);
+    }
+    lastRaw = s.s[s.count - 1].raw;
+    next = s.firstSample + s.count;
+    haveNext = true;
+    samples += s.count;
+    sectors++;
+  }
+  fclose(f);
+
+  fprintf(stderr, "%lu muestras a %u Hz (%.1f s) en %lu sectores; %lu sectores dañados, "
+          "%lu huecos (%lu muestras perdidas)\n",
+          samples, h.sampleRate, (double)samples / h.sampleRate, sectors, bad, gaps, lost);
+  return 0;
+}
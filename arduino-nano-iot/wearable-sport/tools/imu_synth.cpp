@@ -0,0 +1,162 @@
+/**
+ * @file imu_synth.cpp
+ * @brief Registros sintéticos de acelerómetro y GPS para reproducir la fusión de velocidad
+ * @authors Juan Perez, Ana Gomez
+ * @date 2025
+ *
+ * @details Genera un recorrido con velocidad conocida y escribe lo que
+ * registrarían los sensores:
+ * - imu.txt: muestras crudas del LSM6DS3 ("ax ay az", LSB a ±16 g) a
+ *   IMU_RATE_HZ, con la aceleración de avance en IMU_FWD_AXIS más la
+ *   gravedad proyectada por 8° de inclinación, la oscilación de cada paso
+ *   (un pico vertical por apoyo), un impacto de 7 g en el segundo 35 de
+ *   cada minuto y ruido.
+ * - gps.nmea: RMC y GGA a 1 Hz con la velocidad Doppler (ruido 0.3 km/h) y
+ *   la posición (ruido correlacionado de ~2 m).
+ *
+ * Cada minuto: 10 s parado, trote a 10 km/h, un sprint de 5 s a 28 km/h y
+ * vuelta a trote y a caminar. Al final imprime, por minuto, la distancia, la
+ * velocidad pico, los segundos sobre SPRINT_KMH, los pasos y la cadencia
+ * reales, para compararlos con el resumen del reproductor con y sin --imu.
+ *
+ * Compilación (desde la carpeta del proyecto):
+ *   g++ -O2 -std=gnu++11 -Iinclude tools/imu_synth.cpp -o imu_synth
+ *
+ * Uso:
+ *   ./imu_synth imu.txt gps.nmea [minutos]
+ *   ./replay --nmea gps.nmea --imu imu.txt --seconds 180
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <random>
+#include "config.h"
+#include "imu.h"
+
+static const double G = 9.80665;
+static const double TILT_RAD = 8.0 * M_PI / 180.0;
+static const double LAT0 = 19.3, LON0 = -99.1;
+
+/** @brief Frecuencia de pasos (Hz) a la velocidad v (m/s): ~118 ppm caminando, ~164 en sprint */
+static double stepHz(double v) {
+  return v > 0.3 ? 1.8 + 0.12 * v : 0.0;
+}
+
+/** @brief Velocidad real (m/s) en el segundo t del minuto: tramos unidos con rampas suaves */
+static double speedAt(double t) {
+  static const double knots[][2] = {
+      {0, 0}, {10, 0}, {13, 10}, {40, 10}, {41.7, 28}, {45, 28}, {48, 10}, {53, 10}, {55, 5}, {58, 5}, {60, 0}};
+  double m = fmod(t, 60.0);
+  for (int i = 1; i < (int)(sizeof(knots) / sizeof(knots[0])); i++) {
+    if (m <= knots[i][0]) {
+      double t0 = knots[i - 1][0], t1 = knots[i][0];
+      double u = (m - t0) / (t1 - t0);
+      u = u * u * (3 - 2 * u);             // Rampa con aceleración continua
+      return (knots[i - 1][1] + (knots[i][1] - knots[i - 1][1]) * u) / 3.6;
+    }
+  }
+  return 0;
+}
+
+static int16_t toLsb(double a) {
+  double r = a / IMU_MS2_PER_LSB;
+  if (r > 32767) r = 32767;
+  if (r < -32768) r = -32768;
+  return (int16_t)lrint(r);
+}
+
+static void nmeaCoord(char *b, size_t n, double deg, int degDigits) {
+  double a = fabs(deg);
+  int d = (int)a;
+  snprintf(b, n, "%0*d%08.5f", degDigits, d, (a - d) * 60.0);
+}
+
+static void sentence(FILE *f, const char *body) {
+  uint8_t cs = 0;
+  for (const char *p = body; *p; p++) cs ^= (uint8_t)*p;
+  fprintf(f, "$%s*%02X\r\n", body, cs);
+}
+
+int main(int argc, char **argv) {
+  if (argc < 3) {
+    fprintf(stderr, "Uso: %s imu.txt gps.nmea [minutos]\n", argv[0]);
+    return 1;
+  }
+  int minutes = argc > 3 ? atoi(argv[3]) : 3;
+  FILE *fi = fopen(argv[1], "w");
+  FILE *fg = fopen(argv[2], "w");
+  if (!fi || !fg) {
+    perror("salida");
+    return 1;
+  }
+
+  std::mt19937 rng(7);
+  std::normal_distribution<double> n01(0.0, 1.0);
+  const double dt = 1.0 / IMU_RATE_HZ;
+  const long total = (long)minutes * 60 * IMU_RATE_HZ;
+
+  // Muestras del acelerómetro
+  double phase = 0;
+  fprintf(fi, "# ax ay az (LSB, +-16 g) a %d Hz\n", IMU_RATE_HZ);
+  for (long i = 0; i < total; i++) {
+    double t = i * dt;
+    double v = speedAt(t);
+    double a = (speedAt(t + dt / 2) - speedAt(t - dt / 2)) / dt;
+    phase += 2 * M_PI * stepHz(v) * dt;
+    bool moving = v > 0.3;
+    double contact = moving ? pow(fmax(0.0, sin(phase)), 4) : 0.0;
+    double impact = fmod(t, 60.0) >= 35.0 && fmod(t, 60.0) < 35.03 ? 7.0 * G : 0.0;
+    double axis[3];
+    axis[0] = a * cos(TILT_RAD) + G * sin(TILT_RAD) + 2.5 * sin(phase) * moving + 0.3 * n01(rng);
+    axis[1] = 0.8 * sin(phase / 2) * moving + 0.3 * n01(rng);
+    axis[2] = G * cos(TILT_RAD) + (1.2 * G * contact - 0.25 * G) * moving + impact + 0.3 * n01(rng);
+    double fwd = (IMU_FWD_SIGN) * axis[0];
+    double out[3] = {axis[1], axis[2], axis[0]};
+    out[IMU_FWD_AXIS] = fwd;
+    out[(IMU_FWD_AXIS + 1) % 3] = axis[1];
+    out[(IMU_FWD_AXIS + 2) % 3] = axis[2];
+    fprintf(fi, "%d %d %d\n", toLsb(out[0]), toLsb(out[1]), toLsb(out[2]));
+  }
+
+  // GPS a 1 Hz hacia el este, con la verdad por minuto
+  double xM = 0, nx = 0, ny = 0;
+  double distMin = 0, peakMin = 0, sprintS = 0, steps = 0, stepS = 0;
+  char b[160], la[24], lo[24];
+  printf("minuto  dist_m  pico_kmh  s_sobre_%.0fkmh  pasos  cadencia_ppm\n", 20.0);
+  for (int s = 0; s <= minutes * 60; s++) {
+    for (int k = 0; k < IMU_RATE_HZ && s > 0; k++) {
+      double t = (s - 1) + (double)k / IMU_RATE_HZ;
+      double v = speedAt(t);
+      distMin += v * dt;
+      xM += v * dt;
+      if (v * 3.6 > peakMin) peakMin = v * 3.6;
+      if (v * 3.6 >= 20.0) sprintS += dt;
+      steps += stepHz(v) * dt;
+      if (stepHz(v) > 0) stepS += dt;
+    }
+    if (s > 0 && s % 60 == 0) {
+      printf("%6d  %6.1f  %8.1f  %6.1f  %5.0f  %6.1f\n", s / 60, distMin, peakMin, sprintS,
+             steps, stepS > 0 ? steps / stepS * 60 : 0.0);
+      distMin = peakMin = sprintS = steps = stepS = 0;
+    }
+    nx = 0.9 * nx + 0.8 * n01(rng);
+    ny = 0.9 * ny + 0.8 * n01(rng);
+    double lat = LAT0 + ny / 111195.0;
+    double lon = LON0 + (xM + nx) / (111195.0 * cos(LAT0 * M_PI / 180));
+    double kmh = speedAt(s) * 3.6 + 0.3 * n01(rng);
+    if (kmh < 0) kmh = 0;
+    int hh = 12 + s / 3600, mm = s / 60 % 60, ss = s % 60;
+    nmeaCoord(la, sizeof(la), lat, 2);
+    nmeaCoord(lo, sizeof(lo), lon, 3);
+    snprintf(b, sizeof(b), "GPRMC,%02d%02d%02d.00,A,%s,N,%s,W,%.3f,90.00,150325,,,A",
+             hh, mm, ss, la, lo, kmh / 1.852);
+    sentence(fg, b);
+    snprintf(b, sizeof(b), "GPGGA,%02d%02d%02d.00,%s,N,%s,W,1,09,0.90,2240.0,M,-5.0,M,,",
+             hh, mm, ss, la, lo);
+    sentence(fg, b);
+  }
+  fclose(fi);
+  fclose(fg);
+  return 0;
+}
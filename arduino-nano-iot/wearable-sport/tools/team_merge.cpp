@@ -0,0 +1,752 @@
+/**
+ * @file team_merge.cpp
+ * @brief Une los registros de todo el equipo: totales, percentiles por jugador y carga por minuto
+ * @authors Juan Perez, Ana Gomez
+ * @date 2025
+ *
+ * @details Recorre una carpeta con las tarjetas copiadas, una subcarpeta por
+ * jugador (el nombre de la subcarpeta es el del jugador) con cualquier
+ * número de sesiones dentro:
+ *
+ *   temporada/
+ *     perez/datos.csv
+ *     gomez/2025-03-01/sesion.bin
+ *     ...
+ *
+ * Lee datos.csv (columnas de crearArchivoCSV(), por nombre, así que también
+ * acepta la salida de bin2csv) y sesion.bin (session_log.h, con CRC). Los
+ * archivos se reparten entre varios hilos; cada uno se lee completo y se
+ * analiza en memoria sin copias intermedias.
+ *
+ * Las filas se alinean por el minuto de su Timestamp (fecha UTC y hora local
+ * del GPS, como en el CSV; sesion.bin se convierte igual).
+ * Las filas sin hora GPS (segundos desde el arranque) no se pueden alinear:
+ * se cuentan y se descartan. Una última fila sin salto de línea (la tarjeta
+ * perdió energía a mitad de la escritura) se cuenta como dañada.
+ *
+ * Salida:
+ * - stdout: totales del equipo y, por jugador, totales y percentiles
+ *   (p50/p90/máx) de distancia, TRIMP y BPM por minuto.
+ * - -o archivo: formato columnar (ver ColHeader) con tres tablas: "filas"
+ *   (todas las filas alineadas), "jugadores" y "minutos" (carga del equipo
+ *   por minuto). Cada columna es un arreglo contiguo, así que se recarga
+ *   con una lectura por columna; --dump lo vuelve a imprimir como CSV.
+ *
+ * Compilación (desde la carpeta del proyecto):
+ *   g++ -O2 -std=gnu++11 -pthread -Iinclude tools/team_merge.cpp -o team_merge
+ *
+ * Uso:
+ *   ./team_merge temporada/ [-o equipo.col] [-j hilos]
+ *   ./team_merge --dump equipo.col [tabla] > tabla.csv
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <climits>
+#include <algorithm>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+#include "session_log.h"
+
+// ==================== FILAS ====================
+
+/**
+ * @struct Row
+ * @brief Un minuto de un jugador
+ */
+struct Row {
+  int32_t minute;                        ///< Minutos desde 1970-01-01 00:00 (hora local)
+  int32_t player;                        ///< Índice del jugador
+  float distM;                           ///< Distancia del minuto (m)
+  float hsDistM;                         ///< Distancia en zonas correr + sprint (m)
+  float vMaxKmh;                         ///< Velocidad máxima (km/h)
+  float bpm;                             ///< BPM promedio (0 = sin latidos)
+  float trimp;                           ///< TRIMP del minuto
+  int32_t sprints;                       ///< Sprints del minuto
+};
+
+/**
+ * @struct FileResult
+ * @brief Filas de un archivo y contadores de lectura
+ */
+struct FileResult {
+  std::vector<Row> rows;
+  unsigned long unaligned = 0;           ///< Filas sin hora GPS
+  unsigned long bad = 0;                 ///< Filas o registros dañados
+  bool ok = true;                        ///< Se pudo abrir y reconocer
+  bool other = false;                    ///< Otro binario del firmware (sprints.bin, ECGnn.BIN): se ignora
+};
+
+/**
+ * @struct Input
+ * @brief Archivo por leer
+ */
+struct Input {
+  std::string path;
+  int32_t player;
+  bool binary;
+};
+
+/**
+ * @brief Días desde 1970-01-01 de una fecha civil
+ */
+static int32_t daysFromCivil(int y, unsigned m, unsigned d) {
+  y -= m <= 2;
+  const int era = (y >= 0 ? y : y - 399) / 400;
+  const unsigned yoe = (unsigned)(y - era * 400);
+  const unsigned doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+  const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+  return era * 146097 + (int32_t)doe - 719468;
+}
+
+/**
+ * @brief Minuto de un Timestamp "AAAA-MM-DD HH:MM:SS"
+ *
+ * @return false Si no tiene ese formato (p. ej. segundos desde el arranque)
+ */
+static bool parseTimestamp(const char *s, const char *end, int32_t *minute) {
+  if (end - s < 16 || s[4] != '-' || s[7] != '-' || s[10] != ' ' || s[13] != ':') return false;
+  // El buffer del archivo no termina en NUL: atoi() trabaja sobre una copia
+  char t[17];
+  memcpy(t, s, 16);
+  t[16] = '\0';
+  int y = atoi(t), mo = atoi(t + 5), d = atoi(t + 8), h = atoi(t + 11), mi = atoi(t + 14);
+  if (mo < 1 || mo > 12 || d < 1 || d > 31 || h > 23 || mi > 59) return false;
+  *minute = daysFromCivil(y, mo, d) * 1440 + h * 60 + mi;
+  return true;
+}
+
+/**
+ * @brief Lee un archivo completo
+ */
+static bool readAll(const std::string &path, std::vector<char> *data) {
+  FILE *f = fopen(path.c_str(), "rb");
+  if (!f) return false;
+  fseek(f, 0, SEEK_END);
+  long n = ftell(f);
+  fseek(f, 0, SEEK_SET);
+  data->resize(n > 0 ? n : 0);
+  bool ok = n <= 0 || fread(data->data(), 1, n, f) == (size_t)n;
+  fclose(f);
+  return ok;
+}
+
+/**
+ * @brief Valor numérico de un campo [f, fe)
+ *
+ * strtof() lee hasta el primer carácter que no es parte del número; el
+ * buffer no termina en NUL, así que un campo al final del archivo se copia.
+ */
+static float fieldFloat(const char *f, const char *fe) {
+  char t[32];
+  size_t n = (size_t)(fe - f) < sizeof(t) - 1 ? (size_t)(fe - f) : sizeof(t) - 1;
+  memcpy(t, f, n);
+  t[n] = '\0';
+  return strtof(t, nullptr);
+}
+
+/** @brief Columnas del CSV que se usan */
+enum CsvCol { C_TS, C_DIST, C_VMAX, C_BPM, C_DCAR, C_DSPR, C_TRIMP, C_SPR, C_COUNT };
+
+static const char *CSV_NAMES[C_COUNT] = {
+  "Timestamp", "Dist_m", "Vel_Max_kmh", "BPM_Prom", "Dist_CAR_m", "Dist_SPR_m", "TRIMP", "Sprints_Min"
+};
+
+/**
+ * @brief Filas de un datos.csv (o de la salida CSV de bin2csv)
+ */
+static void parseCsv(const std::vector<char> &data, int32_t player, FileResult *out) {
+  const char *p = data.data();
+  const char *end = p + data.size();
+
+  // Encabezado: posición de cada columna por nombre
+  int idx[C_COUNT];
+  for (int c = 0; c < C_COUNT; c++) idx[c] = -1;
+  const char *eol = (const char *)memchr(p, '\n', end - p);
+  if (!eol) {
+    out->ok = false;
+    return;
+  }
+  int col = 0;
+  for (const char *f = p; f < eol; col++) {
+    const char *fe = f;
+    while (fe < eol && *fe != ',' && *fe != '\r') fe++;
+    for (int c = 0; c < C_COUNT; c++) {
+      if ((size_t)(fe - f) == strlen(CSV_NAMES[c]) && memcmp(f, CSV_NAMES[c], fe - f) == 0) idx[c] = col;
+    }
+    f = fe + 1;
+  }
+  for (int c = 0; c < C_COUNT; c++) {
+    if (idx[c] < 0) {
+      out->ok = false;
+      return;
+    }
+  }
+
+  // Filas
+  const char *field[32];
+  const char *fieldEnd[32];
+  for (p = eol + 1; p < end; p = eol + 1) {
+    eol = (const char *)memchr(p, '\n', end - p);
+    if (!eol) {
+      // Última fila sin salto de línea: escritura cortada (p. ej. sin energía)
+      out->bad++;
+      break;
+    }
+    int n = 0;
+    for (const char *f = p; f <= eol && n < 32; n++) {
+      const char *fe = f;
+      while (fe < eol && *fe != ',' && *fe != '\r') fe++;
+      field[n] = f;
+      fieldEnd[n] = fe;
+      f = fe + 1;
+      if (fe == eol || *fe == '\r') {
+        n++;
+        break;
+      }
+    }
+    if (n == 1 && field[0] == fieldEnd[0]) continue;   // Línea vacía
+    bool complete = true;
+    for (int c = 0; c < C_COUNT; c++) complete = complete && idx[c] < n;
+    if (!complete) {
+      out->bad++;
+      continue;
+    }
+    Row r;
+    if (!parseTimestamp(field[idx[C_TS]], fieldEnd[idx[C_TS]], &r.minute)) {
+      out->unaligned++;
+      continue;
+    }
+    r.player = player;
+#define FIELD(c) field[idx[c]], fieldEnd[idx[c]]
+    r.distM = fieldFloat(FIELD(C_DIST));
+    r.hsDistM = fieldFloat(FIELD(C_DCAR)) + fieldFloat(FIELD(C_DSPR));
+    r.vMaxKmh = fieldFloat(FIELD(C_VMAX));
+    r.bpm = fieldFloat(FIELD(C_BPM));
+    r.trimp = fieldFloat(FIELD(C_TRIMP));
+    r.sprints = (int)fieldFloat(FIELD(C_SPR));
+#undef FIELD
+    out->rows.push_back(r);
+  }
+}
+
+/**
+ * @brief Filas de un sesion.bin (los registros dañados se saltan como en bin2csv)
+ */
+static void parseBin(const std::vector<char> &raw, int32_t player, FileResult *out) {
+  const uint8_t *data = (const uint8_t *)raw.data();
+  size_t size = raw.size();
+  SessionLogHeader h;
+  if (size < sizeof(h)) {
+    out->ok = false;
+    return;
+  }
+  memcpy(&h, data, sizeof(h));
+  if (memcmp(h.magic, "WSLG", 4) != 0) {
+    out->other = true;
+    return;
+  }
+  if (h.version != SESSION_LOG_VERSION ||
+      h.crc != crc16Ccitt(&h, offsetof(SessionLogHeader, crc))) {
+    out->ok = false;
+    return;
+  }
+
+  size_t pos = h.headerSize;
+  while (pos + sizeof(RecordPrefix) <= size) {
+    RecordPrefix pre;
+    memcpy(&pre, data + pos, sizeof(pre));
+    if (pre.sync != SESSION_LOG_SYNC || pre.len < sizeof(RecordPrefix) + 2 || pos + pre.len > size ||
+        crc16Ccitt(data + pos, pre.len - 2) != (uint16_t)(data[pos + pre.len - 2] | data[pos + pre.len - 1] << 8)) {
+      out->bad++;
+      pos++;
+      while (pos < size && data[pos] != SESSION_LOG_SYNC) pos++;
+      continue;
+    }
+    if (pre.type == REC_MINUTE && pre.len == sizeof(MinuteRecord)) {
+      MinuteRecord m;
+      memcpy(&m, data + pos, sizeof(m));
+      if (m.utcDate == 0) {
+        out->unaligned++;
+      } else {
+        // Igual que el Timestamp del CSV: fecha UTC con la hora local
+        int32_t hour = ((int32_t)(m.utcTime / 10000) + h.utcOffsetH + 24) % 24;
+        Row r;
+        r.minute = daysFromCivil(m.utcDate / 10000, m.utcDate / 100 % 100, m.utcDate % 100) * 1440 +
+                   hour * 60 + (int32_t)(m.utcTime / 100 % 100);
+        r.player = player;
+        r.distM = m.distMinuteDm / 10.0f;
+        r.hsDistM = (float)(m.distVZ[2] + m.distVZ[3]);
+        r.vMaxKmh = m.vMax / 100.0f;
+        r.bpm = m.bpmMean / 10.0f;
+        r.trimp = m.trimp / 100.0f;
+        r.sprints = m.sprintsMin;
+        out->rows.push_back(r);
+      }
+    }
+    pos += pre.len;
+  }
+}
+
+/**
+ * @brief Busca sesiones bajo dir; el jugador es la subcarpeta de primer nivel
+ */
+static void scan(const std::string &dir, int32_t player, std::vector<std::string> *players,
+                 std::vector<Input> *inputs) {
+  DIR *d = opendir(dir.c_str());
+  if (!d) return;
+  std::vector<std::string> names;
+  while (dirent *e = readdir(d)) {
+    if (e->d_name[0] != '.') names.push_back(e->d_name);
+  }
+  closedir(d);
+  std::sort(names.begin(), names.end());
+
+  for (const std::string &name : names) {
+    std::string path = dir + "/" + name;
+    struct stat st;
+    if (stat(path.c_str(), &st) != 0) continue;
+    if (S_ISDIR(st.st_mode)) {
+      int32_t p = player;
+      if (p < 0) {
+        p = (int32_t)players->size();
+        players->push_back(name);
+      }
+      scan(path, p, players, inputs);
+      continue;
+    }
+    std::string lower = name;
+    for (char &c : lower) c = (char)tolower(c);
+    bool csv = lower.size() > 4 && lower.compare(lower.size() - 4, 4, ".csv") == 0;
+    bool bin = lower.size() > 4 && lower.compare(lower.size() - 4, 4, ".bin") == 0;
+    if (!csv && !bin) continue;
+    int32_t p = player;
+    if (p < 0) {
+      // Archivo suelto en la raíz: el jugador es el nombre sin extensión
+      p = (int32_t)players->size();
+      players->push_back(name.substr(0, name.size() - 4));
+    }
+    inputs->push_back(Input{path, p, bin});
+  }
+}
+
+// ==================== AGREGADOS ====================
+
+/** @brief Percentil por rango más cercano (ordena v) */
+static float percentile(std::vector<float> &v, int pct) {
+  if (v.empty()) return 0.0f;
+  size_t k = (v.size() * pct + 99) / 100;
+  if (k > 0) k--;
+  std::nth_element(v.begin(), v.begin() + k, v.end());
+  return v[k];
+}
+
+/**
+ * @struct PlayerStats
+ * @brief Totales y percentiles de un jugador
+ */
+struct PlayerStats {
+  int32_t minutes = 0;
+  int32_t days = 0;                      ///< Días distintos con datos (sesiones)
+  float distM = 0, hsDistM = 0, trimp = 0, vMaxKmh = 0;
+  int32_t sprints = 0;
+  float distP50 = 0, distP90 = 0, distMax = 0;
+  float trimpP50 = 0, trimpP90 = 0;
+  float bpmP50 = 0, bpmP90 = 0;
+};
+
+/**
+ * @struct MinuteLoad
+ * @brief Carga del equipo en un minuto
+ */
+struct MinuteLoad {
+  int32_t minute;
+  int32_t players;                       ///< Jugadores con datos en el minuto
+  float distM, hsDistM, trimp;
+  float bpmMean;                         ///< Promedio de los jugadores con latidos
+  int32_t sprints;
+};
+
+// ==================== ARCHIVO COLUMNAR ====================
+
+/**
+ * @struct ColHeader
+ * @brief Encabezado del archivo columnar
+ *
+ * Le sigue, por tabla: nombre (char[16]), filas (uint32), columnas (uint16)
+ * y, por columna, nombre (char[16]), tipo ('i' int32, 'f' float32, 's'
+ * char[16]) y los datos de todas las filas. Little-endian.
+ */
+struct __attribute__((packed)) ColHeader {
+  char magic[4];                         ///< "WSTC"
+  uint16_t version;                      ///< 1
+  uint16_t tables;
+};
+
+/**
+ * @struct Column
+ * @brief Columna en memoria
+ */
+struct Column {
+  std::string name;
+  char type;
+  std::vector<char> data;                ///< filas × (4 o 16) bytes
+};
+
+template <typename T>
+static Column column(const char *name, char type, const std::vector<T> &v) {
+  Column c;
+  c.name = name;
+  c.type = type;
+  c.data.resize(v.size() * sizeof(T));
+  if (!v.empty()) memcpy(c.data.data(), v.data(), c.data.size());
+  return c;
+}
+
+static void writeName(FILE *f, const std::string &s) {
+  char b[16] = {0};
+  memcpy(b, s.data(), std::min(s.size(), sizeof(b)));
+  fwrite(b, 1, sizeof(b), f);
+}
+
+static void writeTable(FILE *f, const char *name, uint32_t rows, const std::vector<Column> &cols) {
+  writeName(f, name);
+  uint16_t nc = (uint16_t)cols.size();
+  fwrite(&rows, sizeof(rows), 1, f);
+  fwrite(&nc, sizeof(nc), 1, f);
+  for (const Column &c : cols) {
+    writeName(f, c.name);
+    fwrite(&c.type, 1, 1, f);
+    fwrite(c.data.data(), 1, c.data.size(), f);
+  }
+}
+
+/**
+ * @brief Imprime una tabla (o todas) de un archivo columnar como CSV
+ */
+static int dump(const char *path, const char *only) {
+  std::vector<char> data;
+  if (!readAll(path, &data)) {
+    perror(path);
+    return 1;
+  }
+  ColHeader h;
+  if (data.size() < sizeof(h) || memcmp(data.data(), "WSTC", 4) != 0) {
+    fprintf(stderr, "%s: no es un archivo columnar\n", path);
+    return 1;
+  }
+  memcpy(&h, data.data(), sizeof(h));
+  size_t pos = sizeof(h);
+  for (int t = 0; t < h.tables; t++) {
+    if (pos + 22 > data.size()) break;
+    std::string name(data.data() + pos, strnlen(data.data() + pos, 16));
+    uint32_t rows;
+    uint16_t nc;
+    memcpy(&rows, &data[pos + 16], 4);
+    memcpy(&nc, &data[pos + 20], 2);
+    pos += 22;
+    std::vector<std::string> colNames;
+    std::vector<char> types;
+    std::vector<const char *> cols;
+    for (int c = 0; c < nc; c++) {
+      colNames.push_back(std::string(data.data() + pos, strnlen(data.data() + pos, 16)));
+      types.push_back(data[pos + 16]);
+      cols.push_back(data.data() + pos + 17);
+      pos += 17 + (size_t)rows * (types.back() == 's' ? 16 : 4);
+      if (pos > data.size()) {
+        fprintf(stderr, "%s: archivo truncado\n", path);
+        return 1;
+      }
+    }
+    if (only && name != only) continue;
+    if (!only) printf("# %s\n", name.c_str());
+    for (int c = 0; c < nc; c++) printf(c ? ",%s" : "%s", colNames[c].c_str());
+    printf("\n");
+    for (uint32_t r = 0; r < rows; r++) {
+      for (int c = 0; c < nc; c++) {
+        if (c) putchar(',');
+        if (types[c] == 's') {
+          printf("%.16s", cols[c] + (size_t)r * 16);
+        } else if (types[c] == 'f') {
+          float v;
+          memcpy(&v, cols[c] + (size_t)r * 4, 4);
+          printf("%.2f", v);
+        } else {
+          int32_t v;
+          memcpy(&v, cols[c] + (size_t)r * 4, 4);
+          printf("%d", v);
+        }
+      }
+      printf("\n");
+    }
+  }
+  return 0;
+}
+
+/** @brief Minuto como "AAAA-MM-DD HH:MM" */
+static std::string minuteText(int32_t minute) {
+  int32_t z = (minute >= 0 ? minute : minute - 1439) / 1440 + 719468;
+  int32_t era = (z >= 0 ? z : z - 146096) / 146097;
+  unsigned doe = (unsigned)(z - era * 146097);
+  unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+  int y = (int)yoe + era * 400;
+  unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+  unsigned mp = (5 * doy + 2) / 153;
+  unsigned d = doy - (153 * mp + 2) / 5 + 1;
+  unsigned m = mp < 10 ? mp + 3 : mp - 9;
+  int32_t mod = minute - (minute >= 0 ? minute : minute - 1439) / 1440 * 1440;
+  char b[48];
+  snprintf(b, sizeof(b), "%04d-%02u-%02u %02d:%02d", y + (m <= 2), m, d, mod / 60, mod % 60);
+  return b;
+}
+
+int main(int argc, char **argv) {
+  const char *root = nullptr;
+  const char *outPath = nullptr;
+  unsigned threads = std::thread::hardware_concurrency();
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--dump") == 0 && i + 1 < argc) {
+      return dump(argv[i + 1], i + 2 < argc ? argv[i + 2] : nullptr);
+    } else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+      outPath = argv[++i];
+    } else if (strcmp(argv[i], "-j") == 0 && i + 1 < argc) {
+      threads = (unsigned)atoi(argv[++i]);
+    } else {
+      root = argv[i];
+    }
+  }
+  if (!root) {
+    fprintf(stderr, "Uso: %s carpeta [-o equipo.col] [-j hilos]\n"
+                    "     %s --dump equipo.col [filas|jugadores|minutos]\n", argv[0], argv[0]);
+    return 1;
+  }
+  if (threads == 0) threads = 1;
+
+  std::vector<std::string> players;
+  std::vector<Input> inputs;
+  scan(root, -1, &players, &inputs);
+  if (inputs.empty()) {
+    fprintf(stderr, "%s: no hay archivos .csv ni .bin\n", root);
+    return 1;
+  }
+
+  // Lectura en paralelo: cada hilo toma el siguiente archivo libre
+  std::vector<FileResult> results(inputs.size());
+  std::atomic<size_t> next(0);
+  auto worker = [&]() {
+    std::vector<char> data;
+    for (size_t k; (k = next++) < inputs.size();) {
+      const Input &in = inputs[k];
+      if (!readAll(in.path, &data)) {
+        results[k].ok = false;
+        continue;
+      }
+      if (in.binary) parseBin(data, in.player, &results[k]);
+      else parseCsv(data, in.player, &results[k]);
+    }
+  };
+  if (threads > inputs.size()) threads = (unsigned)inputs.size();
+  std::vector<std::thread> pool;
+  for (unsigned t = 1; t < threads; t++) pool.emplace_back(worker);
+  worker();
+  for (std::thread &t : pool) t.join();
+
+  // Unión ordenada por minuto y jugador
+  std::vector<Row> rows;
+  unsigned long unaligned = 0, bad = 0, skipped = 0, other = 0;
+  size_t total = 0;
+  for (const FileResult &r : results) total += r.rows.size();
+  rows.reserve(total);
+  for (size_t k = 0; k < results.size(); k++) {
+    if (!results[k].ok) {
+      fprintf(stderr, "%s: formato no reconocido, se omite\n", inputs[k].path.c_str());
+      skipped++;
+      continue;
+    }
+    if (results[k].other) {
+      other++;
+      continue;
+    }
+    rows.insert(rows.end(), results[k].rows.begin(), results[k].rows.end());
+    unaligned += results[k].unaligned;
+    bad += results[k].bad;
+  }
+  std::sort(rows.begin(), rows.end(), [](const Row &a, const Row &b) {
+    return a.minute != b.minute ? a.minute < b.minute : a.player < b.player;
+  });
+
+  // Carga del equipo por minuto
+  std::vector<MinuteLoad> load;
+  for (size_t i = 0; i < rows.size();) {
+    MinuteLoad m = {rows[i].minute, 0, 0, 0, 0, 0, 0};
+    int bpmN = 0;
+    int32_t lastPlayer = -1;
+    for (; i < rows.size() && rows[i].minute == m.minute; i++) {
+      const Row &r = rows[i];
+      if (r.player != lastPlayer) m.players++;
+      lastPlayer = r.player;
+      m.distM += r.distM;
+      m.hsDistM += r.hsDistM;
+      m.trimp += r.trimp;
+      m.sprints += r.sprints;
+      if (r.bpm > 0) {
+        m.bpmMean += r.bpm;
+        bpmN++;
+      }
+    }
+    if (bpmN) m.bpmMean /= bpmN;
+    load.push_back(m);
+  }
+
+  // Totales y percentiles por jugador
+  std::vector<PlayerStats> ps(players.size());
+  {
+    std::vector<std::vector<float> > dist(players.size()), trimp(players.size()), bpm(players.size());
+    std::vector<int32_t> lastDay(players.size(), INT32_MIN);
+    for (const Row &r : rows) {
+      PlayerStats &s = ps[r.player];
+      s.minutes++;
+      s.distM += r.distM;
+      s.hsDistM += r.hsDistM;
+      s.trimp += r.trimp;
+      s.sprints += r.sprints;
+      s.vMaxKmh = std::max(s.vMaxKmh, r.vMaxKmh);
+      int32_t day = r.minute / 1440;
+      if (day != lastDay[r.player]) {
+        // Filas ordenadas por minuto: cada día nuevo aparece una vez
+        s.days++;
+        lastDay[r.player] = day;
+      }
+      dist[r.player].push_back(r.distM);
+      trimp[r.player].push_back(r.trimp);
+      if (r.bpm > 0) bpm[r.player].push_back(r.bpm);
+    }
+    for (size_t p = 0; p < players.size(); p++) {
+      PlayerStats &s = ps[p];
+      s.distP50 = percentile(dist[p], 50);
+      s.distP90 = percentile(dist[p], 90);
+      s.distMax = percentile(dist[p], 100);
+      s.trimpP50 = percentile(trimp[p], 50);
+      s.trimpP90 = percentile(trimp[p], 90);
+      s.bpmP50 = percentile(bpm[p], 50);
+      s.bpmP90 = percentile(bpm[p], 90);
+    }
+  }
+
+  // Resumen
+  PlayerStats team;
+  for (const PlayerStats &s : ps) {
+    team.minutes += s.minutes;
+    team.distM += s.distM;
+    team.hsDistM += s.hsDistM;
+    team.trimp += s.trimp;
+    team.sprints += s.sprints;
+  }
+  printf("Equipo: %zu jugadores, %zu archivos, %d minutos-jugador en %zu minutos\n",
+         players.size(), inputs.size() - skipped - other, team.minutes, load.size());
+  if (!load.empty()) {
+    printf("Desde %s hasta %s\n", minuteText(load.front().minute).c_str(),
+           minuteText(load.back().minute).c_str());
+  }
+  printf("Distancia: %.3f km  alta vel: %.3f km  TRIMP: %.1f  sprints: %d\n\n",
+         team.distM / 1000.0, team.hsDistM / 1000.0, team.trimp, team.sprints);
+  printf("%-16s %5s %6s %9s %9s %7s %5s %6s | dist/min p50 p90 max | TRIMP/min p50 p90 | BPM p50 p90\n",
+         "Jugador", "dias", "min", "dist_km", "alta_km", "TRIMP", "spr", "vmax");
+  for (size_t p = 0; p < players.size(); p++) {
+    const PlayerStats &s = ps[p];
+    printf("%-16.16s %5d %6d %9.3f %9.3f %7.1f %5d %6.1f | %5.0f %5.0f %5.0f | %5.2f %5.2f | %5.1f %5.1f\n",
+           players[p].c_str(), s.days, s.minutes, s.distM / 1000.0, s.hsDistM / 1000.0, s.trimp,
+           s.sprints, s.vMaxKmh, s.distP50, s.distP90, s.distMax, s.trimpP50, s.trimpP90,
+           s.bpmP50, s.bpmP90);
+  }
+  fprintf(stderr, "%zu filas alineadas, %lu sin hora GPS, %lu dañadas, %lu archivos omitidos (%u hilos)\n",
+          rows.size(), unaligned, bad, skipped, threads);
+
+  if (!outPath) return 0;
+
+  // Archivo columnar
+  FILE *f = fopen(outPath, "wb");
+  if (!f) {
+    perror(outPath);
+    return 1;
+  }
+  ColHeader h = {{'W', 'S', 'T', 'C'}, 1, 3};
+  fwrite(&h, sizeof(h), 1, f);
+  {
+    std::vector<int32_t> minute, player, sprints;
+    std::vector<float> distM, hsDistM, vMax, bpm, trimp;
+    for (const Row &r : rows) {
+      minute.push_back(r.minute);
+      player.push_back(r.player);
+      distM.push_back(r.distM);
+      hsDistM.push_back(r.hsDistM);
+      vMax.push_back(r.vMaxKmh);
+      bpm.push_back(r.bpm);
+      trimp.push_back(r.trimp);
+      sprints.push_back(r.sprints);
+    }
+    writeTable(f, "filas", (uint32_t)rows.size(),
+               {column("minuto", 'i', minute), column("jugador", 'i', player),
+                column("dist_m", 'f', distM), column("alta_m", 'f', hsDistM),
+                column("vmax_kmh", 'f', vMax), column("bpm", 'f', bpm),
+                column("trimp", 'f', trimp), column("sprints", 'i', sprints)});
+  }
+  {
+    std::vector<char> names(players.size() * 16, 0);
+    std::vector<int32_t> days, minutes, sprints;
+    std::vector<float> distM, hsDistM, trimp, vMax, d50, d90, dMax, t50, t90, b50, b90;
+    for (size_t p = 0; p < players.size(); p++) {
+      const PlayerStats &s = ps[p];
+      memcpy(&names[p * 16], players[p].data(), std::min<size_t>(players[p].size(), 16));
+      days.push_back(s.days);
+      minutes.push_back(s.minutes);
+      sprints.push_back(s.sprints);
+      distM.push_back(s.distM);
+      hsDistM.push_back(s.hsDistM);
+      trimp.push_back(s.trimp);
+      vMax.push_back(s.vMaxKmh);
+      d50.push_back(s.distP50);
+      d90.push_back(s.distP90);
+      dMax.push_back(s.distMax);
+      t50.push_back(s.trimpP50);
+      t90.push_back(s.trimpP90);
+      b50.push_back(s.bpmP50);
+      b90.push_back(s.bpmP90);
+    }
+    writeTable(f, "jugadores", (uint32_t)players.size(),
+               {column("nombre", 's', names), column("dias", 'i', days),
+                column("minutos", 'i', minutes), column("dist_m", 'f', distM),
+                column("alta_m", 'f', hsDistM), column("trimp", 'f', trimp),
+                column("sprints", 'i', sprints), column("vmax_kmh", 'f', vMax),
+                column("dist_p50", 'f', d50), column("dist_p90", 'f', d90),
+                column("dist_max", 'f', dMax), column("trimp_p50", 'f', t50),
+                column("trimp_p90", 'f', t90), column("bpm_p50", 'f', b50),
+                column("bpm_p90", 'f', b90)});
+  }
+  {
+    std::vector<int32_t> minute, nPlayers, sprints;
+    std::vector<float> distM, hsDistM, trimp, bpm;
+    for (const MinuteLoad &m : load) {
+      minute.push_back(m.minute);
+      nPlayers.push_back(m.players);
+      sprints.push_back(m.sprints);
+      distM.push_back(m.distM);
+      hsDistM.push_back(m.hsDistM);
+      trimp.push_back(m.trimp);
+      bpm.push_back(m.bpmMean);
+    }
+    writeTable(f, "minutos", (uint32_t)load.size(),
+               {column("minuto", 'i', minute), column("jugadores", 'i', nPlayers),
+                column("dist_m", 'f', distM), column("alta_m", 'f', hsDistM),
+                column("trimp", 'f', trimp), column("bpm_prom", 'f', bpm),
+                column("sprints", 'i', sprints)});
+  }
+  bool ok = fclose(f) == 0;
+  if (!ok) perror(outPath);
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,223 @@
+/**
+ * @file telem2txt.cpp
+ * @brief Decodifica la telemetría binaria del Serial (TELEM_BIN) y la muestra como texto
+ * @authors Juan Perez, Ana Gomez
+ * @date 2025
+ *
+ * @details Lee el flujo de telemetry.h (tramas COBS entre bytes 0x00),
+ * verifica el CRC de cada registro e imprime la misma vista que la salida
+ * de texto del firmware (TELEM_TEXT): estado cada segundo, resumen del
+ * minuto con ventanas deslizantes y diagnóstico, y una línea por sprint.
+ * Los mensajes de texto entre tramas (arranque, errores) se copian tal
+ * cual; las tramas dañadas se cuentan y se descartan.
+ *
+ * Compilación (desde la carpeta del proyecto):
+ *   g++ -O2 -std=gnu++11 -Iinclude tools/telem2txt.cpp -o telem2txt
+ *
+ * Uso:
+ *   ./telem2txt /dev/ttyACM0 [--utc -6]    (puerto ya configurado, p. ej. con stty)
+ *   .pio/build/native/program --ecg ... --nmea ... | ./telem2txt
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include "config.h"
+#include "gps_fix.h"
+#include "telemetry.h"
+
+static const char *VZ_NAMES = "CAM/TRO/CAR/SPR";
+
+static int wrapHour(int h) {
+  while (h < 0) h += 24;
+  while (h >= 24) h -= 24;
+  return h;
+}
+
+static void printState(const StateRecord &r, int utcOffsetH) {
+  if ((r.valid & GPS_LOCATION) != 0) {
+    printf("Lat: %.6f  Lon: %.6f\n", r.latE7 * 1e-7, r.lonE7 * 1e-7);
+  } else {
+    printf("Posición: buscando fix...\n");
+  }
+  if (r.utcDate != 0) {
+    unsigned long t = r.utcTimeMs;
+    unsigned h = t / 3600000, mi = t / 60000 % 60, s = t / 1000 % 60;
+    printf("UTC: %lu-%lu-%lu %u:%u:%u\n", (unsigned long)(r.utcDate / 10000),
+           (unsigned long)(r.utcDate / 100 % 100), (unsigned long)(r.utcDate % 100), h, mi, s);
+    printf("Local: %d:%u:%u\n", wrapHour((int)h + utcOffsetH), mi, s);
+  }
+  if ((r.valid & GPS_SATS) != 0) {
+    printf("Sats: %u  HDOP: ", r.sats);
+    if ((r.valid & GPS_HDOP) != 0) printf("%.2f\n", r.hdop / 100.0);
+    else printf("N/D\n");
+  }
+  if ((r.valid & GPS_ALTITUDE) != 0) printf("Altitud: %.2f m\n", r.altCm / 100.0);
+  if ((r.valid & GPS_SPEED) != 0) printf("Vel (km/h): %.2f\n", r.speed / 100.0);
+  else printf("Velocidad: N/D\n");
+  if (r.bpm > 0) printf("%d bpm\n", (r.bpm + 5) / 10);
+  else printf("... bpm\n");
+  printf("\n");
+}
+
+static void printMinute(const MinuteRecord &r) {
+  printf("\n===== RESUMEN (1 min) #%lu =====\n", (unsigned long)r.seq);
+  printf("Dist: %.1f m  (Total: %.3f km)\n", r.distMinuteDm / 10.0, r.distTotalDm / 10000.0);
+  printf("Vel prom: %.1f km/h  Vel pico: %.1f km/h\n", r.vMean / 100.0, r.vMax / 100.0);
+  printf("BPM prom: %.1f\n", r.bpmMean / 10.0);
+  printf("HRV RMSSD: %.1f ms  SDNN: %.1f ms  pNN50: %.1f %%\n",
+         r.rmssd / 10.0, r.sdnn / 10.0, r.pnn50 / 10.0);
+  printf("Zonas vel [s | m]: %s\n", VZ_NAMES);
+  for (int i = 0; i < 4; i++) printf("%us | %um\n", r.secVZ[i], r.distVZ[i]);
+  printf("Zonas FC [s]: Z1..Z6\n");
+  for (int i = 0; i < 6; i++) printf(i < 5 ? "%u " : "%u\n", r.secHZ[i]);
+  printf("TRIMP (min): %.2f\n", r.trimp / 100.0);
+  printf("Sprints(min/total): %u/%u\n", r.sprintsMin, r.sprintsTotal);
+}
+
+static void printMotion(const MotionRecord &m) {
+  printf("Pasos: %u  cadencia: %.1f ppm  impactos: %u  pico: %.2f g  FIFO desbordada: %u\n",
+         m.steps, m.cadence / 10.0, m.impacts, m.peakMg / 1000.0, m.fifoOverruns);
+}
+
+static void printRolling(const RollingRecord &r) {
+  printf("Ventanas 1/5/10 min [m | m alta vel | TRIMP]:\n");
+  for (int w = 0; w < 3; w++) {
+    printf("%u | %u | %.1f  (%u s)  FC [s]:", r.distM[w], r.hsDistM[w], r.trimp[w] / 100.0,
+           r.seconds[w]);
+    for (int i = 0; i < 6; i++) printf(" %u", r.secHZ[w][i]);
+    printf("\n");
+  }
+  printf("Pico 5 min: %u m  alta vel %u m  TRIMP %.1f  agudo:cronico %.2f\n",
+         r.peakDist5M, r.peakHsDist5M, r.peakTrimp5 / 100.0, r.acuteChronic / 1000.0);
+}
+
+static void printDiag(const DiagRecord &d) {
+  printf("Dist vel/pos: %.1f / %.1f m  correccion: %.1f m  tramos: %u  descartes: %u\n",
+         d.dopplerDm / 10.0, d.positionDm / 10.0, d.correctionDm / 10.0, d.segments, d.rejected);
+  if (d.sprintsDropped) printf("Sprints sin registrar (cola llena): %u\n", d.sprintsDropped);
+  printf("GPS RX: %lu B, perdidos %lu B, ocupacion max %u B\n", (unsigned long)d.gpsRxBytes,
+         (unsigned long)d.gpsRxOverruns, d.gpsRxMaxFill);
+  if (d.flags & DIAG_ECG_DMA) {
+    printf("ECG bloques/overruns: %lu/%lu\n", (unsigned long)d.ecgBlocks,
+           (unsigned long)d.ecgOverruns);
+  }
+  printf("SD: %lu B en %lu sectores, pendientes %lu B, descartados %lu B  "
+         "max escritura/sync: %lu/%lu us\n",
+         (unsigned long)d.sdBytes, (unsigned long)d.sdSectors, (unsigned long)d.sdPending,
+         (unsigned long)d.sdDropped, (unsigned long)d.sdWriteMaxUs, (unsigned long)d.sdFlushMaxUs);
+  if (d.flags & DIAG_CAPTURE) {
+    printf("Captura ECG: %lu sectores, descartados %lu, errores %lu  max escritura: %lu us%s\n",
+           (unsigned long)d.capSectors, (unsigned long)d.capDropped, (unsigned long)d.capErrors,
+           (unsigned long)d.capWriteMaxUs, (d.flags & DIAG_CAPTURE_ON) ? "" : " (detenida)");
+  }
+}
+
+static void printTask(const TaskRecord &t, bool first) {
+  if (first) printf("Tarea       ejec perd  jitter prom/max   ejec prom/max (us)\n");
+  printf("%-10.10s %lu %lu  %lu/%lu  %lu/%lu\n", t.name, (unsigned long)t.runs,
+         (unsigned long)t.missed, (unsigned long)t.jitterAvgUs, (unsigned long)t.jitterMaxUs,
+         (unsigned long)t.execAvgUs, (unsigned long)t.execMaxUs);
+}
+
+static void printSprint(const SprintRecord &r) {
+  printf("Sprint: %.2f s  %.1f m  pico %.1f km/h  %.1f m/s2\n",
+         r.durationMs / 1000.0, r.distDm / 10.0, r.vPeak / 100.0, r.aPeak / 100.0);
+}
+
+/** @brief Copia un registro de tamaño fijo si el tipo y la longitud coinciden */
+template <typename T>
+static bool as(const std::vector<uint8_t> &rec, uint8_t type, T *out) {
+  if (rec[1] != type || rec.size() != sizeof(T)) return false;
+  memcpy(out, rec.data(), sizeof(T));
+  return true;
+}
+
+/** @brief Texto entre tramas: imprimible, saltos de línea o UTF-8 */
+static bool isText(const std::vector<uint8_t> &chunk) {
+  for (uint8_t c : chunk) {
+    if (c < 0x20 && c != '\r' && c != '\n' && c != '\t') return false;
+  }
+  return true;
+}
+
+int main(int argc, char **argv) {
+  const char *path = nullptr;
+  int utcOffsetH = UTC_OFFSET_H;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--utc") == 0 && i + 1 < argc) {
+      utcOffsetH = atoi(argv[++i]);
+    } else if (argv[i][0] == '-') {
+      fprintf(stderr, "Uso: %s [puerto|archivo] [--utc HORAS]  (sin archivo lee stdin)\n", argv[0]);
+      return 1;
+    } else {
+      path = argv[i];
+    }
+  }
+
+  FILE *f = path ? fopen(path, "rb") : stdin;
+  if (!f) {
+    perror(path);
+    return 1;
+  }
+  setvbuf(stdout, nullptr, _IOLBF, 0);
+
+  unsigned long good = 0, bad = 0, unknown = 0;
+  bool taskHeader = true;
+  std::vector<uint8_t> chunk, rec;
+  int c;
+  while ((c = getc(f)) != EOF) {
+    if (c != 0) {
+      chunk.push_back((uint8_t)c);
+      continue;
+    }
+    if (chunk.empty()) continue;
+    rec.resize(chunk.size());
+    size_t n = cobsDecode(chunk.data(), chunk.size(), rec.data());
+    rec.resize(n);
+    if (n < sizeof(RecordPrefix) + 2 || rec[0] != SESSION_LOG_SYNC || rec[2] != n ||
+        crc16Ccitt(rec.data(), n - 2) != (uint16_t)(rec[n - 2] | rec[n - 1] << 8)) {
+      // No es una trama: texto del firmware o trama dañada
+      if (isText(chunk)) fwrite(chunk.data(), 1, chunk.size(), stdout);
+      else bad++;
+      chunk.clear();
+      continue;
+    }
+    chunk.clear();
+    good++;
+
+    StateRecord st;
+    MinuteRecord mi;
+    MotionRecord mo;
+    RollingRecord ro;
+    DiagRecord di;
+    TaskRecord ta;
+    SprintRecord sp;
+    if (as(rec, REC_STATE, &st)) {
+      printState(st, utcOffsetH);
+    } else if (as(rec, REC_MINUTE, &mi)) {
+      printMinute(mi);
+      taskHeader = true;
+    } else if (as(rec, REC_MOTION, &mo)) {
+      printMotion(mo);
+    } else if (as(rec, REC_ROLLING, &ro)) {
+      printRolling(ro);
+    } else if (as(rec, REC_DIAG, &di)) {
+      printDiag(di);
+    } else if (as(rec, REC_TASK, &ta)) {
+      printTask(ta, taskHeader);
+      taskHeader = false;
+    } else if (as(rec, REC_SPRINT, &sp)) {
+      printSprint(sp);
+    } else {
+      good--;
+      unknown++;
+    }
+  }
+  if (!chunk.empty() && isText(chunk)) fwrite(chunk.data(), 1, chunk.size(), stdout);
+  if (path) fclose(f);
+
+  fprintf(stderr, "%lu registros, %lu de tipo desconocido, %lu tramas dañadas\n", good, unknown, bad);
+  return 0;
+}